@@ -1,10 +1,14 @@
 #include "AnalogUtils.h"
 
-int AnalogUtils::readValue(int pin) {
+float AnalogUtils::readMilliVolts(int pin, int samples) {
 
   pinMode(pin, INPUT);
 
   analogReadResolution(12);
 
-  return analogRead(pin);
-}
\ No newline at end of file
+  uint32_t total = 0;
+  for (int i = 0; i < samples; i++) {
+    total += analogReadMilliVolts(pin);
+  }
+  return (float)total / samples;
+}
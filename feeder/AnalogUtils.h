@@ -5,7 +5,8 @@
 
 class AnalogUtils {
 public:
-  static int readValue(int pin);
+  // Average of back-to-back conversions, corrected with the ADC calibration burnt into eFuse.
+  static float readMilliVolts(int pin, int samples);
 };
 
 #endif
@@ -0,0 +1,12 @@
+#ifndef CHECKSUM_H
+#define CHECKSUM_H
+
+#include <Arduino.h>
+
+class Checksum {
+public:
+  // CRC-32 as used by zlib and Ethernet
+  static uint32_t crc32(const void* data, size_t length);
+};
+
+#endif
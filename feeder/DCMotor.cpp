@@ -1,45 +1,82 @@
 #include "DCMotor.h"
+#include "EnergyModel.h"
+#include "WakeProfiler.h"
+#include "Log.h"
+
+const LogModule LOG_MODULE = LogModule::Motor;
+
+// Above the audible range, and 8 bits of duty are plenty for a motor
+const uint32_t PWM_FREQUENCY = 20000;
+const uint8_t PWM_RESOLUTION = 8;
+const uint32_t PWM_FULL_DUTY = (1 << PWM_RESOLUTION) - 1;
+const uint16_t RAMP_STEP_MS = 10;
 
 DCMotor::DCMotor(int pinIn1, int pinIn2, int pinStby)
-  : pinIn1(pinIn1), pinIn2(pinIn2), pinStby(pinStby) {
-  Serial.println("DCMotor - Constructor initialized");
-}
+  : pinIn1(pinIn1), pinIn2(pinIn2), pinStby(pinStby), activeProfile(MOTOR_PROFILE_BULK), startedAt(0), stoppedAt(0), running(false) {}
 
 void DCMotor::begin() {
-  Serial.println("DCMotor - Initializing pins and enabling motor standby mode");
-  pinMode(pinIn1, OUTPUT);
-  pinMode(pinIn2, OUTPUT);
+  WakeProfiler::Scope profile(WakePhase::MotorCycle);
+  LOG_DEBUG("Initializing pins and enabling motor standby mode");
+  ledcAttach(pinIn1, PWM_FREQUENCY, PWM_RESOLUTION);
+  ledcAttach(pinIn2, PWM_FREQUENCY, PWM_RESOLUTION);
   pinMode(pinStby, OUTPUT);
 
   digitalWrite(pinStby, HIGH);
   delay(1000);
-  Serial.println("DCMotor - Initialization complete");
+  LOG_DEBUG("Initialization complete");
 }
 
 void DCMotor::end() {
-  Serial.println("DCMotor - Stopping motor and disabling standby");
+  LOG_DEBUG("Stopping motor and disabling standby");
+  ledcDetach(pinIn1);
+  ledcDetach(pinIn2);
   digitalWrite(pinIn1, LOW);
   digitalWrite(pinIn2, LOW);
   digitalWrite(pinStby, LOW);
-  Serial.println("DCMotor - Motor and standby disabled");
+  running = false;
+  LOG_DEBUG("Motor and standby disabled");
 }
 
-void DCMotor::startMotor(bool reverse) {
-  Serial.println("DCMotor - Starting motor (IN1: HIGH, IN2: LOW)");
-  if (reverse) {
-    digitalWrite(pinIn1, LOW);
-    digitalWrite(pinIn2, HIGH);
-    Serial.println("DCMotor - Motor started (reverse)");
-  } else {
-    digitalWrite(pinIn1, HIGH);
-    digitalWrite(pinIn2, LOW);
-    Serial.println("DCMotor - Motor started");
+void DCMotor::drive(int pin, uint8_t percent) {
+  ledcWrite(pin, percent >= 100 ? PWM_FULL_DUTY : PWM_FULL_DUTY * percent / 100);
+}
+
+void DCMotor::startMotor(bool reverse, const MotorProfile& profile) {
+  int activePin = reverse ? pinIn2 : pinIn1;
+  activeProfile = profile;
+  LOG_DEBUG("Starting motor, reverse %d, %u ms ramp to %u%%", reverse, profile.rampMs, profile.cruiseDuty);
+
+  drive(reverse ? pinIn1 : pinIn2, 0);
+  startedAt = millis();
+  running = true;
+  uint16_t steps = profile.rampMs / RAMP_STEP_MS;
+  for (uint16_t step = 1; step < steps; step++) {
+    drive(activePin, profile.cruiseDuty * step / steps);
+    delay(RAMP_STEP_MS);
   }
+  drive(activePin, profile.cruiseDuty);
+  LOG_DEBUG("Motor at cruise duty");
 }
 
 void DCMotor::stopMotor() {
-  Serial.println("DCMotor - Stopping motor (IN1: LOW, IN2: LOW)");
-  digitalWrite(pinIn1, LOW);
-  digitalWrite(pinIn2, LOW);
-  Serial.println("DCMotor - Motor stopped");
+  if (activeProfile.brake) {
+    drive(pinIn1, 100);
+    drive(pinIn2, 100);
+  } else {
+    drive(pinIn1, 0);
+    drive(pinIn2, 0);
+  }
+  if (running) {
+    stoppedAt = millis();
+    running = false;
+    EnergyModel::chargeMotor(fullSpeedMs());
+  }
+  LOG_DEBUG("Motor stopped, brake %d", activeProfile.brake);
+}
+
+uint32_t DCMotor::fullSpeedMs() const {
+  uint32_t runMs = (running ? millis() : stoppedAt) - startedAt;
+  // The linear ramp moves as much as half of it at cruise duty would
+  uint32_t rampLossMs = min(runMs, (uint32_t)activeProfile.rampMs / 2);
+  return (runMs - rampLossMs) * activeProfile.cruiseDuty / 100;
 }
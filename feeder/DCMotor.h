@@ -3,12 +3,35 @@
 
 #include <Arduino.h>
 
+// How the motor is driven for one run. Ramping the PWM duty up from standstill
+// keeps the start well below the stall current the motor draws when switched
+// on hard; braking shorts the windings on stop so the auger halts at once,
+// coasting lets it spin down on its own.
+struct MotorProfile {
+  uint16_t rampMs;     // from standstill to the cruise duty
+  uint8_t cruiseDuty;  // percent
+  bool brake;
+};
+
+// Long runs far from the target
+const MotorProfile MOTOR_PROFILE_BULK = { 150, 100, true };
+// Slow runs close to the target, stopped dead so nothing trickles in after the stop
+const MotorProfile MOTOR_PROFILE_TRICKLE = { 60, 50, true };
+// The short reverse jog after every pulse
+const MotorProfile MOTOR_PROFILE_RETRACT = { 60, 100, true };
+
 class DCMotor {
 
 private:
   int pinIn1;
   int pinIn2;
   int pinStby;
+  MotorProfile activeProfile;
+  unsigned long startedAt;
+  unsigned long stoppedAt;
+  bool running;
+
+  void drive(int pin, uint8_t percent);
 
 public:
   DCMotor(int pinIn1, int pinIn2, int pinStby);
@@ -17,9 +40,14 @@ public:
 
   void end();
 
-  void startMotor(bool reverse);
+  // Ramps up to the cruise duty of the profile; returns once the ramp is done.
+  void startMotor(bool reverse, const MotorProfile& profile = MOTOR_PROFILE_BULK);
 
+  // Brakes or coasts, as the profile of the run asks.
   void stopMotor();
+
+  // Length of a full-speed run that would move as much as the current or last run.
+  uint32_t fullSpeedMs() const;
 };
 
 #endif
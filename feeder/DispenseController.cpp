@@ -0,0 +1,77 @@
+#include "DispenseController.h"
+#include <cmath>
+
+const uint32_t DEFAULT_PULSE_MS = 300;  // used until the first pulse was measured
+const uint32_t MIN_PULSE_MS = 150;
+const uint32_t MAX_PULSE_MS = 4000;
+const float DEFAULT_SPREAD = 0.3;
+const float SPREAD_MARGIN = 2.5;         // overshoot cannot be undone, so aim short by this many spreads
+const float MIN_TARGET_FRACTION = 0.4;
+const float MAX_TARGET_FRACTION = 0.85;
+const float MIN_MEASURABLE_GRAMS = 2;    // smaller changes are within the load cell noise
+const float SMOOTHING = 0.3;
+const float MIN_RATE = 0.5;
+const float MAX_RATE = 100;
+const float TRICKLE_BELOW_SECONDS = 1;   // of full-speed run still missing
+const float MOTOR_BUDGET_FACTOR = 3;     // pulses at half speed, retracts and the noise of single pulses
+const uint32_t MOTOR_BUDGET_MARGIN_MS = 30000;
+const uint32_t MAX_MOTOR_BUDGET_MS = 300000;
+
+DispenseController::DispenseController(const DispenseCalibration& saved)
+  : calibration({ NAN, DEFAULT_SPREAD }), pulses(0), motorMs(0) {
+  if (saved.gramsPerSecond >= MIN_RATE && saved.gramsPerSecond <= MAX_RATE) {
+    calibration.gramsPerSecond = saved.gramsPerSecond;
+  }
+  if (saved.spread >= 0 && saved.spread <= 1) {
+    calibration.spread = saved.spread;
+  }
+}
+
+const MotorProfile& DispenseController::nextProfile(float remainingGrams) const {
+  if (!std::isnan(calibration.gramsPerSecond) && remainingGrams < calibration.gramsPerSecond * TRICKLE_BELOW_SECONDS) {
+    return MOTOR_PROFILE_TRICKLE;
+  }
+  return MOTOR_PROFILE_BULK;
+}
+
+uint32_t DispenseController::nextPulseMs(float remainingGrams, const MotorProfile& profile) const {
+  if (std::isnan(calibration.gramsPerSecond)) {
+    return DEFAULT_PULSE_MS;
+  }
+  // A slow pulse is stopped by the weight watched during it before it overshoots much, so it
+  // aims at the whole gap; a full-speed one aims short, as overshoot cannot be undone
+  float fraction = profile.cruiseDuty < 100
+                     ? 1
+                     : constrain(1 / (1 + SPREAD_MARGIN * calibration.spread), MIN_TARGET_FRACTION, MAX_TARGET_FRACTION);
+  float fullSpeedMs = max(0.0f, remainingGrams * fraction / calibration.gramsPerSecond * 1000);
+  float ms = fullSpeedMs * 100 / profile.cruiseDuty + profile.rampMs / 2;
+  return constrain((uint32_t)ms, MIN_PULSE_MS, MAX_PULSE_MS);
+}
+
+void DispenseController::update(uint32_t forwardMs, uint32_t totalMs, float deltaGrams) {
+  pulses++;
+  motorMs += totalMs;
+
+  // A pulse that moved nothing says more about a jam or an empty hopper than about the auger
+  if (deltaGrams < MIN_MEASURABLE_GRAMS || forwardMs == 0) {
+    return;
+  }
+
+  float measured = constrain(deltaGrams / (forwardMs / 1000.0f), MIN_RATE, MAX_RATE);
+  if (std::isnan(calibration.gramsPerSecond)) {
+    calibration.gramsPerSecond = measured;
+    return;
+  }
+
+  float error = fabs(measured - calibration.gramsPerSecond) / calibration.gramsPerSecond;
+  calibration.spread += SMOOTHING * (min(error, 1.0f) - calibration.spread);
+  calibration.gramsPerSecond += SMOOTHING * (measured - calibration.gramsPerSecond);
+}
+
+uint32_t DispenseController::motorBudgetMs(float grams) const {
+  if (std::isnan(calibration.gramsPerSecond)) {
+    return MAX_MOTOR_BUDGET_MS;
+  }
+  float ms = max(0.0f, grams) / calibration.gramsPerSecond * 1000 * MOTOR_BUDGET_FACTOR + MOTOR_BUDGET_MARGIN_MS;
+  return (uint32_t)min(ms, (float)MAX_MOTOR_BUDGET_MS);
+}
@@ -0,0 +1,53 @@
+#ifndef DISPENSE_CONTROLLER_H
+#define DISPENSE_CONTROLLER_H
+
+#include <Arduino.h>
+#include "DCMotor.h"
+
+// What the auger has been measured to do, kept in NVS between feedings
+struct DispenseCalibration {
+  float gramsPerSecond;  // food moved per second of forward run, NAN until measured
+  float spread;          // mean relative deviation of single pulses from gramsPerSecond
+};
+
+// Sizes auger pulses for one feeding. Learns grams per second of forward run from
+// the weight change after every pulse, so far from the target a single long pulse
+// covers most of the gap and near it pulses get short. The noisier the pulses have
+// been, the shorter of the target each pulse aims. The last few grams are fed
+// with the slow trickle profile, which overshoots less per pulse.
+class DispenseController {
+private:
+  DispenseCalibration calibration;
+  int pulses;
+  uint32_t motorMs;
+
+public:
+  explicit DispenseController(const DispenseCalibration& saved);
+
+  // Motor profile for the next pulse, given the grams still missing.
+  const MotorProfile& nextProfile(float remainingGrams) const;
+
+  // Forward run for the next pulse with that profile, ramp included.
+  uint32_t nextPulseMs(float remainingGrams, const MotorProfile& profile) const;
+
+  // Call after every pulse with its full-speed equivalent run (DCMotor::fullSpeedMs()),
+  // the motor time it took and the weight change it caused.
+  void update(uint32_t forwardMs, uint32_t totalMs, float deltaGrams);
+
+  // Most motor time a feeding of that many grams may take: a few times what the learned
+  // rate needs, and never more than a fixed ceiling. Bounds the feeding when the weight
+  // goes up and down without reaching the target, which the jam detector does not catch.
+  uint32_t motorBudgetMs(float grams) const;
+
+  const DispenseCalibration& current() const {
+    return calibration;
+  }
+  int iterations() const {
+    return pulses;
+  }
+  uint32_t motorTimeMs() const {
+    return motorMs;
+  }
+};
+
+#endif
@@ -0,0 +1,177 @@
+#include "EnergyModel.h"
+#include <cmath>
+#include "Checksum.h"
+#include "WakeProfiler.h"
+#include "Log.h"
+
+const LogModule LOG_MODULE = LogModule::Voltage;
+const uint32_t ENERGY_ACCOUNT_MAGIC = 0x4E524731;  // "NRG1"
+const size_t LOAD_COUNT = (size_t)EnergyLoad::Count;
+const size_t PHASE_COUNT = (size_t)WakePhase::Count;
+const float MS_PER_HOUR = 3600000.0;
+const float MS_PER_DAY = 86400000.0;
+const float AVERAGE_WINDOW_DAYS = 7;
+// Share of the gap to the voltage reading closed per wake. The count is trusted
+// over days, the voltage over weeks.
+const float VOLTAGE_WEIGHT = 0.05;
+const float DEEP_SLEEP_MA = 0.25;
+const float MOTOR_RUN_MA = 320;  // the loaded auger at full duty; PWM scales it down
+const char* const LOAD_NAMES[LOAD_COUNT] = { "CPU", "Radio", "Motor", "Sleep" };
+
+struct PhaseLoad {
+  EnergyLoad load;
+  float milliAmps;
+};
+
+// Average battery-side current of the board in every wake phase, boost converter
+// losses included. The radio ones are averages over the whole phase: the waits
+// between packets draw less than the peaks. The motor itself is charged by its
+// runs on top of the phase.
+const PhaseLoad PHASE_LOADS[PHASE_COUNT] = {
+  { EnergyLoad::Cpu, 28 },     // Boot
+  { EnergyLoad::Cpu, 28 },     // RtcRead
+  { EnergyLoad::Cpu, 28 },     // Nvs
+  { EnergyLoad::Radio, 122 },  // WiFiConnect
+  { EnergyLoad::Radio, 60 },   // NtpSync
+  { EnergyLoad::Cpu, 33 },     // WeightRead, the HX711 included
+  { EnergyLoad::Cpu, 28 },     // BatteryRead
+  { EnergyLoad::Motor, 35 },   // MotorCycle, with the driver and the HX711 powered
+  { EnergyLoad::Radio, 100 },  // TelegramSend
+  { EnergyLoad::Radio, 123 },  // Portal
+  { EnergyLoad::Cpu, 28 },     // SleepDelay
+  { EnergyLoad::Cpu, 28 },     // Other
+};
+
+// Checksummed, as RTC_NOINIT memory is random after a power loss
+struct EnergyAccount {
+  uint32_t magic;
+  float stateOfCharge;  // of the capacity, NAN until the voltage was read
+  uint64_t countedMs;   // awake and asleep since the pack was connected
+  float dailyMah;
+  float periodMah;  // since the last deep sleep, motor runs of wakes a reset cut short included
+  float loadMah[LOAD_COUNT];
+  uint32_t crc;
+};
+
+RTC_NOINIT_ATTR static EnergyAccount account;
+
+static bool isValid() {
+  return account.magic == ENERGY_ACCOUNT_MAGIC && account.crc == Checksum::crc32(&account, offsetof(EnergyAccount, crc));
+}
+
+static void save() {
+  account.crc = Checksum::crc32(&account, offsetof(EnergyAccount, crc));
+}
+
+static float countedDays() {
+  return account.countedMs / MS_PER_DAY;
+}
+
+static void charge(EnergyLoad load, float mAh) {
+  account.loadMah[(size_t)load] += mAh;
+  account.periodMah += mAh;
+  if (!std::isnan(account.stateOfCharge)) {
+    account.stateOfCharge = max(0.0f, account.stateOfCharge - mAh / BATTERY_CAPACITY_MAH);
+  }
+}
+
+static float countedMah() {
+  float total = 0;
+  for (float mAh : account.loadMah) {
+    total += mAh;
+  }
+  return total;
+}
+
+void EnergyModel::begin(float restingStateOfCharge) {
+  if (!isValid()) {
+    account = {};
+    account.magic = ENERGY_ACCOUNT_MAGIC;
+    account.stateOfCharge = NAN;
+    account.dailyMah = NAN;
+    LOG_INFO("New pack, counting the charge from zero");
+  }
+
+  if (!std::isnan(restingStateOfCharge)) {
+    if (std::isnan(account.stateOfCharge)) {
+      account.stateOfCharge = restingStateOfCharge;
+    } else {
+      account.stateOfCharge += VOLTAGE_WEIGHT * (restingStateOfCharge - account.stateOfCharge);
+    }
+  }
+  save();
+}
+
+void EnergyModel::chargeMotor(uint32_t fullSpeedMs) {
+  // Charged right away, as a motor start is what browns the board out
+  if (isValid()) {
+    charge(EnergyLoad::Motor, fullSpeedMs * MOTOR_RUN_MA / MS_PER_HOUR);
+    save();
+  }
+}
+
+void EnergyModel::endWake(uint64_t sleepUs) {
+  if (!isValid()) {
+    return;
+  }
+
+  uint32_t awakeMs = 0;
+  for (size_t phase = 0; phase < PHASE_COUNT; phase++) {
+    uint32_t ms = WakeProfiler::lastWakeMs((WakePhase)phase);
+    charge(PHASE_LOADS[phase].load, ms * PHASE_LOADS[phase].milliAmps / MS_PER_HOUR);
+    awakeMs += ms;
+  }
+  uint32_t sleepMs = sleepUs / 1000;
+  charge(EnergyLoad::Sleep, sleepMs * DEEP_SLEEP_MA / MS_PER_HOUR);
+  account.countedMs += awakeMs + sleepMs;
+
+  // The whole count until a week is in, then a moving average that follows firmware changes
+  if (std::isnan(account.dailyMah) || countedDays() < AVERAGE_WINDOW_DAYS) {
+    account.dailyMah = countedMah() / countedDays();
+  } else {
+    float periodDays = (awakeMs + sleepMs) / MS_PER_DAY;
+    account.dailyMah += (account.periodMah - account.dailyMah * periodDays) / AVERAGE_WINDOW_DAYS;
+  }
+  LOG_DEBUG("Wake and sleep: %.3f mAh, %.2f mAh/day on average", account.periodMah, account.dailyMah);
+  account.periodMah = 0;
+  save();
+}
+
+int EnergyModel::stateOfChargePercent() {
+  if (!isValid() || std::isnan(account.stateOfCharge)) {
+    return -1;
+  }
+  return lround(account.stateOfCharge * 100);
+}
+
+int EnergyModel::daysLeft() {
+  if (!isValid() || std::isnan(account.stateOfCharge) || countedDays() < 1 || !(account.dailyMah > 0)) {
+    return -1;
+  }
+  return lround(account.stateOfCharge * BATTERY_CAPACITY_MAH / account.dailyMah);
+}
+
+float EnergyModel::mahPerDay() {
+  return isValid() ? account.dailyMah : NAN;
+}
+
+float EnergyModel::usedMah() {
+  return isValid() ? countedMah() : 0;
+}
+
+String EnergyModel::summary() {
+  float days = isValid() ? countedDays() : 0;
+  float total = usedMah();
+  if (days <= 0 || total <= 0) {
+    return "Energy model: nothing counted yet.";
+  }
+
+  String text = "Energy model, " + String(days, 1) + " days counted: " + String(total, 1) + " mAh used, "
+                + String(mahPerDay(), 2) + " mAh/day recently, " + String(stateOfChargePercent()) + "% left, "
+                + String(daysLeft()) + " days to go:";
+  for (size_t load = 0; load < LOAD_COUNT; load++) {
+    text += "\n" + String(LOAD_NAMES[load]) + ": " + String(account.loadMah[load] / days, 2) + " mAh/day ("
+            + String((uint32_t)lround(account.loadMah[load] * 100 / total)) + "%)";
+  }
+  return text;
+}
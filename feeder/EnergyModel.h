@@ -0,0 +1,52 @@
+#ifndef ENERGY_MODEL_H
+#define ENERGY_MODEL_H
+
+#include <Arduino.h>
+
+// Capacity of the pack; the state of charge and the forecast scale with it.
+#ifndef BATTERY_CAPACITY_MAH
+#define BATTERY_CAPACITY_MAH 6000
+#endif
+
+// What the charge is spent on. Every wake phase is charged to one of them.
+enum class EnergyLoad : uint8_t {
+  Cpu,
+  Radio,
+  Motor,
+  Sleep,
+  Count
+};
+
+// Counts the charge drawn from the pack: the time of every wake phase and of
+// every deep sleep at the current the board draws in it. The count is blended
+// with the resting voltage, which alone is too flat and noisy to tell the
+// charge, and the average draw gives the runtime left. Kept over deep sleep
+// and resets; a power loss means a new pack and starts over.
+class EnergyModel {
+public:
+  // Call once per wake with the state of charge the resting voltage shows, NAN if it shows none.
+  static void begin(float restingStateOfCharge);
+
+  // Adds a motor run, as long as it would have been at full duty.
+  static void chargeMotor(uint32_t fullSpeedMs);
+
+  // Charges the wake closed by WakeProfiler::end() and the deep sleep about to start.
+  static void endWake(uint64_t sleepUs);
+
+  // Percent of the capacity left, -1 until the voltage was read once.
+  static int stateOfChargePercent();
+
+  // Days until the pack is empty at the recent average draw, -1 before a day was counted.
+  static int daysLeft();
+
+  // Average draw over the last week, or since the pack was connected if that is shorter.
+  static float mahPerDay();
+
+  // Charge counted since the pack was connected.
+  static float usedMah();
+
+  // Draw per load, one line each.
+  static String summary();
+};
+
+#endif
@@ -0,0 +1,162 @@
+#include "FeedingJournal.h"
+#include <esp_partition.h>
+#include "Checksum.h"
+#include "WakeProfiler.h"
+#include "Log.h"
+
+const LogModule LOG_MODULE = LogModule::Journal;
+const char* const JOURNAL_PARTITION_LABEL = "journal";
+const uint32_t JOURNAL_HEAD_MAGIC = 0x464A5231;  // "FJR1"
+const uint32_t ERASED_SEQUENCE = 0xFFFFFFFF;
+const size_t RECORD_SIZE = sizeof(FeedingRecord);
+const size_t CRC_LENGTH = offsetof(FeedingRecord, crc);
+
+static_assert(RECORD_SIZE == 32, "records must tile flash pages and sectors");
+
+// Where the next record goes
+struct JournalHead {
+  uint32_t magic;
+  uint32_t offset;
+  uint32_t sequence;
+  uint32_t lastSlotTime;
+};
+
+RTC_DATA_ATTR static JournalHead head = {};
+
+static const esp_partition_t* findPartition() {
+  static const esp_partition_t* partition = nullptr;
+  if (partition == nullptr) {
+    partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, JOURNAL_PARTITION_LABEL);
+  }
+  return partition;
+}
+
+static bool readRecord(const esp_partition_t* partition, uint32_t offset, FeedingRecord& record) {
+  return esp_partition_read(partition, offset, &record, RECORD_SIZE) == ESP_OK;
+}
+
+static bool isValid(const FeedingRecord& record) {
+  return record.sequence != ERASED_SEQUENCE && record.crc == Checksum::crc32(&record, CRC_LENGTH);
+}
+
+// Rebuilds the head after a power loss: the newest sector is the one whose first
+// record has the highest sequence, and its erased slots follow the used ones
+static bool locate(const esp_partition_t* partition) {
+  if (head.magic == JOURNAL_HEAD_MAGIC) {
+    return true;
+  }
+
+  LOG_DEBUG("Scanning the journal partition...");
+  uint32_t sectorSize = partition->erase_size;
+  uint32_t sectors = partition->size / sectorSize;
+  uint32_t newestSector = 0;
+  uint32_t newestSequence = 0;
+  FeedingRecord record;
+
+  for (uint32_t sector = 0; sector < sectors; sector++) {
+    if (!readRecord(partition, sector * sectorSize, record)) {
+      return false;
+    }
+    if (isValid(record) && record.sequence > newestSequence) {
+      newestSector = sector;
+      newestSequence = record.sequence;
+    }
+  }
+
+  head = {};
+  head.magic = JOURNAL_HEAD_MAGIC;
+  head.sequence = newestSequence + 1;
+  if (newestSequence == 0) {
+    LOG_INFO("Journal is empty.");
+    return true;
+  }
+
+  // First slot that was never written; a torn record counts as written
+  uint32_t low = 0;
+  uint32_t high = sectorSize / RECORD_SIZE;
+  while (low < high) {
+    uint32_t middle = (low + high) / 2;
+    if (!readRecord(partition, newestSector * sectorSize + middle * RECORD_SIZE, record)) {
+      head.magic = 0;
+      return false;
+    }
+    if (record.sequence == ERASED_SEQUENCE) {
+      high = middle;
+    } else {
+      low = middle + 1;
+    }
+  }
+  head.offset = (newestSector * sectorSize + low * RECORD_SIZE) % partition->size;
+  // Every slot takes the next sequence, even if its write failed
+  head.sequence = newestSequence + low;
+
+  // Skip records torn by a reset in the middle of a write
+  for (uint32_t slot = low; slot > 0; slot--) {
+    if (readRecord(partition, newestSector * sectorSize + (slot - 1) * RECORD_SIZE, record) && isValid(record)) {
+      head.lastSlotTime = record.slotTime;
+      break;
+    }
+  }
+
+  LOG_INFO("Next record %u at offset %u", head.sequence, head.offset);
+  return true;
+}
+
+bool FeedingJournal::append(FeedingRecord& record) {
+  WakeProfiler::Scope profile(WakePhase::Nvs);
+  const esp_partition_t* partition = findPartition();
+  if (partition == nullptr || !locate(partition)) {
+    LOG_ERROR("Journal partition not available.");
+    return false;
+  }
+
+  // Entering a sector drops the oldest records it held
+  if (head.offset % partition->erase_size == 0
+      && esp_partition_erase_range(partition, head.offset, partition->erase_size) != ESP_OK) {
+    LOG_ERROR("Failed to erase sector at %u", head.offset);
+    return false;
+  }
+
+  record.sequence = head.sequence;
+  memset(record.reserved, 0xFF, sizeof(record.reserved));
+  record.crc = Checksum::crc32(&record, CRC_LENGTH);
+
+  // Advance even if the write fails, so a bad slot is not reused
+  uint32_t offset = head.offset;
+  head.offset = (head.offset + RECORD_SIZE) % partition->size;
+  head.sequence++;
+
+  if (esp_partition_write(partition, offset, &record, RECORD_SIZE) != ESP_OK) {
+    LOG_ERROR("Failed to write record at %u", offset);
+    return false;
+  }
+
+  head.lastSlotTime = record.slotTime;
+  LOG_INFO("Record %u written at offset %u", record.sequence, offset);
+  return true;
+}
+
+bool FeedingJournal::read(uint32_t age, FeedingRecord& record) {
+  const esp_partition_t* partition = findPartition();
+  if (partition == nullptr || !locate(partition) || age + 1 >= head.sequence) {
+    return false;
+  }
+
+  uint32_t back = (age + 1) * RECORD_SIZE;
+  if (back > partition->size) {
+    return false;
+  }
+  uint32_t offset = (head.offset + partition->size - back) % partition->size;
+
+  // Records in the sector ahead of the head were erased when the log entered it
+  WakeProfiler::Scope profile(WakePhase::Nvs);
+  return readRecord(partition, offset, record) && isValid(record) && record.sequence == head.sequence - 1 - age;
+}
+
+time_t FeedingJournal::lastSlotTime() {
+  const esp_partition_t* partition = findPartition();
+  if (partition == nullptr || !locate(partition)) {
+    return 0;
+  }
+  return static_cast<time_t>(head.lastSlotTime);
+}
@@ -0,0 +1,53 @@
+#ifndef FEEDING_JOURNAL_H
+#define FEEDING_JOURNAL_H
+
+#include <Arduino.h>
+
+// How a scheduled feeding ended
+enum class FeedingResult : uint8_t {
+  Fed,
+  EnoughFood,
+  NoBowl,
+  WeightSensorError,
+  NoWeightChange,  // written before jams and an empty hopper were told apart
+  Jammed,
+  HopperEmpty,
+  Interrupted,  // given up after resets kept cutting the feeding short
+  MotorTimeLimit,  // the motor used up its time budget with the bowl still short of the target
+};
+
+// One scheduled feeding, as stored in the journal
+struct FeedingRecord {
+  uint32_t sequence;  // assigned by append(), 0xFFFFFFFF marks an erased slot
+  uint32_t slotTime;
+  uint32_t durationMs;
+  int16_t startWeight;  // food in the bowl, grams
+  int16_t endWeight;
+  uint16_t dispensedGrams;
+  uint16_t pulses;
+  uint16_t batteryMilliVolts;
+  FeedingResult result;
+  uint8_t unansweredPulses;  // pulses that moved less food than the learned rate predicts
+  uint8_t antiJamRuns;       // reverse runs to free the auger
+  uint8_t reserved[3];
+  uint32_t crc;
+};
+
+// Append-only log of feedings in the "journal" flash partition (partitions.csv).
+// Records are written one after another around the whole partition, erasing a
+// sector only when the log enters it, so every sector wears evenly and a
+// feeding costs one small write. The write position is kept in RTC memory and
+// found again by scanning the sector heads after a power loss.
+class FeedingJournal {
+public:
+  // Returns false if the partition is missing or the write failed
+  static bool append(FeedingRecord& record);
+
+  // age 0 is the newest record; false once age goes past the oldest one kept
+  static bool read(uint32_t age, FeedingRecord& record);
+
+  // Slot time of the newest record, 0 if the journal is empty or unavailable
+  static time_t lastSlotTime();
+};
+
+#endif
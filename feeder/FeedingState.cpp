@@ -0,0 +1,132 @@
+#include "FeedingState.h"
+#include "Checksum.h"
+#include "PreferencesHandler.h"
+#include "ScheduleHandler.h"
+#include "Log.h"
+
+const LogModule LOG_MODULE = LogModule::Main;
+const uint32_t FEEDING_STATE_MAGIC = 0x46534D32;  // "FSM2"
+const uint8_t MAX_RESUMES = 3;
+const time_t RESUME_WINDOW = SECONDS_IN_HOUR;  // an older slot is not dispensed any more
+
+// Two copies are written in turn, so a reset in the middle of a write leaves the other one intact
+struct FeedingStateCopy {
+  uint32_t magic;
+  uint32_t sequence;
+  FeedingProgress progress;
+  uint32_t crc;
+};
+
+// Not loaded again on a reset; random after a power loss, hence the checksum
+RTC_NOINIT_ATTR static FeedingStateCopy copies[2];
+
+static FeedingProgress progress;
+static uint32_t sequence = 0;
+static bool restored = false;
+
+static bool isValid(const FeedingStateCopy& copy) {
+  return copy.magic == FEEDING_STATE_MAGIC && copy.crc == Checksum::crc32(&copy, offsetof(FeedingStateCopy, crc));
+}
+
+static void save() {
+  sequence++;
+  FeedingStateCopy& copy = copies[sequence % 2];
+  copy.magic = FEEDING_STATE_MAGIC;
+  copy.sequence = sequence;
+  copy.progress = progress;
+  copy.crc = Checksum::crc32(&copy, offsetof(FeedingStateCopy, crc));
+}
+
+static bool isFeeding(FeedingStep step) {
+  return step != FeedingStep::Idle && step != FeedingStep::Sleeping;
+}
+
+void FeedingState::begin() {
+  const FeedingStateCopy* newest = nullptr;
+  for (const FeedingStateCopy& copy : copies) {
+    if (isValid(copy) && (newest == nullptr || (int32_t)(copy.sequence - newest->sequence) > 0)) {
+      newest = &copy;
+    }
+  }
+
+  restored = newest != nullptr;
+  if (!restored) {
+    progress = {};
+    sequence = 0;
+    return;
+  }
+
+  progress = newest->progress;
+  sequence = newest->sequence;
+  if (!isFeeding(progress.step)) {
+    progress.step = FeedingStep::Idle;
+    return;
+  }
+
+  progress.resets++;
+  LOG_WARN("Reset in feeding step %u of the slot at %t, %u resets so far", (uint8_t)progress.step, progress.checkpoint.slotTime,
+           progress.resets);
+  save();
+}
+
+bool FeedingState::resume(time_t now, time_t lastFeedingTime) {
+  if (!restored) {
+    // After a power loss only NVS knows whether dispensing was cut short
+    FeedingCheckpoint checkpoint = PreferencesHandler::getFeedingCheckpoint();
+    if (checkpoint.slotTime == 0 || (time_t)checkpoint.slotTime <= lastFeedingTime) {
+      return false;
+    }
+    LOG_WARN("Power lost while dispensing the slot at %t", checkpoint.slotTime);
+    progress = {};
+    progress.step = FeedingStep::Dispensing;
+    progress.resets = 1;
+    progress.checkpoint = checkpoint;
+    progress.record.slotTime = checkpoint.slotTime;
+    progress.record.startWeight = checkpoint.startWeight;
+    progress.record.endWeight = checkpoint.startWeight;
+    progress.record.result = FeedingResult::Fed;
+    restored = true;
+    save();
+  }
+
+  if (!isFeeding(progress.step)) {
+    return false;
+  }
+
+  bool dispensingLeft = progress.step == FeedingStep::Weighing || progress.step == FeedingStep::Dispensing;
+  if (progress.resets > MAX_RESUMES && !dispensingLeft) {
+    // The report stays queued for the next wake
+    LOG_ERROR("Giving up on the report after %u resets", progress.resets);
+    enter(FeedingStep::Sleeping);
+    return false;
+  }
+  if (dispensingLeft && (progress.resets > MAX_RESUMES || now - (time_t)progress.checkpoint.slotTime > RESUME_WINDOW)) {
+    LOG_ERROR("Giving up on dispensing after %u resets", progress.resets);
+    progress.record.result = FeedingResult::Interrupted;
+  }
+  return true;
+}
+
+void FeedingState::start(time_t slotTime, uint16_t portionGrams) {
+  progress = {};
+  progress.step = FeedingStep::Weighing;
+  progress.portionGrams = portionGrams;
+  progress.checkpoint.slotTime = static_cast<uint32_t>(slotTime);
+  progress.record.slotTime = static_cast<uint32_t>(slotTime);
+  progress.record.result = FeedingResult::Fed;
+  restored = true;
+  save();
+}
+
+FeedingProgress& FeedingState::current() {
+  return progress;
+}
+
+void FeedingState::enter(FeedingStep step) {
+  LOG_DEBUG("Feeding step %u -> %u", (uint8_t)progress.step, (uint8_t)step);
+  progress.step = step;
+  save();
+  if (step == FeedingStep::Dispensing) {
+    PreferencesHandler::saveFeedingCheckpoint(progress.checkpoint);
+  }
+}
@@ -0,0 +1,59 @@
+#ifndef FEEDING_STATE_H
+#define FEEDING_STATE_H
+
+#include <Arduino.h>
+#include "FeedingJournal.h"
+
+// Steps of a wake that feeds, in order. The feeding runs offline; Wi-Fi only
+// comes up for the report once the result is journaled.
+enum class FeedingStep : uint8_t {
+  Idle,
+  Weighing,    // reading what is in the bowl
+  Dispensing,  // running the auger up to the target weight
+  Connecting,  // journaled, bringing Wi-Fi up
+  Reporting,   // sending the queued report
+  Sleeping,    // done, on the way to deep sleep
+};
+
+// What dispensing needs to carry on; also saved to NVS when dispensing starts
+struct FeedingCheckpoint {
+  uint32_t slotTime;      // 0 if there is none
+  int16_t initialWeight;  // scale reading before the first pulse, bowl included
+  int16_t targetWeight;   // scale reading dispensing stops at
+  int16_t startWeight;    // food in the bowl before the first pulse
+};
+
+struct FeedingProgress {
+  FeedingStep step;
+  uint8_t resets;         // resets that cut this feeding short so far
+  uint16_t portionGrams;  // food the slot calls for, which weighing tops the bowl up to
+  FeedingCheckpoint checkpoint;
+  FeedingRecord record;  // filled in as the steps go, journaled when dispensing ends
+};
+
+// The feeding state machine. Its state is kept in RTC memory the bootloader does
+// not load again on a reset, so when a brownout (the motor starting on a sagging
+// cell) or a watchdog resets the chip, the next boot carries on with the step
+// that was cut short: the slot is neither fed twice nor skipped, the bowl is not
+// weighed again and the report queued so far is kept. A full power loss clears
+// RTC memory, so the checkpoint saved to NVS when dispensing starts covers it.
+class FeedingState {
+public:
+  // Call at the start of setup(). Counts a reset if the last boot stopped mid-feeding.
+  static void begin();
+
+  // True if a feeding was cut short and has to be carried on from current().step.
+  // Gives up on dispensing (result Interrupted) after repeated resets or when the slot is long past.
+  static bool resume(time_t now, time_t lastFeedingTime);
+
+  // Starts a feeding of the slot at Weighing.
+  static void start(time_t slotTime, uint16_t portionGrams);
+
+  // The feeding in progress. Changes are kept in RAM until the next enter().
+  static FeedingProgress& current();
+
+  // Moves to the step and persists the progress; entering Dispensing also saves the checkpoint to NVS.
+  static void enter(FeedingStep step);
+};
+
+#endif
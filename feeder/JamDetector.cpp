@@ -0,0 +1,73 @@
+#include "JamDetector.h"
+#include <cmath>
+#include "Log.h"
+
+const LogModule LOG_MODULE = LogModule::Motor;
+const float ANSWER_GRAMS = 2;          // smaller changes are within the load cell noise
+const float ANSWER_FRACTION = 0.25;    // of the expected grams, the dose of single pulses varies a lot
+const float SILENCE_GRAMS = 6;         // expected without an answer before the auger is suspected
+const uint8_t SILENT_PULSES = 2;
+const uint8_t ANTI_JAM_CYCLES = 3;
+const uint32_t ANTI_JAM_REVERSE_MS = 600;
+const uint32_t PROBE_PULSE_MS = 600;
+const float FULL_FLOW_RATIO = 0.5;     // a jam stops the auger at once, an emptying hopper tapers off
+
+JamDetector::JamDetector()
+  : expectedGrams(0), seenGrams(0), pendingPulses(0), antiJamCycle(0), lastFlowRatio(NAN),
+    detected(DispenseFault::None), unansweredPulses(0), antiJamCycles(0) {}
+
+void JamDetector::update(float expected, float deltaGrams) {
+  if (detected != DispenseFault::None) {
+    return;
+  }
+
+  if (expected >= ANSWER_GRAMS && deltaGrams >= ANSWER_GRAMS) {
+    lastFlowRatio = deltaGrams / expected;
+  }
+  expectedGrams += expected;
+  seenGrams += deltaGrams;
+  pendingPulses++;
+
+  bool rateKnown = !std::isnan(expectedGrams);
+  float needed = rateKnown ? max(ANSWER_GRAMS, ANSWER_FRACTION * expectedGrams) : ANSWER_GRAMS;
+  if (seenGrams >= needed) {
+    if (antiJamCycle > 0) {
+      LOG_INFO("Food is coming again after %u anti-jam cycles", antiJamCycle);
+    }
+    expectedGrams = 0;
+    seenGrams = 0;
+    pendingPulses = 0;
+    antiJamCycle = 0;
+    return;
+  }
+
+  if (unansweredPulses < UINT8_MAX) {
+    unansweredPulses++;
+  }
+  if (antiJamCycle > 0) {
+    if (antiJamCycle < ANTI_JAM_CYCLES) {
+      antiJamCycle++;
+      antiJamCycles++;
+      return;
+    }
+
+    detected = lastFlowRatio >= FULL_FLOW_RATIO ? DispenseFault::Jammed : DispenseFault::HopperEmpty;
+    LOG_WARN("No food after %u anti-jam cycles, fault %u (last flow at %.2f of the learned rate)", antiJamCycle,
+             (uint8_t)detected, lastFlowRatio);
+    return;
+  }
+
+  if (pendingPulses >= SILENT_PULSES && (!rateKnown || expectedGrams >= SILENCE_GRAMS)) {
+    LOG_WARN("No answer to %u pulses (%.1f g expected, %.1f g seen), reversing the auger", pendingPulses, expectedGrams, seenGrams);
+    antiJamCycle = 1;
+    antiJamCycles++;
+  }
+}
+
+uint32_t JamDetector::antiJamReverseMs() const {
+  return antiJamCycle > 0 && detected == DispenseFault::None ? ANTI_JAM_REVERSE_MS : 0;
+}
+
+uint32_t JamDetector::minPulseMs() const {
+  return antiJamCycle > 0 ? PROBE_PULSE_MS : 0;
+}
@@ -0,0 +1,54 @@
+#ifndef JAM_DETECTOR_H
+#define JAM_DETECTOR_H
+
+#include <Arduino.h>
+
+// Why food stopped coming out
+enum class DispenseFault : uint8_t {
+  None,
+  Jammed,       // the last pulse that moved food moved about what the learned rate predicts
+  HopperEmpty,  // the flow faded out before it stopped, or nothing came out at all
+};
+
+// Watches the weight trend of one feeding against what the learned dispense rate
+// says the pulses should have moved. Pulses are judged together since the last
+// one that answered, so short pulses near the target are not mistaken for a jam.
+// When food stops coming, the auger is run backwards before a few short probe
+// pulses; if none of them answers either, the feeding is aborted with a fault.
+class JamDetector {
+private:
+  float expectedGrams;  // by the pulses since the last answer; NAN while the rate is unknown
+  float seenGrams;
+  uint8_t pendingPulses;
+  uint8_t antiJamCycle;  // 0 while food is coming
+  float lastFlowRatio;   // seen / expected grams of the last pulse that measurably moved food, NAN if none
+  DispenseFault detected;
+  uint8_t unansweredPulses;
+  uint8_t antiJamCycles;
+
+public:
+  JamDetector();
+
+  // Call after every forward pulse with the grams the learned rate predicts for its forward
+  // time (NAN until a rate is known) and the weight change the load cell saw.
+  void update(float expected, float deltaGrams);
+
+  // Reverse run to do before the next forward pulse, 0 while food is coming
+  uint32_t antiJamReverseMs() const;
+
+  // Shortest forward run of the next pulse, long enough for an answer to be measurable
+  uint32_t minPulseMs() const;
+
+  DispenseFault fault() const {
+    return detected;
+  }
+  // Pulses that moved less than expected, and anti-jam reverse runs, over the whole feeding
+  uint8_t unanswered() const {
+    return unansweredPulses;
+  }
+  uint8_t antiJamRuns() const {
+    return antiJamCycles;
+  }
+};
+
+#endif
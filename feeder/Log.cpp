@@ -0,0 +1,176 @@
+#include "Log.h"
+#include <time.h>
+
+// The ring only ever holds addresses of this image's format strings: RTC memory
+// is reloaded from the image on every reset except a deep sleep wakeup, and so
+// after flashing a new firmware.
+const uint32_t LOG_MAGIC = 0x4C4F4731;  // "LOG1"
+const size_t LOG_CAPACITY = 64;
+const size_t LOG_LINE_LENGTH = 160;
+const char LEVEL_LETTERS[] = { 'D', 'I', 'W', 'E' };
+const char* const MODULE_NAMES[(size_t)LogModule::Count] = {
+  "Main", "ScheduleHandler", "PreferencesHandler", "RtcModule", "TimeHandler", "TelegramHandler",
+  "WiFiManagerWrapper", "WeightSensor", "DCMotor", "VoltageSensor", "FeedingJournal", "WakeupPlanner"
+};
+
+struct LogRecord {
+  const char* format;
+  uint32_t millis;
+  uint32_t args[Log::MAX_ARGS];
+  LogLevel level;
+  LogModule module;
+  uint8_t argCount;
+  uint8_t argTypes;  // two bits per argument
+};
+
+struct LogRing {
+  uint32_t magic;
+  uint32_t wakes;
+  uint32_t written;  // records ever written; the ring holds the last LOG_CAPACITY
+  uint32_t dumped;
+  LogRecord records[LOG_CAPACITY];
+};
+
+RTC_DATA_ATTR static LogRing ring = {};
+
+static bool isFlag(char c) {
+  return c == '-' || c == '+' || c == ' ' || c == '#' || c == '.' || (c >= '0' && c <= '9');
+}
+
+static bool isLengthModifier(char c) {
+  return c == 'h' || c == 'l' || c == 'L' || c == 'q' || c == 'j' || c == 'z';
+}
+
+// Formats one argument for a printf conversion; the argument's own type wins over the format.
+// %t is an extension printing a Unix time the way the Telegram messages do.
+static int formatArgument(char* out, size_t size, const char* flags, size_t flagsLength, char conversion, LogArg::Type type, uint32_t bits) {
+  if (conversion == 't' && type != LogArg::Type::Float) {
+    time_t time = bits;
+    struct tm utc;
+    gmtime_r(&time, &utc);
+    return snprintf(out, size, "%02d/%02d/%04d %02d:%02d:%02d", utc.tm_mon + 1, utc.tm_mday, utc.tm_year + 1900,
+                    utc.tm_hour, utc.tm_min, utc.tm_sec);
+  }
+
+  char spec[16];
+  if (flagsLength > sizeof(spec) - 5) {
+    flagsLength = sizeof(spec) - 5;
+  }
+  spec[0] = '%';
+  memcpy(spec + 1, flags, flagsLength);
+  char* tail = spec + 1 + flagsLength;
+
+  if (type == LogArg::Type::Float) {
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    bool floating = strchr("fFeEgG", conversion) != nullptr;
+    tail[0] = floating ? conversion : 'f';
+    tail[1] = '\0';
+    return snprintf(out, size, spec, (double)value);
+  }
+
+  long long value = type == LogArg::Type::Signed ? (long long)(int32_t)bits : (long long)bits;
+  bool unsignedConversion = strchr("uxXo", conversion) != nullptr;
+  tail[0] = 'l';
+  tail[1] = 'l';
+  tail[2] = unsignedConversion ? conversion : 'd';
+  tail[3] = '\0';
+  return unsignedConversion ? snprintf(out, size, spec, (unsigned long long)value) : snprintf(out, size, spec, value);
+}
+
+static void printRecord(Print& out, const LogRecord& record) {
+  char line[LOG_LINE_LENGTH];
+  size_t length = snprintf(line, sizeof(line), "%7lu %c %s - ", (unsigned long)record.millis,
+                           LEVEL_LETTERS[(size_t)record.level], MODULE_NAMES[(size_t)record.module]);
+  size_t nextArg = 0;
+
+  for (const char* c = record.format; *c != '\0' && length < sizeof(line) - 1; c++) {
+    if (*c != '%') {
+      line[length++] = *c;
+      continue;
+    }
+    if (c[1] == '%') {
+      line[length++] = '%';
+      c++;
+      continue;
+    }
+
+    const char* flags = c + 1;
+    const char* end = flags;
+    while (isFlag(*end)) {
+      end++;
+    }
+    size_t flagsLength = end - flags;
+    while (isLengthModifier(*end)) {
+      end++;
+    }
+    if (*end == '\0' || nextArg >= record.argCount) {
+      break;
+    }
+
+    LogArg::Type type = (LogArg::Type)((record.argTypes >> (2 * nextArg)) & 0x3);
+    int written = formatArgument(line + length, sizeof(line) - length, flags, flagsLength, *end, type, record.args[nextArg]);
+    if (written > 0) {
+      length = min(length + written, sizeof(line) - 1);
+    }
+    nextArg++;
+    c = end;
+  }
+
+  line[length] = '\0';
+  out.println(line);
+}
+
+void Log::begin() {
+  if (ring.magic != LOG_MAGIC) {
+    ring = {};
+    ring.magic = LOG_MAGIC;
+  }
+  ring.wakes++;
+  record(LogLevel::Info, LogModule::Main, "Wake %u", { ring.wakes });
+}
+
+void Log::record(LogLevel level, LogModule module, const char* format, std::initializer_list<LogArg> args) {
+  if (ring.magic != LOG_MAGIC) {
+    ring = {};
+    ring.magic = LOG_MAGIC;
+  }
+
+  LogRecord& entry = ring.records[ring.written % LOG_CAPACITY];
+  entry.format = format;
+  entry.millis = millis();
+  entry.level = level;
+  entry.module = module;
+  entry.argCount = 0;
+  entry.argTypes = 0;
+  for (const LogArg& arg : args) {
+    if (entry.argCount == MAX_ARGS) {
+      break;
+    }
+    entry.args[entry.argCount] = arg.bits;
+    entry.argTypes |= (uint8_t)arg.type << (2 * entry.argCount);
+    entry.argCount++;
+  }
+  ring.written++;
+
+  if (LOG_SERIAL_LEVEL != LogLevel::None && level >= LOG_SERIAL_LEVEL) {
+    printRecord(Serial, entry);
+  }
+}
+
+size_t Log::dump(Print& out) {
+  if (ring.magic != LOG_MAGIC) {
+    return 0;
+  }
+
+  if (ring.written - ring.dumped > LOG_CAPACITY) {
+    out.printf("... %lu log records overwritten\n", (unsigned long)(ring.written - ring.dumped - LOG_CAPACITY));
+    ring.dumped = ring.written - LOG_CAPACITY;
+  }
+
+  size_t count = 0;
+  for (; ring.dumped < ring.written; ring.dumped++, count++) {
+    printRecord(out, ring.records[ring.dumped % LOG_CAPACITY]);
+  }
+  return count;
+}
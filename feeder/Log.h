@@ -0,0 +1,152 @@
+#ifndef LOG_H
+#define LOG_H
+
+#include <Arduino.h>
+#include <initializer_list>
+#include <type_traits>
+
+enum class LogLevel : uint8_t {
+  Debug,
+  Info,
+  Warn,
+  Error,
+  None
+};
+
+// Who wrote a record; the names are printed when records are decoded
+enum class LogModule : uint8_t {
+  Main,
+  Schedule,
+  Preferences,
+  Rtc,
+  Time,
+  Telegram,
+  WiFi,
+  Weight,
+  Motor,
+  Voltage,
+  Journal,
+  Wakeup,
+  Count
+};
+
+// Records below LOG_LEVEL are compiled out. A module can be given its own level,
+// e.g. -DLOG_LEVEL_WEIGHT=LogLevel::Debug while tuning the load cell.
+#ifndef LOG_LEVEL
+#define LOG_LEVEL LogLevel::Info
+#endif
+
+// Records at or above this level are also printed to Serial as they happen,
+// which blocks on the UART. Off in production; decode the ring with Log::dump().
+#ifndef LOG_SERIAL_LEVEL
+#define LOG_SERIAL_LEVEL LogLevel::None
+#endif
+
+#ifndef LOG_LEVEL_MAIN
+#define LOG_LEVEL_MAIN LOG_LEVEL
+#endif
+#ifndef LOG_LEVEL_SCHEDULE
+#define LOG_LEVEL_SCHEDULE LOG_LEVEL
+#endif
+#ifndef LOG_LEVEL_PREFERENCES
+#define LOG_LEVEL_PREFERENCES LOG_LEVEL
+#endif
+#ifndef LOG_LEVEL_RTC
+#define LOG_LEVEL_RTC LOG_LEVEL
+#endif
+#ifndef LOG_LEVEL_TIME
+#define LOG_LEVEL_TIME LOG_LEVEL
+#endif
+#ifndef LOG_LEVEL_TELEGRAM
+#define LOG_LEVEL_TELEGRAM LOG_LEVEL
+#endif
+#ifndef LOG_LEVEL_WIFI
+#define LOG_LEVEL_WIFI LOG_LEVEL
+#endif
+#ifndef LOG_LEVEL_WEIGHT
+#define LOG_LEVEL_WEIGHT LOG_LEVEL
+#endif
+#ifndef LOG_LEVEL_MOTOR
+#define LOG_LEVEL_MOTOR LOG_LEVEL
+#endif
+#ifndef LOG_LEVEL_VOLTAGE
+#define LOG_LEVEL_VOLTAGE LOG_LEVEL
+#endif
+#ifndef LOG_LEVEL_JOURNAL
+#define LOG_LEVEL_JOURNAL LOG_LEVEL
+#endif
+#ifndef LOG_LEVEL_WAKEUP
+#define LOG_LEVEL_WAKEUP LOG_LEVEL
+#endif
+
+constexpr LogLevel LOG_MODULE_LEVELS[(size_t)LogModule::Count] = {
+  LOG_LEVEL_MAIN, LOG_LEVEL_SCHEDULE, LOG_LEVEL_PREFERENCES, LOG_LEVEL_RTC, LOG_LEVEL_TIME, LOG_LEVEL_TELEGRAM,
+  LOG_LEVEL_WIFI, LOG_LEVEL_WEIGHT, LOG_LEVEL_MOTOR, LOG_LEVEL_VOLTAGE, LOG_LEVEL_JOURNAL, LOG_LEVEL_WAKEUP
+};
+
+constexpr bool logEnabled(LogModule module, LogLevel level) {
+  return level != LogLevel::None && level >= LOG_MODULE_LEVELS[(size_t)module];
+}
+
+// A number stored in a record. Strings cannot be logged: the record outlives them.
+struct LogArg {
+  enum class Type : uint8_t {
+    Signed,
+    Unsigned,
+    Float
+  };
+
+  template <typename T, typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value, int>::type = 0>
+  LogArg(T value)
+    : type(Type::Signed), bits((uint32_t)(int32_t)value) {}
+
+  template <typename T, typename std::enable_if<std::is_integral<T>::value && !std::is_signed<T>::value, int>::type = 0>
+  LogArg(T value)
+    : type(Type::Unsigned), bits((uint32_t)value) {}
+
+  template <typename T, typename std::enable_if<std::is_floating_point<T>::value, int>::type = 0>
+  LogArg(T value)
+    : type(Type::Float) {
+    float single = value;
+    memcpy(&bits, &single, sizeof(bits));
+  }
+
+  Type type;
+  uint32_t bits;
+};
+
+// Compact log kept in a ring in RTC memory. A record is the address of its printf
+// format (a literal in flash, valid as long as the firmware image is), the time
+// since boot and up to MAX_ARGS numbers; it is only turned into text when the
+// ring is decoded, on the host or over Serial.
+class Log {
+public:
+  static const size_t MAX_ARGS = 3;
+
+  // Call first thing in setup(); marks the start of a wake in the ring.
+  static void begin();
+
+  static void record(LogLevel level, LogModule module, const char* format, std::initializer_list<LogArg> args);
+
+  // Prints the records not dumped yet, oldest first, and returns how many there were.
+  static size_t dump(Print& out);
+};
+
+// Each source file names its module once, e.g.
+//   const LogModule LOG_MODULE = LogModule::Weight;
+// and logs with printf formats and numbers only:
+//   LOG_INFO("Weight read: %.1f g", weight);
+// %t prints a Unix time as a date.
+#define LOG_AT(level, format, ...) \
+  do { \
+    if (logEnabled(LOG_MODULE, level)) { \
+      Log::record(level, LOG_MODULE, format, { __VA_ARGS__ }); \
+    } \
+  } while (0)
+
+#define LOG_DEBUG(format, ...) LOG_AT(LogLevel::Debug, format, ##__VA_ARGS__)
+#define LOG_INFO(format, ...) LOG_AT(LogLevel::Info, format, ##__VA_ARGS__)
+#define LOG_WARN(format, ...) LOG_AT(LogLevel::Warn, format, ##__VA_ARGS__)
+#define LOG_ERROR(format, ...) LOG_AT(LogLevel::Error, format, ##__VA_ARGS__)
+
+#endif
@@ -0,0 +1,201 @@
+#include "Messages.h"
+
+const size_t MESSAGE_COUNT = (size_t)Message::Count;
+const size_t LOCALE_COUNT = (size_t)Locale::Count;
+
+// Room for the arguments of the longest message: a schedule and two numbers with units
+const size_t MESSAGE_ARGUMENTS_BUDGET = 128;
+
+// Indexed by Locale, then by Message; kept in flash, nothing is copied at boot
+constexpr const char* CATALOGUE[LOCALE_COUNT][MESSAGE_COUNT] = {
+  {
+    "Устройство готово к использованию.",
+    "Текущие настройки.\nРасписание кормления (UTC таймзона): {}\nВес порции (гр): {}\nВес миски (гр): {}",
+    "Возникла ошибка при чтении времени из модуля часов. Просто игнорируйте это сообщение при первом запуске устройства. При повторном появлении - замените батарейку.",
+    "Возникла ошибка при синхронизации времени. Текущее время (UTC) - {}",
+    "Возникла ошибка при получении времени из модуля часов - проверьте подключение. Текущее время (UTC) - {}",
+    "Настало время кормления.",
+    "Кормление {}:",
+    "Заряд батареи - {} ({})",
+    "Заряд батареи - unknown ({})",
+    "Заряд батареи - {} ({}), хватит примерно на {} дн.",
+    "Заряд батареи снова выше {} - отчёт после каждого кормления.",
+    "Заряд батареи ниже {} - для экономии отчёт раз в сутки.",
+    "Заряд батареи ниже {} - отчёт раз в сутки, без синхронизации времени.",
+    "Заряд батареи ниже {} - кормление продолжится без Wi-Fi. Это последний отчёт до замены батареи.",
+    "Возникла ошибка при получении значения текущего веса (проверьте подключение) - кормление пропущено.",
+    "Возникла ошибка при получении значения текущего веса (проверьте подключение) - кормление остановлено.",
+    "Заблокирован шнек, реверс мотора не помог. Кормление остановлено.",
+    "Закончился корм. Кормление остановлено.",
+    "Мотор отработал отведённое время, но нужный вес не набран. Кормление остановлено.",
+    "Кормление продолжено после перезагрузки устройства.",
+    "Устройство несколько раз перезагрузилось во время кормления - кормление остановлено. Проверьте батарею.",
+    "Кормление успешно завершено.",
+    "Еды достаточно - кормление пропущено.",
+    "Отсутствует миска - кормление пропущено.",
+    "Кормление запущено - необходимо добавить {}",
+    "Вес еды в миске: {}",
+    "Итераций подачи: {}, работа мотора: {}, перебор: {}",
+    "Токен телеграм бота не задан или не валиден. Выполните конфигурацию заново.",
+    "Group ID телеграм бота не задан или не валиден. Выполните конфигурацию заново.",
+    "Расписание кормления не задано или не валидно. Выполните конфигурацию заново.",
+    "Вес порции не задан или не валиден. Выполните конфигурацию заново.",
+    "Вес миски не задан или не валиден. Выполните конфигурацию заново.",
+  },
+  {
+    "The feeder is ready to use.",
+    "Current settings.\nFeeding schedule (UTC): {}\nPortion weight (g): {}\nBowl weight (g): {}",
+    "Failed to read the time from the clock module. Ignore this message on the first start of the device. If it appears again, replace the clock battery.",
+    "Failed to synchronize the time. Current time (UTC) - {}",
+    "Failed to read the time from the clock module - check the wiring. Current time (UTC) - {}",
+    "Feeding time.",
+    "Feeding of {}:",
+    "Battery level - {} ({})",
+    "Battery level - unknown ({})",
+    "Battery level - {} ({}), about {} days left",
+    "Battery back above {} - reporting after every feeding.",
+    "Battery below {} - reporting once a day to save power.",
+    "Battery below {} - reporting once a day, without time sync.",
+    "Battery below {} - feeding continues without Wi-Fi. This is the last report until the battery is replaced.",
+    "Failed to read the weight (check the wiring) - feeding skipped.",
+    "Failed to read the weight (check the wiring) - feeding stopped.",
+    "The auger is jammed and reversing the motor did not free it. Feeding stopped.",
+    "Out of food. Feeding stopped.",
+    "The motor ran for its whole time budget without filling the bowl to the portion. Feeding stopped.",
+    "Feeding resumed after the feeder restarted.",
+    "The feeder restarted several times during the feeding - feeding stopped. Check the battery.",
+    "Feeding completed.",
+    "There is enough food - feeding skipped.",
+    "No bowl - feeding skipped.",
+    "Feeding started - adding {}",
+    "Food in the bowl: {}",
+    "Dispensing pulses: {}, motor time: {}, overshoot: {}",
+    "The Telegram bot token is missing or invalid. Please configure the feeder again.",
+    "The Telegram group ID is missing or invalid. Please configure the feeder again.",
+    "The feeding schedule is missing or invalid. Please configure the feeder again.",
+    "The portion weight is missing or invalid. Please configure the feeder again.",
+    "The bowl weight is missing or invalid. Please configure the feeder again.",
+  },
+};
+
+// Units appended to numbers, by Locale
+constexpr const char* UNIT_GRAMS[LOCALE_COUNT] = { "гр", "g" };
+constexpr const char* UNIT_SECONDS[LOCALE_COUNT] = { "с", "s" };
+
+constexpr size_t textLength(const char* text) {
+  return *text == '\0' ? 0 : 1 + textLength(text + 1);
+}
+
+constexpr bool catalogueComplete(size_t index = 0) {
+  return index == LOCALE_COUNT * MESSAGE_COUNT
+         || (CATALOGUE[index / MESSAGE_COUNT][index % MESSAGE_COUNT] != nullptr && catalogueComplete(index + 1));
+}
+
+constexpr size_t larger(size_t a, size_t b) {
+  return a > b ? a : b;
+}
+
+constexpr size_t longestMessage(size_t index = 0) {
+  return index == LOCALE_COUNT * MESSAGE_COUNT
+           ? 0
+           : larger(textLength(CATALOGUE[index / MESSAGE_COUNT][index % MESSAGE_COUNT]), longestMessage(index + 1));
+}
+
+static_assert(catalogueComplete(), "every message needs a text in every locale");
+static_assert(longestMessage() + MESSAGE_ARGUMENTS_BUDGET < MESSAGE_BUFFER_SIZE, "MESSAGE_BUFFER_SIZE is too small for the catalogue");
+
+// Appends to a fixed buffer, cutting at a UTF-8 character boundary when it is full
+class MessageWriter {
+public:
+  MessageWriter(char* buffer, size_t size)
+    : buffer(buffer), size(size), length(0) {}
+
+  void append(const char* text, size_t count) {
+    size_t room = size - 1 - length;
+    if (count > room) {
+      count = room;
+      while (count > 0 && (static_cast<uint8_t>(text[count]) & 0xC0) == 0x80) {
+        count--;
+      }
+    }
+    memcpy(buffer + length, text, count);
+    length += count;
+    buffer[length] = '\0';
+  }
+
+  void append(const char* text) {
+    append(text, strlen(text));
+  }
+
+  size_t written() const {
+    return length;
+  }
+
+private:
+  char* buffer;
+  size_t size;
+  size_t length;
+};
+
+static void appendArgument(MessageWriter& writer, const MessageArg& arg, size_t locale) {
+  char number[64];
+  switch (arg.type) {
+    case MessageArg::Type::Text:
+      writer.append(arg.textValue != nullptr ? arg.textValue : "");
+      return;
+    case MessageArg::Type::Number:
+      snprintf(number, sizeof(number), "%ld", (long)arg.value);
+      break;
+    case MessageArg::Type::Grams:
+      snprintf(number, sizeof(number), "%ld %s", (long)arg.value, UNIT_GRAMS[locale]);
+      break;
+    case MessageArg::Type::Percent:
+      snprintf(number, sizeof(number), "%ld%%", (long)arg.value);
+      break;
+    case MessageArg::Type::Seconds: {
+      unsigned long tenths = ((uint32_t)arg.value + 50) / 100;
+      snprintf(number, sizeof(number), "%lu.%lu %s", tenths / 10, tenths % 10, UNIT_SECONDS[locale]);
+      break;
+    }
+    case MessageArg::Type::Volts: {
+      unsigned long hundredths = ((uint32_t)arg.value + 5) / 10;
+      snprintf(number, sizeof(number), "%lu.%02lu V", hundredths / 100, hundredths % 100);
+      break;
+    }
+    case MessageArg::Type::Time: {
+      time_t time = (uint32_t)arg.value;
+      struct tm utc;
+      gmtime_r(&time, &utc);
+      snprintf(number, sizeof(number), "%02d/%02d/%04d %02d:%02d:%02d", utc.tm_mon + 1, utc.tm_mday, utc.tm_year + 1900,
+               utc.tm_hour, utc.tm_min, utc.tm_sec);
+      break;
+    }
+  }
+  writer.append(number);
+}
+
+size_t MessageFormatter::format(char* buffer, size_t size, Message message, std::initializer_list<MessageArg> args) {
+  if (size == 0) {
+    return 0;
+  }
+  buffer[0] = '\0';
+  if (message >= Message::Count) {
+    return 0;
+  }
+
+  size_t locale = (size_t)(MESSAGE_LOCALE);
+  const char* text = CATALOGUE[locale][(size_t)message];
+  const MessageArg* nextArg = args.begin();
+  MessageWriter writer(buffer, size);
+
+  // Missing arguments leave their placeholder empty, extra ones are ignored
+  while (const char* placeholder = strstr(text, "{}")) {
+    writer.append(text, placeholder - text);
+    if (nextArg != args.end()) {
+      appendArgument(writer, *nextArg++, locale);
+    }
+    text = placeholder + 2;
+  }
+  writer.append(text);
+  return writer.written();
+}
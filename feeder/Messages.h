@@ -2,32 +2,112 @@
 #define MESSAGES_H
 
 #include <Arduino.h>
+#include <initializer_list>
 
-const String MESSAGE_READY_TO_USE = "Устройство готово к использованию.";
-const String MESSAGE_RTC_MODULE_ERROR = "Возникла ошибка при чтении времени из модуля часов. Просто игнорируйте это сообщение при первом запуске устройства. При повторном появлении - замените батарейку.";
-const String MESSAGE_TIME_SYNC_ERROR = "Возникла ошибка при синхронизации времени. Текущее время (UTC) - ";
-const String MESSAGE_TIME_RETRIEVING_ERROR = "Возникла ошибка при получении времени из модуля часов - проверьте подключение. Текущее время (UTC) - ";
-const String MESSAGE_TIME_TO_FEED = "Настало время кормления.";
-const String MESSAGE_BATTERY_PERCENTAGE = "Заряд батареи";
-const String MESSAGE_UNKNOWN = "unknown";
-const String MESSAGE_END_SEPARATOR = "\n----------------------------------\n";
-const String MESSAGE_WEIGHT_ERROR = "Возникла ошибка при получении значения текущего веса (проверьте подключение) - ";
-const String MESSAGE_FEEDING_MISSED = "кормление пропущено.";
-const String MESSAGE_FEEDING_STOPPED = "кормление остановлено.";
-const String MESSAGE_FEEDING_NO_WEIGHT_CHANGE = "Закончился корм, либо заблокирован мотор. Кормление остановлено.";
-const String MESSAGE_FEEDING_SUCCESS = "Кормление успешно завершено.";
-const String MESSAGE_FEEDING_ENOUGH_FOOD = "Еды достаточно - " + MESSAGE_FEEDING_MISSED;
-const String MESSAGE_FEEDING_START = "Кормление запущено - необходимо добавить ";
-const String MESSAGE_GRAMM = "гр";
-const String MESSAGE_NO_BOWL = "Отсутствует миска - " + MESSAGE_FEEDING_MISSED;
-const String MESSAGE_SETTINGS_INVALID_BOT_TOKEN = "Токен телеграм бота не задан или не валиден. Выполните конфигурацию заново.";
-const String MESSAGE_SETTINGS_INVALID_BOT_GROUP_ID = "Group ID телеграм бота не задан или не валиден. Выполните конфигурацию заново.";
-const String MESSAGE_SETTINGS_INVALID_SCHEDULING = "Расписание кормления не задано или не валидно. Выполните конфигурацию заново.";
-const String MESSAGE_SETTINGS_INVALID_PORTION_WEIGHT = "Вес порции не задан или не валиден. Выполните конфигурацию заново.";
-const String MESSAGE_SETTINGS_INVALID_BOWL_WEIGHT = "Вес миски не задан или не валиден. Выполните конфигурацию заново.";
-const String MESSAGE_CURRENT_SETTINGS = "Текущие настройки.";
-const String MESSAGE_CURRENT_SETTINGS_SCHEDULING = "Расписание кормления (UTC таймзона): ";
-const String MESSAGE_CURRENT_SETTINGS_PORTION_WEIGHT = "Вес порции (гр): ";
-const String MESSAGE_CURRENT_SETTINGS_BOWL_WEIGHT = "Вес миски (гр): ";
+// Languages of the message catalogue (Messages.cpp)
+enum class Locale : uint8_t {
+  Ru,
+  En,
+  Count
+};
+
+// Set to Locale::En to build the firmware with English messages.
+#ifndef MESSAGE_LOCALE
+#define MESSAGE_LOCALE Locale::Ru
+#endif
+
+// Every message the feeder sends. "{}" in a message is filled with the next argument.
+enum class Message : uint8_t {
+  ReadyToUse,
+  CurrentSettings,  // schedule (text), portion (number), bowl (number)
+  RtcModuleError,
+  TimeSyncError,        // RTC time (time)
+  TimeRetrievingError,  // system time (time)
+  TimeToFeed,
+  FeedingAt,  // slot (time)
+  BatteryLevel,  // percent, volts
+  BatteryLevelUnknown,  // volts
+  BatteryForecast,      // percent, volts, days left (number)
+  PowerNormal,    // threshold (percent)
+  PowerSaving,    // threshold (percent)
+  PowerLow,       // threshold (percent)
+  PowerCritical,  // threshold (percent)
+  WeightErrorFeedingMissed,
+  WeightErrorFeedingStopped,
+  FeedingJammed,
+  FeedingHopperEmpty,
+  FeedingMotorTimeLimit,
+  FeedingResumed,
+  FeedingInterrupted,
+  FeedingSuccess,
+  FeedingEnoughFood,
+  FeedingNoBowl,
+  FeedingStart,  // grams
+  FoodInBowl,    // grams
+  FeedingStats,  // pulses (number), motor time (seconds), overshoot (grams)
+  SettingsInvalidBotToken,
+  SettingsInvalidGroupId,
+  SettingsInvalidScheduling,
+  SettingsInvalidPortionWeight,
+  SettingsInvalidBowlWeight,
+  Count
+};
+
+// Set between the report lines of different wakes
+const char* const MESSAGE_END_SEPARATOR = "\n----------------------------------\n";
+
+// Longest formatted message, arguments included. Checked against the catalogue at compile time.
+const size_t MESSAGE_BUFFER_SIZE = 448;
+
+// A typed value for a placeholder; numbers are printed with the unit of the locale
+class MessageArg {
+public:
+  enum class Type : uint8_t {
+    Text,
+    Number,
+    Grams,
+    Percent,
+    Seconds,  // from milliseconds, one decimal
+    Volts,    // from millivolts, two decimals
+    Time,     // UTC date and time
+  };
+
+  static MessageArg text(const char* value) {
+    return MessageArg(Type::Text, 0, value);
+  }
+  static MessageArg number(int32_t value) {
+    return MessageArg(Type::Number, value, nullptr);
+  }
+  static MessageArg grams(int32_t value) {
+    return MessageArg(Type::Grams, value, nullptr);
+  }
+  static MessageArg percent(int32_t value) {
+    return MessageArg(Type::Percent, value, nullptr);
+  }
+  static MessageArg milliseconds(uint32_t value) {
+    return MessageArg(Type::Seconds, value, nullptr);
+  }
+  static MessageArg milliVolts(uint32_t value) {
+    return MessageArg(Type::Volts, value, nullptr);
+  }
+  static MessageArg time(time_t value) {
+    return MessageArg(Type::Time, static_cast<int32_t>(value), nullptr);
+  }
+
+  Type type;
+  int32_t value;
+  const char* textValue;
+
+private:
+  MessageArg(Type type, int32_t value, const char* textValue)
+    : type(type), value(value), textValue(textValue) {}
+};
+
+class MessageFormatter {
+public:
+  // Writes the message of MESSAGE_LOCALE into the buffer, always terminated and cut
+  // at a character boundary if it does not fit. Returns the length written.
+  static size_t format(char* buffer, size_t size, Message message, std::initializer_list<MessageArg> args = {});
+};
 
 #endif
@@ -0,0 +1,104 @@
+#include "PowerPolicy.h"
+#include "ScheduleHandler.h"
+#include "Log.h"
+
+const LogModule LOG_MODULE = LogModule::Voltage;
+const uint32_t POWER_STATE_MAGIC = 0x50575231;  // "PWR1"
+const size_t TIER_COUNT = (size_t)PowerTier::Count;
+// Charge below which each tier applies; Normal has no lower bound
+const int TIER_THRESHOLDS[TIER_COUNT] = { 101, 30, 15, 5 };
+// Back to a higher tier only this far above its threshold
+const int RECOVERY_MARGIN = 5;
+// Feeding slots drift by the clock error, so a day is a little less than 24 hours
+const time_t DIGEST_INTERVAL = SECONDS_IN_DAY - SECONDS_IN_HOUR;
+const int MIN_WEIGHT_CONVERSIONS = 3;
+
+// Kept over resets, so a brownout does not announce the tier again; random after a power loss
+struct PowerState {
+  uint32_t magic;
+  PowerTier tier;
+  bool announced;  // the report with the last change went out
+  uint32_t lastReportTime;
+};
+
+RTC_NOINIT_ATTR static PowerState state;
+
+static bool isValid() {
+  return state.magic == POWER_STATE_MAGIC && (size_t)state.tier < TIER_COUNT;
+}
+
+static PowerTier tierFor(int stateOfChargePercent, PowerTier current) {
+  if (stateOfChargePercent < 0) {
+    return PowerTier::Normal;  // nothing known about the pack
+  }
+
+  size_t tier = 0;
+  while (tier + 1 < TIER_COUNT && stateOfChargePercent < TIER_THRESHOLDS[tier + 1]) {
+    tier++;
+  }
+  // Staying in a lower tier until the charge is clearly above its threshold
+  while ((size_t)current > tier && stateOfChargePercent < TIER_THRESHOLDS[tier + 1] + RECOVERY_MARGIN) {
+    tier++;
+  }
+  return (PowerTier)tier;
+}
+
+bool PowerPolicy::begin(int stateOfChargePercent) {
+  if (!isValid()) {
+    state = {};
+    state.magic = POWER_STATE_MAGIC;
+    state.tier = PowerTier::Normal;
+    state.announced = true;
+  }
+
+  PowerTier tier = tierFor(stateOfChargePercent, state.tier);
+  if (tier == state.tier) {
+    return false;
+  }
+
+  LOG_WARN("Power tier %u -> %u at %d%% charge", (uint8_t)state.tier, (uint8_t)tier, stateOfChargePercent);
+  state.tier = tier;
+  state.announced = false;
+  return true;
+}
+
+PowerTier PowerPolicy::tier() {
+  return isValid() ? state.tier : PowerTier::Normal;
+}
+
+int PowerPolicy::threshold(PowerTier tier) {
+  return TIER_THRESHOLDS[(size_t)tier];
+}
+
+bool PowerPolicy::reportDue(time_t slotTime) {
+  if (!isValid() || state.tier == PowerTier::Normal || !state.announced) {
+    return true;
+  }
+  return state.tier != PowerTier::Critical && slotTime - (time_t)state.lastReportTime >= DIGEST_INTERVAL;
+}
+
+void PowerPolicy::reported(time_t slotTime) {
+  if (isValid()) {
+    state.lastReportTime = static_cast<uint32_t>(slotTime);
+    state.announced = true;
+  }
+}
+
+bool PowerPolicy::detailedReports() {
+  return tier() == PowerTier::Normal;
+}
+
+bool PowerPolicy::clockSyncDue(bool connected) {
+  switch (tier()) {
+    case PowerTier::Normal: return true;
+    case PowerTier::Saving: return connected;
+    default: return false;
+  }
+}
+
+int PowerPolicy::weightConversions(int conversions) {
+  if (tier() < PowerTier::Low) {
+    return conversions;
+  }
+  return max(MIN_WEIGHT_CONVERSIONS, conversions / 2);
+}
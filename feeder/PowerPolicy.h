@@ -0,0 +1,45 @@
+#ifndef POWER_POLICY_H
+#define POWER_POLICY_H
+
+#include <Arduino.h>
+#include <time.h>
+
+// How much the feeder spends on anything but feeding, by the charge left
+enum class PowerTier : uint8_t {
+  Normal,    // a report and a clock sync after every feeding
+  Saving,    // one report a day, the clock synced along with it
+  Low,       // one report a day, no clock sync, shorter weighing
+  Critical,  // no networking; feedings only go to the journal
+  Count
+};
+
+// Picks the tier from the state of charge at the start of every wake. The tier
+// only goes back up with a margin, so a reading near a threshold does not flip
+// it on every wake. A change is announced in the next report, and that report
+// goes out whatever the tier, once.
+class PowerPolicy {
+public:
+  // Call once per wake with EnergyModel::stateOfChargePercent(). Returns true if the tier changed.
+  static bool begin(int stateOfChargePercent);
+
+  static PowerTier tier();
+
+  // Charge below which the tier applies, in percent
+  static int threshold(PowerTier tier);
+
+  // Whether the feeding of this slot connects and sends the report.
+  static bool reportDue(time_t slotTime);
+  // Call once the report went out.
+  static void reported(time_t slotTime);
+
+  // Whether the report has a line for every step of a feeding, or only for its outcome.
+  static bool detailedReports();
+
+  // Whether to sync the clock over NTP after a feeding.
+  static bool clockSyncDue(bool connected);
+
+  // HX711 conversions to average for a reading that would take the given number.
+  static int weightConversions(int conversions);
+};
+
+#endif
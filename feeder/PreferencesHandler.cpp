@@ -2,7 +2,10 @@
 #include "PreferencesHandler.h"
 #include <Preferences.h>
 #include "ScheduleHandler.h"
+#include "WakeProfiler.h"
+#include "Log.h"
 
+const LogModule LOG_MODULE = LogModule::Preferences;
 const char* const PREF_TELEGRAM = "telegram";
 const char* const PREF_TELEGRAM_BOT_TOKEN_KEY = "botToken";
 const char* const PREF_TELEGRAM_GROUP_ID_KEY = "groupId";
@@ -13,38 +16,138 @@ const char* const PREF_FEEDING_SCHEDULE = "schedule";
 const char* const PREF_FEEDING_PORTION_WEIGHT = "portionWeight";
 const char* const PREF_FEEDING_BOWL_WEIGHT = "bowlWeight";
 const char* const PREF_FEEDING_LAST_TIME = "lastTime";
+const char* const PREF_FEEDING_DISPENSE = "dispense";
+const char* const PREF_FEEDING_SLOTS = "slots";
+const char* const PREF_FEEDING_CHECKPOINT = "checkpoint";
 const char* const DEFAULT_FEEDING_SCHEDULE = "";
 const int DEFAULT_FEEDING_WEIGHT = 0;
 const int DEFAULT_FEEDING_BOWL_WEIGHT = 0;
 const int DEFAULT_FEEDING_LAST_TIME = 0;
 
-String PreferencesHandler::getBotToken() {
-  Serial.println("PreferencesHandler - Reading bot token from preferences");
+// Typed copy of every setting, loaded from NVS in one pass after a power loss (or a
+// settings change) and kept in RTC memory, so a regular wake reads nothing from flash.
+// Bump the version whenever the layout changes.
+const uint32_t CONFIG_SNAPSHOT_MAGIC = 0x43464731;  // "CFG1"
+const uint16_t CONFIG_SNAPSHOT_VERSION = 3;
+
+struct ConfigSnapshot {
+  uint32_t magic;
+  uint16_t version;
+  bool loaded;
+  char botToken[96];
+  char groupId[32];
+  char feedingSchedule[96];
+  int32_t feedingWeightPerPortion;
+  int32_t feedingBowlWeight;
+  uint32_t lastFeedingTime;
+  DispenseCalibration dispense;
+  FeedingSchedule feedingSlots;
+  FeedingCheckpoint checkpoint;
+};
+
+RTC_DATA_ATTR static ConfigSnapshot snapshot = {};
+
+static bool copyString(char* target, size_t size, const String& value) {
+  if (value.length() >= size) {
+    return false;
+  }
+  memcpy(target, value.c_str(), value.length() + 1);
+  return true;
+}
+
+// Only used when a value is too long for the snapshot
+static String readString(const char* name, const char* key, const char* defaultValue) {
+  WakeProfiler::Scope profile(WakePhase::Nvs);
   Preferences preferences;
-  preferences.begin(PREF_TELEGRAM, true);
-  String botToken = preferences.getString(PREF_TELEGRAM_BOT_TOKEN_KEY, DEFAULT_TELEGRAM_BOT_TOKEN);
+  preferences.begin(name, true);
+  String value = preferences.getString(key, defaultValue);
   preferences.end();
-  Serial.println("PreferencesHandler - Retrieved bot token: " + botToken);
-  return botToken;
+  return value;
 }
 
-String PreferencesHandler::getGroupId() {
-  Serial.println("PreferencesHandler - Reading group ID from preferences");
+// Compiles the schedule with the given portion and stores it next to the schedule string
+static void saveFeedingSlots(Preferences& preferences, const String& feedingSchedule, int weightPerPortion) {
+  FeedingSchedule compiled;
+  if (!ScheduleHandler::compileFeedingSchedule(feedingSchedule, weightPerPortion, compiled)) {
+    preferences.remove(PREF_FEEDING_SLOTS);
+    return;
+  }
+  preferences.putBytes(PREF_FEEDING_SLOTS, &compiled, sizeof(compiled));
+}
+
+static void invalidateSnapshot() {
+  snapshot.loaded = false;
+}
+
+// Strings that do not fit leave the snapshot unloaded; it is then reloaded on every
+// call and the string getters read their key directly
+static const ConfigSnapshot& loadSnapshot() {
+  if (snapshot.magic == CONFIG_SNAPSHOT_MAGIC && snapshot.version == CONFIG_SNAPSHOT_VERSION && snapshot.loaded) {
+    return snapshot;
+  }
+
+  LOG_INFO("Loading settings from preferences");
+  WakeProfiler::Scope profile(WakePhase::Nvs);
+  snapshot = {};
+  snapshot.magic = CONFIG_SNAPSHOT_MAGIC;
+  snapshot.version = CONFIG_SNAPSHOT_VERSION;
+  bool fits = true;
+
   Preferences preferences;
   preferences.begin(PREF_TELEGRAM, true);
-  String groupId = preferences.getString(PREF_TELEGRAM_GROUP_ID_KEY, DEFAULT_TELEGRAM_GROUP_ID);
+  fits &= copyString(snapshot.botToken, sizeof(snapshot.botToken), preferences.getString(PREF_TELEGRAM_BOT_TOKEN_KEY, DEFAULT_TELEGRAM_BOT_TOKEN));
+  fits &= copyString(snapshot.groupId, sizeof(snapshot.groupId), preferences.getString(PREF_TELEGRAM_GROUP_ID_KEY, DEFAULT_TELEGRAM_GROUP_ID));
   preferences.end();
-  Serial.println("PreferencesHandler - Retrieved group ID: " + groupId);
-  return groupId;
-}
 
-std::vector<String> PreferencesHandler::getFeedingSchedule() {
-  Serial.println("PreferencesHandler - Reading feeding schedule from preferences");
-  Preferences preferences;
   preferences.begin(PREF_FEEDING, true);
-  String feedingSchedule = preferences.getString(PREF_FEEDING_SCHEDULE, DEFAULT_FEEDING_SCHEDULE);
+  fits &= copyString(snapshot.feedingSchedule, sizeof(snapshot.feedingSchedule), preferences.getString(PREF_FEEDING_SCHEDULE, DEFAULT_FEEDING_SCHEDULE));
+  snapshot.feedingWeightPerPortion = preferences.getInt(PREF_FEEDING_PORTION_WEIGHT, DEFAULT_FEEDING_WEIGHT);
+  snapshot.feedingBowlWeight = preferences.getInt(PREF_FEEDING_BOWL_WEIGHT, DEFAULT_FEEDING_BOWL_WEIGHT);
+  snapshot.lastFeedingTime = preferences.getUInt(PREF_FEEDING_LAST_TIME, DEFAULT_FEEDING_LAST_TIME);
+  snapshot.dispense = { NAN, NAN };
+  if (preferences.getBytesLength(PREF_FEEDING_DISPENSE) == sizeof(snapshot.dispense)) {
+    preferences.getBytes(PREF_FEEDING_DISPENSE, &snapshot.dispense, sizeof(snapshot.dispense));
+  }
+  if (preferences.getBytesLength(PREF_FEEDING_CHECKPOINT) == sizeof(snapshot.checkpoint)) {
+    preferences.getBytes(PREF_FEEDING_CHECKPOINT, &snapshot.checkpoint, sizeof(snapshot.checkpoint));
+  }
+  if (preferences.getBytesLength(PREF_FEEDING_SLOTS) == sizeof(snapshot.feedingSlots)) {
+    preferences.getBytes(PREF_FEEDING_SLOTS, &snapshot.feedingSlots, sizeof(snapshot.feedingSlots));
+  }
+  if (snapshot.feedingSlots.version != FEEDING_SCHEDULE_VERSION) {
+    // Saved before schedules were compiled, or by an older layout
+    String feedingSchedule = preferences.getString(PREF_FEEDING_SCHEDULE, DEFAULT_FEEDING_SCHEDULE);
+    if (!ScheduleHandler::compileFeedingSchedule(feedingSchedule, snapshot.feedingWeightPerPortion, snapshot.feedingSlots)) {
+      snapshot.feedingSlots = {};
+    }
+  }
   preferences.end();
-  Serial.println("PreferencesHandler - Retrieved feeding schedule: " + feedingSchedule);
+
+  snapshot.loaded = fits;
+  if (!fits) {
+    LOG_WARN("Settings too long for the snapshot, reading them from preferences every time.");
+  }
+
+  LOG_DEBUG("Retrieved bot token of %u characters, group ID of %u characters", strlen(snapshot.botToken), strlen(snapshot.groupId));
+  LOG_INFO("Retrieved %u feeding slots, %d g per portion, bowl weight %d g", snapshot.feedingSlots.count,
+           snapshot.feedingWeightPerPortion, snapshot.feedingBowlWeight);
+  LOG_INFO("Retrieved last feeding time: %t", snapshot.lastFeedingTime);
+  LOG_INFO("Retrieved dispense rate: %.2f g/s, spread %.2f", snapshot.dispense.gramsPerSecond, snapshot.dispense.spread);
+  return snapshot;
+}
+
+String PreferencesHandler::getBotToken() {
+  const ConfigSnapshot& config = loadSnapshot();
+  return config.loaded ? String(config.botToken) : readString(PREF_TELEGRAM, PREF_TELEGRAM_BOT_TOKEN_KEY, DEFAULT_TELEGRAM_BOT_TOKEN);
+}
+
+String PreferencesHandler::getGroupId() {
+  const ConfigSnapshot& config = loadSnapshot();
+  return config.loaded ? String(config.groupId) : readString(PREF_TELEGRAM, PREF_TELEGRAM_GROUP_ID_KEY, DEFAULT_TELEGRAM_GROUP_ID);
+}
+
+std::vector<String> PreferencesHandler::getFeedingSchedule() {
+  String feedingSchedule = getFeedingScheduleString();
 
   std::vector<String> parsedSchedule;
 
@@ -59,163 +162,185 @@ std::vector<String> PreferencesHandler::getFeedingSchedule() {
   }
 
   // Add the last time (or the only time if no commas exist)
-  if (startIndex < feedingSchedule.length()) {
+  if (startIndex < static_cast<int>(feedingSchedule.length())) {
     parsedSchedule.push_back(feedingSchedule.substring(startIndex));
   }
 
-  Serial.println("PreferencesHandler - Parsed feeding schedule: ");
-  for (const String& time : parsedSchedule) {
-    Serial.println("PreferencesHandler - " + time);
-  }
-
   return parsedSchedule;
 }
 
 String PreferencesHandler::getFeedingScheduleString() {
-  Preferences preferences;
-  preferences.begin(PREF_FEEDING, true);
-  String feedingSchedule = preferences.getString(PREF_FEEDING_SCHEDULE, DEFAULT_FEEDING_SCHEDULE);
-  preferences.end();
-  return feedingSchedule;
+  const ConfigSnapshot& config = loadSnapshot();
+  return config.loaded ? String(config.feedingSchedule) : readString(PREF_FEEDING, PREF_FEEDING_SCHEDULE, DEFAULT_FEEDING_SCHEDULE);
 }
 
 int PreferencesHandler::getFeedingWeightPerPortion() {
-  Serial.println("PreferencesHandler - Reading feeding weight per portion from preferences");
-  Preferences preferences;
-  preferences.begin(PREF_FEEDING, true);
-  int weight = preferences.getInt(PREF_FEEDING_PORTION_WEIGHT, DEFAULT_FEEDING_WEIGHT);
-  preferences.end();
-  Serial.println("PreferencesHandler - Retrieved feeding weight per portion weight: " + String(weight));
-  return weight;
+  return loadSnapshot().feedingWeightPerPortion;
 }
 
 int PreferencesHandler::getFeedingBowlWeight() {
-  Serial.println("PreferencesHandler - Reading feeding bowl weight from preferences");
-  Preferences preferences;
-  preferences.begin(PREF_FEEDING, true);
-  int weight = preferences.getInt(PREF_FEEDING_BOWL_WEIGHT, DEFAULT_FEEDING_BOWL_WEIGHT);
-  preferences.end();
-  Serial.println("PreferencesHandler - Retrieved feeding bowl weight: " + String(weight));
-  return weight;
+  return loadSnapshot().feedingBowlWeight;
 }
 
 time_t PreferencesHandler::getLastFeedingTime() {
-  Serial.println("PreferencesHandler - Reading last feeding time from preferences");
-  Preferences preferences;
-  preferences.begin(PREF_FEEDING, true);
-  uint32_t storedTime = preferences.getUInt(PREF_FEEDING_LAST_TIME, DEFAULT_FEEDING_LAST_TIME);
-  preferences.end();
-  Serial.println("PreferencesHandler - Retrieved last feeding time: " + String(storedTime));
-  return static_cast<time_t>(storedTime);
+  return static_cast<time_t>(loadSnapshot().lastFeedingTime);
+}
+
+DispenseCalibration PreferencesHandler::getDispenseCalibration() {
+  return loadSnapshot().dispense;
+}
+
+FeedingCheckpoint PreferencesHandler::getFeedingCheckpoint() {
+  return loadSnapshot().checkpoint;
+}
+
+FeedingSchedule PreferencesHandler::getFeedingSlots() {
+  return loadSnapshot().feedingSlots;
 }
 
 bool PreferencesHandler::saveBotToken(const String& botToken) {
-  Serial.println("PreferencesHandler - Saving bot token to preferences: " + botToken);
+  LOG_INFO("Saving bot token to preferences");
 
   if (botToken.length() == 0) {
-    Serial.println("PreferencesHandler - Bot token is empty. Aborting save.");
+    LOG_WARN("Bot token is empty. Aborting save.");
     return false;
   }
 
+  WakeProfiler::Scope profile(WakePhase::Nvs);
   Preferences preferences;
   preferences.begin(PREF_TELEGRAM, false);
   preferences.putString(PREF_TELEGRAM_BOT_TOKEN_KEY, botToken);
   preferences.end();
-  Serial.println("PreferencesHandler - Bot token saved successfully");
+  invalidateSnapshot();
+  LOG_INFO("Bot token saved successfully");
 
   return true;
 }
 
 bool PreferencesHandler::saveGroupId(const String& groupId) {
-  Serial.println("PreferencesHandler - Saving group ID to preferences: " + groupId);
+  LOG_INFO("Saving group ID to preferences");
 
   if (groupId.length() == 0) {
-    Serial.println("PreferencesHandler - Group id is empty. Aborting save.");
+    LOG_WARN("Group id is empty. Aborting save.");
     return false;
   }
 
+  WakeProfiler::Scope profile(WakePhase::Nvs);
   Preferences preferences;
   preferences.begin(PREF_TELEGRAM, false);
   preferences.putString(PREF_TELEGRAM_GROUP_ID_KEY, groupId);
   preferences.end();
-  Serial.println("PreferencesHandler - Group ID saved successfully");
+  invalidateSnapshot();
+  LOG_INFO("Group ID saved successfully");
 
   return true;
 }
 
 bool PreferencesHandler::saveFeedingSchedule(const String& feedingSchedule) {
-  Serial.println("PreferencesHandler - Saving feeding schedule to preferences: " + feedingSchedule);
+  LOG_INFO("Saving feeding schedule to preferences");
 
   boolean valid = ScheduleHandler::validateFeedingSchedule(feedingSchedule);
 
   if (!valid) {
-    Serial.println("PreferencesHandler - Invalid feeding schedule. Aborting save.");
+    LOG_WARN("Invalid feeding schedule. Aborting save.");
     return false;
   }
 
+  WakeProfiler::Scope profile(WakePhase::Nvs);
   Preferences preferences;
   preferences.begin(PREF_FEEDING, false);
   preferences.putString(PREF_FEEDING_SCHEDULE, feedingSchedule);
+  saveFeedingSlots(preferences, feedingSchedule, preferences.getInt(PREF_FEEDING_PORTION_WEIGHT, DEFAULT_FEEDING_WEIGHT));
   preferences.end();
-  Serial.println("PreferencesHandler - Feeding schedule saved successfully");
+  invalidateSnapshot();
+  LOG_INFO("Feeding schedule saved successfully");
 
   return true;
 }
 
 bool PreferencesHandler::saveFeedingWeightPerPortion(const String& weightPerPortion) {
-  Serial.println("PreferencesHandler - Saving feeding weight per portion to preferences: " + weightPerPortion);
-
   if (weightPerPortion.length() == 0) {
-    Serial.println("PreferencesHandler - Weight per portion is empty. Aborting save.");
+    LOG_WARN("Weight per portion is empty. Aborting save.");
     return false;
   }
 
   int weight = weightPerPortion.toInt();
+  LOG_INFO("Saving feeding weight per portion to preferences: %d", weight);
 
   if (weight == 0 || weight < 1 || weight > 1000) {
-    Serial.println("PreferencesHandler - Invalid feeding weight. Must be between 1 and 1000.");
+    LOG_WARN("Invalid feeding weight. Must be between 1 and 1000.");
     return false;  // Exit if the input is invalid
   }
 
+  WakeProfiler::Scope profile(WakePhase::Nvs);
   Preferences preferences;
   preferences.begin(PREF_FEEDING, false);
   preferences.putInt(PREF_FEEDING_PORTION_WEIGHT, weight);
+  saveFeedingSlots(preferences, preferences.getString(PREF_FEEDING_SCHEDULE, DEFAULT_FEEDING_SCHEDULE), weight);
   preferences.end();
-  Serial.println("PreferencesHandler - Feeding weight per portion saved successfully");
+  invalidateSnapshot();
+  LOG_INFO("Feeding weight per portion saved successfully");
 
   return true;
 }
 
 bool PreferencesHandler::saveFeedingBowlWeight(const String& bowlWeight) {
-  Serial.println("PreferencesHandler - Saving feeding bowl weight to preferences: " + bowlWeight);
-
   if (bowlWeight.length() == 0) {
-    Serial.println("PreferencesHandler - Bowl weight is empty. Aborting save.");
+    LOG_WARN("Bowl weight is empty. Aborting save.");
     return false;
   }
 
   int weight = bowlWeight.toInt();
+  LOG_INFO("Saving feeding bowl weight to preferences: %d", weight);
 
   if (weight == 0 || weight < 1 || weight > 1000) {
-    Serial.println("PreferencesHandler - Invalid feeding bowl weight. Must be between 1 and 1000.");
+    LOG_WARN("Invalid feeding bowl weight. Must be between 1 and 1000.");
     return false;  // Exit if the input is invalid
   }
 
+  WakeProfiler::Scope profile(WakePhase::Nvs);
   Preferences preferences;
   preferences.begin(PREF_FEEDING, false);
   preferences.putInt(PREF_FEEDING_BOWL_WEIGHT, weight);
   preferences.end();
-  Serial.println("PreferencesHandler - Feeding bowl weight saved successfully");
+  invalidateSnapshot();
+  LOG_INFO("Feeding bowl weight saved successfully");
 
   return true;
 }
 
 void PreferencesHandler::saveLastFeedingTime(const time_t feedingTime) {
-  Serial.println("PreferencesHandler - Saving last feeding time to preferences: " + String(feedingTime));
+  LOG_INFO("Saving last feeding time to preferences: %t", (uint32_t)feedingTime);
 
+  WakeProfiler::Scope profile(WakePhase::Nvs);
   Preferences preferences;
   preferences.begin(PREF_FEEDING, false);
   preferences.putUInt(PREF_FEEDING_LAST_TIME, static_cast<uint32_t>(feedingTime));
   preferences.end();
-  Serial.println("PreferencesHandler - Feeding last feeding time saved successfully");
+  snapshot.lastFeedingTime = static_cast<uint32_t>(feedingTime);
+  LOG_INFO("Feeding last feeding time saved successfully");
+}
+
+void PreferencesHandler::saveDispenseCalibration(const DispenseCalibration& calibration) {
+  LOG_INFO("Saving dispense calibration to preferences: %.2f g/s, spread %.2f", calibration.gramsPerSecond, calibration.spread);
+
+  WakeProfiler::Scope profile(WakePhase::Nvs);
+  Preferences preferences;
+  preferences.begin(PREF_FEEDING, false);
+  preferences.putBytes(PREF_FEEDING_DISPENSE, &calibration, sizeof(calibration));
+  preferences.end();
+  snapshot.dispense = calibration;
+  LOG_INFO("Dispense calibration saved successfully");
+}
+
+void PreferencesHandler::saveFeedingCheckpoint(const FeedingCheckpoint& checkpoint) {
+  LOG_INFO("Saving feeding checkpoint to preferences: slot at %t, target %d", checkpoint.slotTime, checkpoint.targetWeight);
+
+  WakeProfiler::Scope profile(WakePhase::Nvs);
+  Preferences preferences;
+  preferences.begin(PREF_FEEDING, false);
+  preferences.putBytes(PREF_FEEDING_CHECKPOINT, &checkpoint, sizeof(checkpoint));
+  preferences.end();
+  snapshot.checkpoint = checkpoint;
+  LOG_INFO("Feeding checkpoint saved successfully");
 }
@@ -2,6 +2,9 @@
 #define PREFERENCES_HANDLER_H
 #include <vector>
 #include <Arduino.h>
+#include "DispenseController.h"
+#include "FeedingState.h"
+#include "ScheduleHandler.h"
 
 class PreferencesHandler {
 public:
@@ -12,6 +15,11 @@ public:
   static int getFeedingWeightPerPortion();
   static int getFeedingBowlWeight();
   static time_t getLastFeedingTime();
+  static DispenseCalibration getDispenseCalibration();
+  // Dispensing started last, so a power loss in the middle of it can be resumed
+  static FeedingCheckpoint getFeedingCheckpoint();
+  // The schedule as compiled when it or the portion was saved
+  static FeedingSchedule getFeedingSlots();
 
   static bool saveBotToken(const String& botToken);
   static bool saveGroupId(const String& groupId);
@@ -19,6 +27,8 @@ public:
   static bool saveFeedingWeightPerPortion(const String& weightPerPortion);
   static bool saveFeedingBowlWeight(const String& bowlWeight);
   static void saveLastFeedingTime(const time_t feedingTime);
+  static void saveDispenseCalibration(const DispenseCalibration& calibration);
+  static void saveFeedingCheckpoint(const FeedingCheckpoint& checkpoint);
 };
 
 #endif
@@ -1,25 +1,14 @@
 #include "RtcModule.h"
 #include "UsedPins.h"
 #include "Messages.h"
+#include "WakeProfiler.h"
+#include "Log.h"
+
+const LogModule LOG_MODULE = LogModule::Rtc;
 
 RtcModule::RtcModule(int dataPin, int clkPin, int rstPin, TelegramHandler& handler)
   : wire(dataPin, clkPin, rstPin), rtc(wire), telegramHandler(handler) {}
 
-String RtcModule::getDateTimeString(const RtcDateTime& dt) {
-  char datestring[26];
-  snprintf_P(
-    datestring,
-    countof(datestring),
-    PSTR("%02u/%02u/%04u %02u:%02u:%02u"),
-    dt.Month(),
-    dt.Day(),
-    dt.Year(),
-    dt.Hour(),
-    dt.Minute(),
-    dt.Second());
-  return String(datestring);
-}
-
 time_t RtcModule::rtcToTime_t(const RtcDateTime& rtcDateTime) {
   struct tm timeinfo;
   timeinfo.tm_year = rtcDateTime.Year() - 1900;
@@ -38,28 +27,28 @@ void RtcModule::begin() {
 }
 
 void RtcModule::sync() {
-  Serial.println("RtcModule - Syncing RTC module...");
+  LOG_INFO("Syncing RTC module...");
 
   RtcDateTime compiled = RtcDateTime(__DATE__, __TIME__);
 
   if (!rtc.IsDateTimeValid()) {
-    Serial.println("RtcModule - RTC lost confidence in the DateTime! Setting to compiled time.");
+    LOG_ERROR("RTC lost confidence in the DateTime! Setting to compiled time.");
     rtc.SetDateTime(compiled);
-    telegramHandler.sendBotMessage(MESSAGE_RTC_MODULE_ERROR);
+    telegramHandler.sendBotMessage(Message::RtcModuleError);
   }
 
   if (rtc.GetIsWriteProtected()) {
-    Serial.println("RtcModule - RTC was write protected, enabling writing now");
+    LOG_INFO("RTC was write protected, enabling writing now");
     rtc.SetIsWriteProtected(false);
   }
 
   if (!rtc.GetIsRunning()) {
-    Serial.println("RtcModule - RTC was not actively running, starting now");
+    LOG_INFO("RTC was not actively running, starting now");
     rtc.SetIsRunning(true);
   }
 
   RtcDateTime currentRtcTime = rtc.GetDateTime();
-  Serial.println("RtcModule - Current time: " + getDateTimeString(currentRtcTime));
+  LOG_INFO("Current time: %t", currentRtcTime.Unix32Time());
 
   bool timeSynced = TimeHandler::syncRealTimeClock();
 
@@ -67,8 +56,8 @@ void RtcModule::sync() {
     struct tm timeinfo;
     if (!getLocalTime(&timeinfo)) {
       currentRtcTime = rtc.GetDateTime();
-      telegramHandler.sendBotMessage(MESSAGE_TIME_SYNC_ERROR + getDateTimeString(currentRtcTime));
-      Serial.println("RtcModule - Failed to obtain ESP32 RTC time. Current time: " + getDateTimeString(currentRtcTime));
+      telegramHandler.sendBotMessage(Message::TimeSyncError, { MessageArg::time(currentRtcTime.Unix32Time()) });
+      LOG_ERROR("Failed to obtain ESP32 RTC time. Current time: %t", currentRtcTime.Unix32Time());
       return;
     }
 
@@ -83,27 +72,27 @@ void RtcModule::sync() {
     rtc.SetDateTime(newTime);
 
     currentRtcTime = rtc.GetDateTime();
-    Serial.println("RtcModule - Time sync successful. RTC updated. Current time: " + getDateTimeString(currentRtcTime));
+    LOG_INFO("Time sync successful. RTC updated. Current time: %t", currentRtcTime.Unix32Time());
   } else {
     currentRtcTime = rtc.GetDateTime();
-    telegramHandler.sendBotMessage(MESSAGE_TIME_SYNC_ERROR + getDateTimeString(currentRtcTime));
-    Serial.println("RtcModule - Time sync failed, sent error message to Telegram. Current time: " + getDateTimeString(currentRtcTime));
+    telegramHandler.sendBotMessage(Message::TimeSyncError, { MessageArg::time(currentRtcTime.Unix32Time()) });
+    LOG_WARN("Time sync failed, sent error message to Telegram. Current time: %t", currentRtcTime.Unix32Time());
   }
 }
 
 time_t RtcModule::getCurrentTime() {
-  Serial.println("RtcModule - Retrieving current time from RTC...");
+  WakeProfiler::Scope profile(WakePhase::RtcRead);
+  LOG_DEBUG("Retrieving current time from RTC...");
   RtcDateTime currentRtcTime = rtc.GetDateTime();
 
   if (!currentRtcTime.IsValid()) {
     time_t now;
     time(&now);
-    telegramHandler.sendBotMessage(MESSAGE_TIME_RETRIEVING_ERROR + String(now));
-    Serial.println("RtcModule - Invalid RTC time, fallback to system time.");
+    telegramHandler.sendBotMessage(Message::TimeRetrievingError, { MessageArg::time(now) });
+    LOG_WARN("Invalid RTC time, fallback to system time.");
     return now;
   }
 
-  Serial.print("RtcModule - Current time retrieved from RTC: ");
-  Serial.println(getDateTimeString(currentRtcTime));
+  LOG_INFO("Current time retrieved from RTC: %t", currentRtcTime.Unix32Time());
   return rtcToTime_t(currentRtcTime);
 }
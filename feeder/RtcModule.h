@@ -13,7 +13,6 @@ private:
   RtcDS1302<ThreeWire> rtc;
   TelegramHandler& telegramHandler;
 
-  String getDateTimeString(const RtcDateTime& dt);
   time_t rtcToTime_t(const RtcDateTime& rtcDateTime);
 
 public:
@@ -1,188 +1,161 @@
 #include "ScheduleHandler.h"
-#include "PreferencesHandler.h"
-#include "TimeUtils.h"
+#include "WakeupPlanner.h"
+#include "Log.h"
 
+const LogModule LOG_MODULE = LogModule::Schedule;
 const int MIN_TIME_GAP = 120;
 
-std::vector<time_t> ScheduleHandler::parseFeedingSchedule(const time_t now) {
-  std::vector<String> feedingSchedule = PreferencesHandler::getFeedingSchedule();
-  std::vector<time_t> feedingTimes;
-
-  struct tm timeinfo;
-
-  localtime_r(&now, &timeinfo);
-
-  int year = timeinfo.tm_year;
-  int month = timeinfo.tm_mon;
-  int day = timeinfo.tm_mday;
-
-  Serial.println("ScheduleHandler - Parsing feeding schedule...");
-
-  for (String timeStr : feedingSchedule) {
-    int hour, minute;
-    sscanf(timeStr.c_str(), "%d:%d", &hour, &minute);
-    timeinfo.tm_year = year;
-    timeinfo.tm_mon = month;
-    timeinfo.tm_mday = day;
-    timeinfo.tm_hour = hour;
-    timeinfo.tm_min = minute;
-    timeinfo.tm_sec = 0;
+static bool isTwoDigits(const char* text) {
+  return isDigit(text[0]) && isDigit(text[1]);
+}
 
-    feedingTimes.push_back(mktime(&timeinfo));
-    Serial.println("ScheduleHandler - Parsed feeding time: " + String(hour) + ":" + String(minute));
+// First slot strictly after the given time, looking into the following day if needed
+static time_t nextSlotAfter(const FeedingSchedule& schedule, const time_t after, int& index) {
+  time_t dayStart = after - after % SECONDS_IN_DAY;
+
+  // Slots are sorted; the first one past this minute is the next one
+  int low = 0;
+  int high = schedule.count;
+  while (low < high) {
+    int middle = (low + high) / 2;
+    if (schedule.slots[middle].minuteOfDay * 60 + dayStart > after) {
+      high = middle;
+    } else {
+      low = middle + 1;
+    }
   }
 
-  return feedingTimes;
+  if (low == schedule.count) {
+    index = 0;
+    return dayStart + SECONDS_IN_DAY + schedule.slots[0].minuteOfDay * 60;
+  }
+  index = low;
+  return dayStart + schedule.slots[low].minuteOfDay * 60;
 }
 
-time_t ScheduleHandler::shouldFeedNow(const std::vector<time_t>& feedingTimes, const time_t now) {
-  time_t lastFeedingTime = PreferencesHandler::getLastFeedingTime();
-
-  time_t previousDayFeedingTime = feedingTimes.back() - SECONDS_IN_DAY;  // Check last feeding of previous day (time drift)
-
-  if (now - previousDayFeedingTime <= TOLERANCE && previousDayFeedingTime != lastFeedingTime) {
-    Serial.println("ScheduleHandler - Feeding time from the previous day within tolerance.");
-    return previousDayFeedingTime;
+time_t ScheduleHandler::shouldFeedNow(const FeedingSchedule& schedule, const time_t now, const time_t lastFeedingTime, FeedingSlot& slot) {
+  if (schedule.count == 0) {
+    LOG_INFO("Feeding schedule is empty.");
+    return 0;
   }
 
-  for (time_t feedingTime : feedingTimes) {
-    if (feedingTime > now - TOLERANCE && feedingTime < now + TOLERANCE && feedingTime != lastFeedingTime) {
-      Serial.println("ScheduleHandler - Should feed now at: " + String(feedingTime));
-      return feedingTime;
-    }
+  // Slots are at least MIN_TIME_GAP apart, so at most one is within tolerance. Starting
+  // TOLERANCE back also finds the previous day's last slot when the clock drifted past midnight.
+  int index;
+  time_t feedingTime = nextSlotAfter(schedule, now - TOLERANCE, index);
+
+  if (feedingTime < now + TOLERANCE && feedingTime != lastFeedingTime) {
+    LOG_INFO("Should feed now at: %t", (uint32_t)feedingTime);
+    slot = schedule.slots[index];
+    return feedingTime;
   }
 
-  Serial.println("ScheduleHandler - No feeding time within tolerance.");
+  LOG_INFO("No feeding time within tolerance.");
   return 0;
 }
 
-time_t ScheduleHandler::calculateNextWakeup(const std::vector<time_t>& feedingTimes, const time_t now, const bool feedingInCurrentIteration) {
-  Serial.println("ScheduleHandler - Calculating next wakeup time...");
+time_t ScheduleHandler::calculateNextWakeup(const FeedingSchedule& schedule, const time_t now, const bool feedingInCurrentIteration) {
+  LOG_DEBUG("Calculating next wakeup time...");
 
-  if (feedingInCurrentIteration) {
+  if (schedule.count == 0) {
+    LOG_INFO("Wake up in 1 hour.");
     return now + SECONDS_IN_HOUR;
   }
 
-  // Iterate through the feeding times and return the next valid wakeup time
-  for (time_t feedingTime : feedingTimes) {
-    if (feedingTime > now) {
-      // If the feeding time is more than an hour away, wake up in 1 hour
-      if (feedingTime - now > SECONDS_IN_HOUR) {
-        Serial.println("ScheduleHandler - Wake up in 1 hour.");
-        return now + SECONDS_IN_HOUR;
-      }
-      Serial.println("ScheduleHandler - Wake up at: " + String(feedingTime));
-      return feedingTime;  // Otherwise, return the actual feeding time
-    }
-  }
+  // A slot being fed right now can still be slightly ahead of the clock
+  int index;
+  time_t nextFeedingTime = nextSlotAfter(schedule, feedingInCurrentIteration ? now + TOLERANCE : now, index);
 
-  // If all feeding times are in the past, check the next day's feeding time
-  time_t nextDayFeedingTime = feedingTimes[0] + SECONDS_IN_DAY;
-  // If the next day's feeding time is more than an hour away, wake up in 1 hour
-  if (nextDayFeedingTime - now > SECONDS_IN_HOUR) {
-    Serial.println("ScheduleHandler - Wake up in 1 hour.");
+  // Without a measured sleep timer rate a long sleep could overshoot the slot, so wake up hourly
+  if (!WakeupPlanner::isCalibrated() && nextFeedingTime - now > SECONDS_IN_HOUR) {
+    LOG_INFO("Wake up in 1 hour.");
     return now + SECONDS_IN_HOUR;
   }
 
-  Serial.println("ScheduleHandler - Wake up at: " + String(nextDayFeedingTime));
-  return nextDayFeedingTime;  // Otherwise, return the next day's feeding time
-}
-
-bool isValidTimeArrayCharacter(char ch) {
-  return isDigit(ch) || ch == ':' || ch == ',';
+  LOG_INFO("Wake up at: %t", (uint32_t)nextFeedingTime);
+  return nextFeedingTime;
 }
 
-bool hasTrailingComma(const String& feedingSchedule) {
-  return feedingSchedule.charAt(feedingSchedule.length() - 1) == ',';
-}
-
-// This function validates the feeding schedule string, ensuring it follows the correct format and logic.
-// The feeding schedule is expected to be a comma-separated list of times (HH:MM), with no trailing commas.
-// It performs the following checks:
-// 1. Ensures the feeding schedule is not empty.
-// 2. Verifies that only valid characters (digits, commas, and colons) are present.
-// 3. Confirms there is no trailing comma at the end of the string.
-// 4. Validates each time in the schedule, ensuring it's in the correct HH:MM format and within valid ranges (00:00-23:59).
-// 5. Ensures that consecutive feeding times are at least a minimum time gap apart (defined by MIN_TIME_GAP).
-// 6. Verifies that the gap between the first and last time in the schedule is at least the minimum time gap, accounting for crossing midnight (24-hour format).
-// If any of these checks fail, the function returns false, indicating an invalid schedule.
-// If all checks pass, it returns true, indicating the feeding schedule is valid.
-bool ScheduleHandler::validateFeedingSchedule(const String& feedingSchedule) {
-  if (feedingSchedule.length() == 0) {
-    Serial.println("ScheduleHandler - Feeding schedule is empty.");
+// Compiles a comma-separated list of HH:MM times (UTC) into sorted minute-of-day slots.
+// The schedule is rejected if:
+// 1. it is empty, or has characters other than digits, colons and commas;
+// 2. it has a trailing comma or more than MAX_FEEDING_SLOTS times;
+// 3. a time is not exactly HH:MM within 00:00-23:59;
+// 4. the times are not ascending and at least MIN_TIME_GAP minutes apart, including the
+//    gap from the last time to the first one across midnight.
+bool ScheduleHandler::compileFeedingSchedule(const String& feedingSchedule, uint16_t portionGrams, FeedingSchedule& compiled) {
+  compiled = {};
+  compiled.version = FEEDING_SCHEDULE_VERSION;
+
+  const char* text = feedingSchedule.c_str();
+  size_t length = feedingSchedule.length();
+
+  if (length == 0) {
+    LOG_WARN("Feeding schedule is empty.");
     return false;
   }
 
-  // Check for invalid characters (only digits, commas, and colon are allowed)
-  for (int i = 0; i < feedingSchedule.length(); i++) {
-    char ch = feedingSchedule.charAt(i);
-    if (!isValidTimeArrayCharacter(ch)) {
-      Serial.println("ScheduleHandler - Invalid character detected: " + String(ch));
+  for (size_t i = 0; i < length; i++) {
+    char ch = text[i];
+    if (!isDigit(ch) && ch != ':' && ch != ',') {
+      LOG_WARN("Invalid character detected at position %u", i);
       return false;
     }
   }
 
-  // Ensure no trailing comma
-  if (hasTrailingComma(feedingSchedule)) {
-    Serial.println("ScheduleHandler - Feeding schedule has a trailing comma.");
+  if (text[length - 1] == ',') {
+    LOG_WARN("Feeding schedule has a trailing comma.");
     return false;
   }
 
-  // Split the feeding schedule string by commas
-  int start = 0;
-  int end = feedingSchedule.indexOf(',');
-  String previousTime = "";  // To store the last valid time for comparison
-  String firstTime = "";
-
-  while (end != -1) {
-    String time = feedingSchedule.substring(start, end);
+  size_t start = 0;
+  while (start < length) {
+    const char* time = text + start;
+    const char* comma = strchr(time, ',');
+    size_t timeLength = comma != nullptr ? comma - time : length - start;
 
-    if (previousTime.length() == 0) {
-      firstTime = time;  // The first time
+    if (timeLength != 5 || time[2] != ':' || !isTwoDigits(time) || !isTwoDigits(time + 3)) {
+      LOG_WARN("Invalid time format detected at position %u", start);
+      return false;
     }
 
-    if (!TimeUtils::isValidTimeFormat(time)) {
-      Serial.println("ScheduleHandler - Invalid time format detected: " + time);
+    int hours = (time[0] - '0') * 10 + (time[1] - '0');
+    int minutes = (time[3] - '0') * 10 + (time[4] - '0');
+    if (hours > 23 || minutes > 59) {
+      LOG_WARN("Invalid time format (out of range): %02d:%02d", hours, minutes);
       return false;
     }
 
-    if (previousTime.length() > 0 && !TimeUtils::areTimesAtLeastGapApart(previousTime, time, MIN_TIME_GAP)) {
-      Serial.println("ScheduleHandler - Feeding times not at least " + String(MIN_TIME_GAP) + " minutes apart.");
-      return false;  // Return if times are not at least the specified time gap apart
+    if (compiled.count == MAX_FEEDING_SLOTS) {
+      LOG_WARN("More than %d feeding times.", MAX_FEEDING_SLOTS);
+      return false;
     }
 
-    previousTime = time;
-    start = end + 1;
-    end = feedingSchedule.indexOf(',', start);
-  }
-
-  // Check the last time segment after the last comma
-  String finalTime = feedingSchedule.substring(start);
+    int minuteOfDay = hours * 60 + minutes;
+    if (compiled.count > 0 && minuteOfDay - compiled.slots[compiled.count - 1].minuteOfDay < MIN_TIME_GAP) {
+      LOG_WARN("Feeding times not at least %d minutes apart.", MIN_TIME_GAP);
+      return false;
+    }
 
-  if (previousTime.length() == 0) {
-    firstTime = finalTime;  // The first time
+    compiled.slots[compiled.count++] = { (uint16_t)minuteOfDay, portionGrams };
+    start += timeLength + 1;
   }
 
-  if (!TimeUtils::isValidTimeFormat(finalTime)) {
-    Serial.println("ScheduleHandler - Invalid time format detected: " + finalTime);
+  int gap = compiled.slots[0].minuteOfDay + MINUTES_IN_DAY - compiled.slots[compiled.count - 1].minuteOfDay;
+  if (gap < MIN_TIME_GAP) {
+    LOG_WARN("Less than %d minutes between the first and last time in the schedule.", MIN_TIME_GAP);
     return false;
   }
 
-  if (previousTime.length() > 0 && !TimeUtils::areTimesAtLeastGapApart(previousTime, finalTime, MIN_TIME_GAP)) {
-    Serial.println("ScheduleHandler - Feeding times not at least " + String(MIN_TIME_GAP) + " minutes apart.");
-    return false;  // Return if times are not at least the specified time gap apart
-  }
-
-  // Now we need to check if the gap between the first and last time is at least the minimum time gap (check midnight)
-  int lastTimeMinutes = TimeUtils::timeToMinutes(finalTime);
-  int firstTimeMinutes = TimeUtils::timeToMinutes(firstTime);
+  return true;
+}
 
-  int gap = (firstTimeMinutes + (1440 - lastTimeMinutes));  // 1440 is the total minutes in a day
-  if (gap < MIN_TIME_GAP) {                                 // Using MIN_TIME_GAP constant
-    Serial.println("ScheduleHandler - Less than " + String(MIN_TIME_GAP) + " minutes between the first and last time in the schedule.");
-    return false;  // Return if the gap is less than the minimum time gap across midnight
+bool ScheduleHandler::validateFeedingSchedule(const String& feedingSchedule) {
+  FeedingSchedule compiled;
+  if (!compileFeedingSchedule(feedingSchedule, 0, compiled)) {
+    return false;
   }
 
-  Serial.println("ScheduleHandler - Feeding schedule validated successfully.");
+  LOG_INFO("Feeding schedule validated successfully.");
   return true;
 }
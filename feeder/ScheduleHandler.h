@@ -2,20 +2,37 @@
 #define SCHEDULE_HANDLER_H
 
 #include <Arduino.h>
-#include <vector>
 #include <time.h>
 
 const int TOLERANCE = 900;  // in seconds
 const int SECONDS_IN_HOUR = 3600;
 const int SECONDS_IN_DAY = 86400;
+const int MINUTES_IN_DAY = 1440;
+const int MAX_FEEDING_SLOTS = 12;  // one every MIN_TIME_GAP minutes
+const uint8_t FEEDING_SCHEDULE_VERSION = 1;
+
+struct FeedingSlot {
+  uint16_t minuteOfDay;   // UTC
+  uint16_t portionGrams;
+};
+
+// The schedule string compiled at save time: slots sorted by time of day, so the
+// wake path only needs integer arithmetic on the DS1302 time.
+struct FeedingSchedule {
+  uint8_t version;
+  uint8_t count;
+  FeedingSlot slots[MAX_FEEDING_SLOTS];
+};
 
 class ScheduleHandler {
 public:
-  static std::vector<time_t> parseFeedingSchedule(const time_t now);
+  // Validates the schedule string and compiles it, giving every slot the same portion.
+  static bool compileFeedingSchedule(const String& feedingSchedule, uint16_t portionGrams, FeedingSchedule& compiled);
 
-  static time_t shouldFeedNow(const std::vector<time_t>& feedingTimes, const time_t now);
+  // Slot due within TOLERANCE of now that has not been fed yet, 0 if none.
+  static time_t shouldFeedNow(const FeedingSchedule& schedule, const time_t now, const time_t lastFeedingTime, FeedingSlot& slot);
 
-  static time_t calculateNextWakeup(const std::vector<time_t>& feedingTimes, const time_t now, const bool feedingInCurrentIteration);
+  static time_t calculateNextWakeup(const FeedingSchedule& schedule, const time_t now, const bool feedingInCurrentIteration);
 
   static bool validateFeedingSchedule(const String& feedingSchedule);
 };
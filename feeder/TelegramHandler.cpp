@@ -1,21 +1,96 @@
 #include "TelegramHandler.h"
 #include <WiFi.h>
+#include "WakeProfiler.h"
+#include "Log.h"
+
+const LogModule LOG_MODULE = LogModule::Telegram;
 
 // Constants for retries and delay
 const int MAX_RETRIES = 3;
 const int RETRY_DELAY_MS = 2000;
 const char* const TELEGRAM_CERT = TELEGRAM_CERTIFICATE_ROOT;  // Certificate for secure communication
+const uint32_t PENDING_MESSAGES_MAGIC = 0x4D534751;           // "MSGQ"
+const size_t PENDING_MESSAGES_CAPACITY = 1536;                // bytes of UTF-8, well below the 4096 character limit
+
+// Report lines not delivered yet. Lives in RTC memory so a failed flush is retried on a later wake;
+// memory a reset leaves alone, so the lines queued before a brownout are not lost either.
+struct PendingMessages {
+  uint32_t magic;
+  uint16_t length;
+  char text[PENDING_MESSAGES_CAPACITY];
+};
+
+RTC_NOINIT_ATTR static PendingMessages pendingMessages;
+
+// Random after a power loss
+static bool pendingMessagesValid() {
+  return pendingMessages.magic == PENDING_MESSAGES_MAGIC && pendingMessages.length <= PENDING_MESSAGES_CAPACITY;
+}
+
+const uint32_t TLS_STATS_MAGIC = 0x544C5332;  // "TLS2"
+
+// Handshake statistics since the last power loss. The ESP32 core's WiFiClientSecure
+// can't resume a TLS session, so every wake that reports does a full handshake; only
+// the requests that reuse the wake's kept-alive connection save one.
+struct TlsStats {
+  uint32_t magic;
+  uint32_t handshakes;
+  uint32_t handshakeMs;
+  uint32_t reusedConnections;
+};
+
+RTC_DATA_ATTR static TlsStats tlsStats = {};
+
+static bool isSeparatorLine(const char* line, size_t length) {
+  for (size_t i = 0; i < length; i++) {
+    if (line[i] != '-') {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Removes the oldest line together with any separator lines that follow it
+static void dropOldestLine() {
+  bool droppedMessage = false;
+
+  while (pendingMessages.length > 0) {
+    char* newline = (char*)memchr(pendingMessages.text, '\n', pendingMessages.length);
+    size_t lineLength = newline != nullptr ? newline - pendingMessages.text : pendingMessages.length;
+    bool separator = isSeparatorLine(pendingMessages.text, lineLength);
+
+    if (droppedMessage && !separator) {
+      return;
+    }
+
+    size_t consumed = newline != nullptr ? lineLength + 1 : lineLength;
+    memmove(pendingMessages.text, pendingMessages.text + consumed, pendingMessages.length - consumed);
+    pendingMessages.length -= consumed;
+    droppedMessage = droppedMessage || !separator;
+  }
+}
 
 TelegramHandler::TelegramHandler()
-  : bot(nullptr) {}
+  : queuedThisWake(false), bot(nullptr) {}
 
 void TelegramHandler::begin(const String& botToken, const String& groupId) {
+  if (!pendingMessagesValid()) {
+    pendingMessages.magic = PENDING_MESSAGES_MAGIC;
+    pendingMessages.length = 0;
+  }
+  queuedThisWake = false;
+
+  if (tlsStats.magic != TLS_STATS_MAGIC) {
+    tlsStats = {};
+    tlsStats.magic = TLS_STATS_MAGIC;
+  }
+
   this->botToken = botToken;
   this->groupId = groupId;
 
   // Check if token or group ID is missing
   if (botToken.isEmpty() || groupId.isEmpty()) {
-    Serial.println("TelegramHandler - Bot token or group ID is missing.");
+    LOG_WARN("Bot token or group ID is missing.");
     return;
   }
 
@@ -29,44 +104,144 @@ void TelegramHandler::begin(const String& botToken, const String& groupId) {
 
   // Create a new instance of UniversalTelegramBot with the updated botToken
   bot = new UniversalTelegramBot(botToken, securedClient);
+  bot->keepAlive = true;  // closed in end()
+  bot->streamResponses = true;
 
-  Serial.println("TelegramHandler - initialized with new botToken and groupId.");
+  LOG_INFO("initialized with new botToken and groupId.");
 }
 
-// Function to send a message to the specified Telegram group
-void TelegramHandler::sendBotMessage(const String& message) {
+// Function to send a message to the specified Telegram group, together with anything still pending
+void TelegramHandler::sendBotMessage(const char* message) {
+  queueMessage(message);
+  flushMessages();
+}
 
-  if (bot == nullptr) {
-    Serial.println("TelegramHandler - Telegram bot not initialized.");
+void TelegramHandler::sendBotMessage(Message message, std::initializer_list<MessageArg> args) {
+  queueMessage(message, args);
+  flushMessages();
+}
+
+void TelegramHandler::queueMessage(const char* message) {
+  if (!pendingMessagesValid()) {
+    pendingMessages.magic = PENDING_MESSAGES_MAGIC;
+    pendingMessages.length = 0;
+  }
+
+  // Lines left over from an earlier wake are set apart from this wake's report
+  size_t messageLength = strlen(message);
+  const char* separator = pendingMessages.length == 0 ? "" : (queuedThisWake ? "\n" : MESSAGE_END_SEPARATOR);
+  size_t needed = strlen(separator) + messageLength;
+
+  if (messageLength > PENDING_MESSAGES_CAPACITY) {
+    LOG_WARN("Message too long to queue, dropped.");
     return;
   }
 
-  Serial.println("Attempting to send message: " + message);
+  while (pendingMessages.length > 0 && pendingMessages.length + needed > PENDING_MESSAGES_CAPACITY) {
+    LOG_WARN("Report queue full, dropping the oldest line.");
+    dropOldestLine();
+    if (pendingMessages.length == 0) {
+      separator = "";
+      needed = messageLength;
+    }
+  }
+
+  memcpy(pendingMessages.text + pendingMessages.length, separator, strlen(separator));
+  pendingMessages.length += strlen(separator);
+  memcpy(pendingMessages.text + pendingMessages.length, message, messageLength);
+  pendingMessages.length += messageLength;
+  queuedThisWake = true;
 
-  // Check if Wi-Fi is connected before attempting to send the message
+  LOG_INFO("Queued a message of %u bytes, %u bytes pending", messageLength, pendingMessages.length);
+}
+
+void TelegramHandler::queueMessage(const String& message) {
+  queueMessage(message.c_str());
+}
+
+void TelegramHandler::queueMessage(Message message, std::initializer_list<MessageArg> args) {
+  char text[MESSAGE_BUFFER_SIZE];
+  MessageFormatter::format(text, sizeof(text), message, args);
+  queueMessage(text);
+}
+
+bool TelegramHandler::flushMessages() {
+  if (!pendingMessagesValid() || pendingMessages.length == 0) {
+    return true;
+  }
+
+  if (bot == nullptr) {
+    LOG_WARN("Telegram bot not initialized. Keeping %u bytes queued.", pendingMessages.length);
+    return false;
+  }
+
+  // Check if Wi-Fi is connected before attempting to send the report
   if (WiFi.status() != WL_CONNECTED) {
-    Serial.println("TelegramHandler - Wi-Fi not connected. Cannot send message.");
-    return;
+    LOG_WARN("Wi-Fi not connected. Keeping %u bytes queued.", pendingMessages.length);
+    return false;
+  }
+
+  String report(pendingMessages.text, pendingMessages.length);
+  if (!sendWithRetries(report)) {
+    return false;
+  }
+
+  pendingMessages.length = 0;
+  return true;
+}
+
+void TelegramHandler::end() {
+  if (bot != nullptr) {
+    bot->closeClient();
   }
+}
+
+bool TelegramHandler::sendWithRetries(const String& message) {
+  WakeProfiler::Scope profile(WakePhase::TelegramSend);
+  LOG_INFO("Attempting to send a message of %u bytes", message.length());
+
+  unsigned long connections = bot->connectionCount;
+  unsigned long connectMillis = bot->connectMillis;
+  unsigned long reusedConnections = bot->reusedConnectionCount;
 
   int retryCount = 0;
   bool success = false;
 
   // Retry logic for sending the message
   while (retryCount < MAX_RETRIES && !success) {
-    Serial.println("TelegramHandler - Sending message. Attempt: " + String(retryCount + 1));
+    LOG_DEBUG("Sending message. Attempt: %d", retryCount + 1);
     success = bot->sendMessage(groupId, message);
 
     if (!success) {
-      Serial.println("TelegramHandler - Error sending message. Retrying...");
+      LOG_WARN("Error sending message. Retrying...");
       retryCount++;
       delay(RETRY_DELAY_MS);  // Delay before retrying
     }
   }
 
   if (success) {
-    Serial.println("TelegramHandler - Message sent successfully.");
+    LOG_INFO("Message sent successfully.");
   } else {
-    Serial.println("TelegramHandler - Failed to send message after " + String(MAX_RETRIES) + " attempts.");
+    LOG_ERROR("Failed to send message after %d attempts.", MAX_RETRIES);
   }
+
+  recordConnections(bot->connectionCount - connections, bot->connectMillis - connectMillis, bot->reusedConnectionCount - reusedConnections);
+  return success;
+}
+
+void TelegramHandler::recordConnections(unsigned long handshakes, unsigned long handshakeMs, unsigned long reused) {
+  tlsStats.handshakes += handshakes;
+  tlsStats.handshakeMs += handshakeMs;
+  tlsStats.reusedConnections += reused;
+
+  if (tlsStats.handshakes == 0) {
+    return;
+  }
+
+  // Every reused connection saves a handshake
+  uint32_t averageMs = tlsStats.handshakeMs / tlsStats.handshakes;
+  uint32_t savedMs = tlsStats.reusedConnections * averageMs;
+
+  LOG_INFO("Handshakes: %u (%u ms avg)", tlsStats.handshakes, averageMs);
+  LOG_INFO("%u requests on a kept-alive connection. Saved %u ms.", tlsStats.reusedConnections, savedMs);
 }
@@ -4,18 +4,35 @@
 #include <Arduino.h>
 #include <WiFiClientSecure.h>
 #include <UniversalTelegramBot.h>
+#include "Messages.h"
 
 class TelegramHandler {
 public:
   TelegramHandler();
   void begin(const String& botToken, const String& groupId);
-  void sendBotMessage(const String& message);
+  void sendBotMessage(const char* message);
+  void sendBotMessage(Message message, std::initializer_list<MessageArg> args = {});
+
+  // Adds a line to the pending report kept in RTC memory; nothing is sent yet.
+  void queueMessage(const char* message);
+  void queueMessage(const String& message);
+  // Formats a catalogue message straight into the report, without touching the heap.
+  void queueMessage(Message message, std::initializer_list<MessageArg> args = {});
+  // Sends all pending lines as one message. Returns false if they are still pending.
+  bool flushMessages();
+  // Closes the kept-alive connection to the Bot API; call before deep sleep.
+  void end();
 
 private:
+  bool queuedThisWake;
+
   String botToken;
   String groupId;
   WiFiClientSecure securedClient;
   UniversalTelegramBot* bot;
+
+  bool sendWithRetries(const String& message);
+  void recordConnections(unsigned long handshakes, unsigned long handshakeMs, unsigned long reused);
 };
 
 #endif
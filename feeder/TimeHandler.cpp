@@ -2,7 +2,10 @@
 #include <WiFi.h>
 #include <time.h>
 #include "sntp.h"
+#include "WakeProfiler.h"
+#include "Log.h"
 
+const LogModule LOG_MODULE = LogModule::Time;
 const char* NTP_SERVER = "pool.ntp.org";
 const long GMT_OFFSET_SEC = 0;
 const int DAYLIGHT_OFFSET_SEC = 0;
@@ -13,27 +16,26 @@ static bool TIME_SYNCED = false;
 static void printLocalTime() {
   struct tm timeinfo;
   if (!getLocalTime(&timeinfo)) {
-    Serial.println("TimeHandler - Failed to obtain time.");
+    LOG_WARN("Failed to obtain time.");
     return;
   }
 
-  char timeString[64];
-  strftime(timeString, sizeof(timeString), "%Y-%m-%d %H:%M:%S", &timeinfo);
-  Serial.printf("TimeHandler - Current Time: %s\n", timeString);
+  LOG_INFO("Current Time: %t", (uint32_t)mktime(&timeinfo));
 }
 
 void timeAvailable(struct timeval* t) {
-  Serial.println("TimeHandler - Got time adjustment from NTP!");
+  LOG_INFO("Got time adjustment from NTP!");
   TIME_SYNCED = true;
 }
 
 bool TimeHandler::syncRealTimeClock() {
+  WakeProfiler::Scope profile(WakePhase::NtpSync);
   if (WiFi.status() != WL_CONNECTED) {
-    Serial.println("TimeHandler - Wi-Fi not connected. Cannot sync time.");
+    LOG_WARN("Wi-Fi not connected. Cannot sync time.");
     return false;
   }
 
-  Serial.println("TimeHandler - Configuring time synchronization settings...");
+  LOG_DEBUG("Configuring time synchronization settings...");
 
   sntp_set_time_sync_notification_cb(timeAvailable);
   sntp_set_sync_mode(SNTP_SYNC_MODE_IMMED);
@@ -42,23 +44,21 @@ bool TimeHandler::syncRealTimeClock() {
 
   configTime(GMT_OFFSET_SEC, DAYLIGHT_OFFSET_SEC, NTP_SERVER);
 
-  Serial.println("TimeHandler - Synchronizing time with NTP server...");
+  LOG_INFO("Synchronizing time with NTP server...");
 
   int retryCount = 0;
 
-  struct tm timeinfo;
-
   while (!TIME_SYNCED && retryCount < RETRIES) {
-    Serial.printf("TimeHandler - Not synchronized yet. Retrying %d/%d ...\n", retryCount + 1, RETRIES);
+    LOG_DEBUG("Not synchronized yet. Retrying %d/%d ...", retryCount + 1, RETRIES);
     delay(1000);  // Wait 1000ms before retrying
     retryCount++;
   }
 
   if (retryCount >= RETRIES) {
-    Serial.println("TimeHandler - Failed to synchronize time with NTP server. Proceeding without it.");
+    LOG_WARN("Failed to synchronize time with NTP server. Proceeding without it.");
     return false;
   } else {
-    Serial.println("TimeHandler - Time synchronized successfully.");
+    LOG_INFO("Time synchronized successfully.");
     printLocalTime();
     return true;
   }
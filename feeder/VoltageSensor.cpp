@@ -1,72 +1,98 @@
 #include "VoltageSensor.h"
 #include "AnalogUtils.h"
+#include "EnergyModel.h"
 #include "Messages.h"
+#include "WakeProfiler.h"
+#include "Log.h"
 
-VoltageSensor::VoltageSensor(int pin)
-  : pin(pin) {}
+const LogModule LOG_MODULE = LogModule::Voltage;
+const int OVERSAMPLING = 64;  // a few milliseconds of conversions
+const float DIVIDER_RATIO = 5.0;
+const uint32_t BATTERY_READING_MAGIC = 0x42415431;  // "BAT1"
+// What the board draws while the voltage is measured, and the cell and contact resistance it flows through
+const float REST_LOAD_MA = 28;
+const float CELL_RESISTANCE_OHM = 0.1;
+// Above this the feeder runs from USB without a cell; below it the sense wire is off
+const float MAX_CELL_VOLTAGE = 4.40;
+const float MIN_CELL_VOLTAGE = 2.50;
 
-float VoltageSensor::readRawVoltage() {
-  const int attempts = 10;                  // Number of attempts
-  const int readingsPerAttempt = 10;         // Number of readings per attempt
-  const int delayBetweenAttemptsMs = 1000;  // Delay between attempts in milliseconds
+struct DischargePoint {
+  float volts;
+  float stateOfCharge;
+};
 
-  float totalVoltage = 0;
+// Open-circuit voltage of a typical 18650 cell, interpolated between the points
+const DischargePoint DISCHARGE_CURVE[] = {
+  { 3.00, 0.00 }, { 3.30, 0.05 }, { 3.50, 0.10 }, { 3.60, 0.20 }, { 3.68, 0.30 }, { 3.74, 0.40 },
+  { 3.79, 0.50 }, { 3.85, 0.60 }, { 3.92, 0.70 }, { 4.00, 0.80 }, { 4.08, 0.90 }, { 4.18, 1.00 },
+};
+const size_t DISCHARGE_POINTS = sizeof(DISCHARGE_CURVE) / sizeof(DISCHARGE_CURVE[0]);
 
-  for (int attempt = 0; attempt < attempts; ++attempt) {
-    float attemptVoltage = 0;
+// Resting battery voltage, measured once per wake before any load comes up
+struct BatteryReading {
+  uint32_t magic;
+  uint16_t milliVolts;
+};
 
-    // Perform multiple readings for accuracy during this attempt
-    for (int reading = 0; reading < readingsPerAttempt; ++reading) {
-      int adcValue = AnalogUtils::readValue(pin);
-      float adcVoltage = ((float)adcValue / 4095.0) * 3.3;
-      attemptVoltage += adcVoltage * 5.0;
-    }
+RTC_DATA_ATTR static BatteryReading batteryReading = { 0, 0 };
 
-    // Average the readings for this attempt
-    attemptVoltage /= readingsPerAttempt;
-    totalVoltage += attemptVoltage;
+VoltageSensor::VoltageSensor(int pin)
+  : pin(pin) {}
 
-    delay(delayBetweenAttemptsMs);
-  }
+float VoltageSensor::readRawVoltage() {
+  WakeProfiler::Scope profile(WakePhase::BatteryRead);
+  float pinMilliVolts = AnalogUtils::readMilliVolts(pin, OVERSAMPLING);
+  return pinMilliVolts * DIVIDER_RATIO / 1000.0;
+}
 
-  // Return the average voltage across all attempts
-  return totalVoltage / attempts;
+void VoltageSensor::measureAtRest() {
+  float voltage = readRawVoltage();
+  batteryReading.magic = BATTERY_READING_MAGIC;
+  batteryReading.milliVolts = voltage * 1000 + 0.5;
+  LOG_INFO("Battery at rest: %.3f V", voltage);
 }
 
 float VoltageSensor::readVoltage() {
-  return readRawVoltage();
+  if (batteryReading.magic != BATTERY_READING_MAGIC) {
+    measureAtRest();
+  }
+  return batteryReading.milliVolts / 1000.0;
 }
 
-int VoltageSensor::getBatteryPercentage(float batteryVoltage) {
+float VoltageSensor::openCircuitVoltage() {
+  return readVoltage() + REST_LOAD_MA / 1000 * CELL_RESISTANCE_OHM;
+}
 
-  if (batteryVoltage >= 4.40) return 0;
-  else if (batteryVoltage >= 4.20) return 100;
-  else if (batteryVoltage >= 4.12) return 95;
-  else if (batteryVoltage >= 4.05) return 90;
-  else if (batteryVoltage >= 4.00) return 85;
-  else if (batteryVoltage >= 3.95) return 80;
-  else if (batteryVoltage >= 3.90) return 75;
-  else if (batteryVoltage >= 3.85) return 70;
-  else if (batteryVoltage >= 3.82) return 65;
-  else if (batteryVoltage >= 3.78) return 60;
-  else if (batteryVoltage >= 3.74) return 55;
-  else if (batteryVoltage >= 3.70) return 50;
-  else if (batteryVoltage >= 3.65) return 45;
-  else if (batteryVoltage >= 3.60) return 40;
-  else if (batteryVoltage >= 3.55) return 35;
-  else if (batteryVoltage >= 3.50) return 30;
-  else if (batteryVoltage >= 3.45) return 25;
-  else if (batteryVoltage >= 3.40) return 20;
-  else if (batteryVoltage >= 3.20) return 15;
-  else if (batteryVoltage >= 3.00) return 10;
-  else if (batteryVoltage >= 2.50) return 5;
-  else return 0;
+float VoltageSensor::stateOfCharge(float openCircuitVoltage) {
+  if (openCircuitVoltage >= MAX_CELL_VOLTAGE || openCircuitVoltage < MIN_CELL_VOLTAGE) {
+    return NAN;
+  }
+
+  if (openCircuitVoltage < DISCHARGE_CURVE[0].volts) {
+    return 0;
+  }
+  for (size_t i = 1; i < DISCHARGE_POINTS; i++) {
+    const DischargePoint& high = DISCHARGE_CURVE[i];
+    if (openCircuitVoltage < high.volts) {
+      const DischargePoint& low = DISCHARGE_CURVE[i - 1];
+      return low.stateOfCharge + (openCircuitVoltage - low.volts) / (high.volts - low.volts) * (high.stateOfCharge - low.stateOfCharge);
+    }
+  }
+  return 1;
 }
 
-String VoltageSensor::getVoltageInfoMessage() {
-  float voltage = readVoltage();
-  int percentage = getBatteryPercentage(voltage);
+size_t VoltageSensor::formatVoltageInfo(char* buffer, size_t size) {
+  // The count of the energy model, corrected by the voltage over many wakes
+  int percentage = EnergyModel::stateOfChargePercent();
+  int daysLeft = EnergyModel::daysLeft();
+  MessageArg volts = MessageArg::milliVolts(lround(readVoltage() * 1000));
 
-  String percentageStr = (percentage != 0) ? String(percentage) + "%" : MESSAGE_UNKNOWN;
-  return MESSAGE_BATTERY_PERCENTAGE + " - " + percentageStr + " (" + String(voltage) + " V)";
+  if (percentage < 0) {
+    return MessageFormatter::format(buffer, size, Message::BatteryLevelUnknown, { volts });
+  }
+  if (daysLeft < 0) {
+    return MessageFormatter::format(buffer, size, Message::BatteryLevel, { MessageArg::percent(percentage), volts });
+  }
+  return MessageFormatter::format(buffer, size, Message::BatteryForecast,
+                                  { MessageArg::percent(percentage), volts, MessageArg::number(daysLeft) });
 }
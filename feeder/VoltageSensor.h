@@ -12,9 +12,17 @@ private:
 public:
   VoltageSensor(int pin);
 
+  // Measures while nothing but the CPU draws current. Call early in the wake,
+  // before Wi-Fi or the motor come up; later reads return this value.
+  void measureAtRest();
+
   float readVoltage();
-  int getBatteryPercentage(float batteryVoltage);
-  String getVoltageInfoMessage();
+  // The resting voltage with the drop across the cell resistance added back
+  float openCircuitVoltage();
+  // Fraction of the charge left by the discharge curve, NAN outside the range of a cell
+  static float stateOfCharge(float openCircuitVoltage);
+  // Writes the battery level line for the report; returns its length
+  size_t formatVoltageInfo(char* buffer, size_t size);
 };
 
 #endif
@@ -0,0 +1,153 @@
+#include "WakeProfiler.h"
+
+const uint32_t PROFILE_MAGIC = 0x50524F31;  // "PRO1"
+const size_t PROFILE_CAPACITY = 16;
+const size_t MAX_SCOPE_DEPTH = 8;
+const size_t PHASE_COUNT = (size_t)WakePhase::Count;
+const char* const PHASE_NAMES[PHASE_COUNT] = {
+  "Boot", "RTC read", "NVS", "Wi-Fi connect", "NTP sync", "Weight read",
+  "Battery read", "Motor", "Telegram", "Portal", "Sleep delay", "Other"
+};
+
+struct WakeProfile {
+  uint32_t phaseMs[PHASE_COUNT];
+  bool feeding;
+};
+
+// The last wakes, oldest overwritten first
+struct WakeProfileRing {
+  uint32_t magic;
+  uint32_t wakes;
+  uint32_t feedingWakes;
+  WakeProfile entries[PROFILE_CAPACITY];
+};
+
+RTC_DATA_ATTR static WakeProfileRing ring = {};
+
+// The wake in progress; RAM is enough as it is committed before deep sleep
+static uint32_t currentUs[PHASE_COUNT];
+static WakePhase scopes[MAX_SCOPE_DEPTH];
+static size_t depth = 0;
+static size_t skippedScopes = 0;
+static unsigned long markUs = 0;
+static bool running = false;
+
+static void charge() {
+  unsigned long now = micros();
+  WakePhase phase = depth > 0 ? scopes[depth - 1] : WakePhase::Other;
+  currentUs[(size_t)phase] += now - markUs;
+  markUs = now;
+}
+
+void WakeProfiler::begin() {
+  if (ring.magic != PROFILE_MAGIC) {
+    ring = {};
+    ring.magic = PROFILE_MAGIC;
+  }
+
+  memset(currentUs, 0, sizeof(currentUs));
+  depth = 0;
+  skippedScopes = 0;
+  markUs = micros();
+  currentUs[(size_t)WakePhase::Boot] = markUs;
+  running = true;
+}
+
+void WakeProfiler::end(bool feeding) {
+  if (!running) {
+    return;
+  }
+  charge();
+  running = false;
+
+  WakeProfile& entry = ring.entries[ring.wakes % PROFILE_CAPACITY];
+  for (size_t i = 0; i < PHASE_COUNT; i++) {
+    entry.phaseMs[i] = (currentUs[i] + 500) / 1000;
+  }
+  entry.feeding = feeding;
+  ring.wakes++;
+  if (feeding) {
+    ring.feedingWakes++;
+  }
+}
+
+uint32_t WakeProfiler::wakeCount() {
+  return ring.magic == PROFILE_MAGIC ? ring.wakes : 0;
+}
+
+uint32_t WakeProfiler::feedingWakeCount() {
+  return ring.magic == PROFILE_MAGIC ? ring.feedingWakes : 0;
+}
+
+uint32_t WakeProfiler::lastWakeMs(WakePhase phase) {
+  if (wakeCount() == 0) {
+    return 0;
+  }
+  return ring.entries[(ring.wakes - 1) % PROFILE_CAPACITY].phaseMs[(size_t)phase];
+}
+
+String WakeProfiler::summary() {
+  size_t count = min((size_t)wakeCount(), PROFILE_CAPACITY);
+  if (count == 0) {
+    return "Wake profile: no wakes recorded yet.";
+  }
+
+  uint64_t totals[PHASE_COUNT] = {};
+  uint64_t awakeMs = 0;
+  size_t feeding = 0;
+  for (size_t i = 0; i < count; i++) {
+    const WakeProfile& entry = ring.entries[i];
+    for (size_t phase = 0; phase < PHASE_COUNT; phase++) {
+      totals[phase] += entry.phaseMs[phase];
+      awakeMs += entry.phaseMs[phase];
+    }
+    if (entry.feeding) {
+      feeding++;
+    }
+  }
+
+  String text = "Wake profile, last " + String(count) + " wakes (" + String(feeding) + " feeding), "
+                + String((uint32_t)(awakeMs / count)) + " ms awake on average:";
+  for (size_t phase = 0; phase < PHASE_COUNT; phase++) {
+    if (totals[phase] == 0) {
+      continue;
+    }
+    text += "\n" + String(PHASE_NAMES[phase]) + ": " + String((uint32_t)(totals[phase] / count)) + " ms ("
+            + String((uint32_t)(totals[phase] * 100 / awakeMs)) + "%)";
+  }
+  return text;
+}
+
+void WakeProfiler::enter(WakePhase phase) {
+  if (!running) {
+    return;
+  }
+  if (depth == MAX_SCOPE_DEPTH) {
+    skippedScopes++;
+    return;
+  }
+  charge();
+  scopes[depth++] = phase;
+}
+
+void WakeProfiler::leave() {
+  if (!running) {
+    return;
+  }
+  if (skippedScopes > 0) {
+    skippedScopes--;
+    return;
+  }
+  if (depth > 0) {
+    charge();
+    depth--;
+  }
+}
+
+WakeProfiler::Scope::Scope(WakePhase phase) {
+  enter(phase);
+}
+
+WakeProfiler::Scope::~Scope() {
+  leave();
+}
@@ -0,0 +1,63 @@
+#ifndef WAKE_PROFILER_H
+#define WAKE_PROFILER_H
+
+#include <Arduino.h>
+
+// Parts of a wake the profiler tells apart. Time outside any of them is Other.
+enum class WakePhase : uint8_t {
+  Boot,
+  RtcRead,
+  Nvs,
+  WiFiConnect,
+  NtpSync,
+  WeightRead,
+  BatteryRead,
+  MotorCycle,
+  TelegramSend,
+  Portal,
+  SleepDelay,
+  Other,
+  Count
+};
+
+// Set to N > 0 to append the profile summary to the report of every Nth feeding.
+#ifndef WAKE_PROFILER_REPORT_EVERY
+#define WAKE_PROFILER_REPORT_EVERY 0
+#endif
+
+// Measures how long each phase of a wake takes. The current wake is accumulated
+// in RAM and committed to a ring of the last wakes in RTC memory right before
+// deep sleep, so the history survives until the next power loss.
+class WakeProfiler {
+public:
+  // Call first thing in setup(); the time since reset counts as Boot.
+  static void begin();
+
+  // Closes the wake and stores it in the ring. Call right before esp_deep_sleep_start().
+  static void end(bool feeding);
+
+  // Wakes recorded since the last power loss, including those overwritten in the ring.
+  static uint32_t wakeCount();
+  static uint32_t feedingWakeCount();
+
+  // Time spent in a phase during the wake closed last by end(), 0 if there is none.
+  static uint32_t lastWakeMs(WakePhase phase);
+
+  // Average time per phase over the wakes in the ring, one line per phase.
+  static String summary();
+
+  // Charges the time it is alive to a phase. Scopes nest; the innermost one wins.
+  class Scope {
+  public:
+    explicit Scope(WakePhase phase);
+    ~Scope();
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+  };
+
+private:
+  static void enter(WakePhase phase);
+  static void leave();
+};
+
+#endif
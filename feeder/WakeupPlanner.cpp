@@ -0,0 +1,99 @@
+#include "WakeupPlanner.h"
+#include "ScheduleHandler.h"
+#include "Log.h"
+
+const LogModule LOG_MODULE = LogModule::Wakeup;
+const uint32_t CALIBRATION_MAGIC = 0x57414B31;  // "WAK1"
+const int MIN_SAMPLE_SLEEP_S = 1800;            // shorter sleeps are dominated by the 1 s DS1302 resolution
+const float MAX_RATE_ERROR = 0.1;               // anything further off means the DS1302 was reset
+const float RATE_SMOOTHING = 0.25;
+const int MIN_LEAD_S = 2;
+const int DEVIATION_MARGIN = 3;
+const int MAX_LEAD_S = TOLERANCE / 2;
+
+struct WakeupCalibration {
+  uint32_t magic;
+  float rate;            // DS1302 seconds per second requested from the sleep timer
+  float deviationPpm;    // mean absolute error of single measurements against rate
+  uint16_t samples;
+  uint32_t latencyMs;    // boot to DS1302 read, measured on the last wake
+  int64_t sleepStartMs;  // DS1302 time the last sleep started, 0 if unknown
+  uint64_t requestedUs;
+};
+
+RTC_DATA_ATTR static WakeupCalibration calibration = { 0, 1.0, 0, 0, 0, 0, 0 };
+
+static int64_t referenceMs = 0;
+static unsigned long referenceMillis = 0;
+
+static void resetIfInvalid() {
+  if (calibration.magic != CALIBRATION_MAGIC) {
+    calibration = { CALIBRATION_MAGIC, 1.0, 0, 0, 0, 0, 0 };
+  }
+}
+
+void WakeupPlanner::begin(time_t now) {
+  resetIfInvalid();
+
+  unsigned long sinceBoot = millis();
+  calibration.latencyMs = sinceBoot;
+  updateReference(now);
+
+  if (calibration.sleepStartMs == 0 || calibration.requestedUs < (uint64_t)MIN_SAMPLE_SLEEP_S * 1000000) {
+    calibration.sleepStartMs = 0;
+    return;
+  }
+
+  int64_t sleptMs = (int64_t)now * 1000 - (int64_t)sinceBoot - calibration.sleepStartMs;
+  float measured = sleptMs / (calibration.requestedUs / 1000.0);
+  calibration.sleepStartMs = 0;
+
+  if (fabs(measured - 1.0) > MAX_RATE_ERROR) {
+    LOG_WARN("Implausible sleep measurement ignored: rate %.6f", measured);
+    return;
+  }
+
+  if (calibration.samples == 0) {
+    calibration.rate = measured;
+    calibration.deviationPpm = 0;
+  } else {
+    float errorPpm = fabs(measured - calibration.rate) * 1e6;
+    calibration.rate += RATE_SMOOTHING * (measured - calibration.rate);
+    calibration.deviationPpm += RATE_SMOOTHING * (errorPpm - calibration.deviationPpm);
+  }
+  if (calibration.samples < UINT16_MAX) {
+    calibration.samples++;
+  }
+
+  LOG_INFO("Sleep timer rate %.6f, deviation %.0f ppm after %u samples", calibration.rate, calibration.deviationPpm, calibration.samples);
+}
+
+void WakeupPlanner::updateReference(time_t now) {
+  referenceMs = (int64_t)now * 1000;
+  referenceMillis = millis();
+}
+
+bool WakeupPlanner::isCalibrated() {
+  return calibration.magic == CALIBRATION_MAGIC && calibration.samples > 0;
+}
+
+uint64_t WakeupPlanner::sleepDurationUs(time_t wakeupTime, uint32_t startDelayMs) {
+  resetIfInvalid();
+
+  int64_t nowMs = referenceMs + (int64_t)(millis() - referenceMillis) + startDelayMs;
+  int64_t sleepMs = (int64_t)wakeupTime * 1000 - nowMs - calibration.latencyMs;
+  float rate = 1.0;
+
+  if (isCalibrated()) {
+    float uncertaintyS = DEVIATION_MARGIN * calibration.deviationPpm * (sleepMs / 1000.0) / 1e6;
+    int64_t leadMs = (int64_t)(constrain(MIN_LEAD_S + uncertaintyS, (float)MIN_LEAD_S, (float)MAX_LEAD_S) * 1000);
+    sleepMs -= leadMs;
+    rate = calibration.rate;
+    LOG_INFO("Waking up %ld s early to absorb timer jitter", (long)(leadMs / 1000));
+  }
+
+  sleepMs = max(sleepMs, (int64_t)1000);
+  calibration.sleepStartMs = nowMs;
+  calibration.requestedUs = (uint64_t)(sleepMs * 1000 / rate);
+  return calibration.requestedUs;
+}
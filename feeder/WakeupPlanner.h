@@ -0,0 +1,26 @@
+#ifndef WAKEUP_PLANNER_H
+#define WAKEUP_PLANNER_H
+
+#include <Arduino.h>
+#include <time.h>
+
+// Turns a wakeup time on the DS1302 clock into a deep sleep duration. The ESP32
+// sleep timer runs on an inaccurate RC oscillator, so every timer wakeup is
+// compared against the DS1302 and the learned rate is kept in RTC memory.
+class WakeupPlanner {
+public:
+  // Call with the DS1302 time read right after waking up.
+  static void begin(time_t now);
+
+  // Call after the DS1302 was set, so the next measurement is not skewed.
+  static void updateReference(time_t now);
+
+  // True once the sleep timer rate has been measured since the last power loss.
+  static bool isCalibrated();
+
+  // Sleep duration that makes the next DS1302 reading land just before wakeupTime,
+  // for a sleep that starts startDelayMs from now.
+  static uint64_t sleepDurationUs(time_t wakeupTime, uint32_t startDelayMs);
+};
+
+#endif
@@ -1,39 +1,154 @@
 #include "WeightSensor.h"
 #include "UsedPins.h"
 #include "Messages.h"
+#include "PowerPolicy.h"
+#include "WakeProfiler.h"
+#include "Log.h"
+#include <algorithm>
 #include <cmath>
 
+const LogModule LOG_MODULE = LogModule::Weight;
+const int DATA_BITS = 24;
+const int GAIN_128_PULSES = 1;
+const size_t MEDIAN_WINDOW = 3;
+const float SMOOTHING = 0.5;
+const uint32_t CONVERSION_PERIOD_MS = 100;  // RATE pin low
+const unsigned long CONVERSION_TIMEOUT_MS = 1000;
+const uint32_t READ_POLL_MS = 10;
+
+WeightSensor* WeightSensor::sampling = nullptr;
+
 WeightSensor::WeightSensor(int dtPin, int sckPin, int scale, int offset)
-  : dtPin(dtPin), sckPin(sckPin), scale(scale), offset(offset) {
+  : dtPin(dtPin), sckPin(sckPin), scale(scale), offset(offset), head(0), tail(0), samples(0), filtered(NAN) {
+}
+
+// Shifts one conversion out of the HX711. Data bits falling on DOUT can fire the
+// interrupt again after the read, so it only reads when a conversion is ready.
+// Not in IRAM: digitalRead(), digitalWrite() and delayMicroseconds() run from flash.
+// That is only safe while the core installs its GPIO interrupts without
+// ESP_INTR_FLAG_IRAM (CONFIG_ARDUINO_ISR_IRAM off), so they are held off while flash
+// is busy, e.g. during the NVS writes of feedFood() with the interrupt attached.
+void WeightSensor::onDataReady() {
+  WeightSensor* self = sampling;
+  if (self == nullptr || digitalRead(self->dtPin) != LOW) {
+    return;
+  }
+
+  uint32_t value = 0;
+  for (int i = 0; i < DATA_BITS; i++) {
+    digitalWrite(self->sckPin, HIGH);
+    delayMicroseconds(1);
+    value = (value << 1) | digitalRead(self->dtPin);
+    digitalWrite(self->sckPin, LOW);
+    delayMicroseconds(1);
+  }
+  for (int i = 0; i < GAIN_128_PULSES; i++) {
+    digitalWrite(self->sckPin, HIGH);
+    delayMicroseconds(1);
+    digitalWrite(self->sckPin, LOW);
+    delayMicroseconds(1);
+  }
+
+  uint32_t position = self->head.load(std::memory_order_relaxed);
+  self->ring[position % RING_SIZE] = (int32_t)(value << 8) >> 8;
+  self->head.store(position + 1, std::memory_order_release);
 }
 
 void WeightSensor::begin() {
-  Serial.println("WeightSensor - Initializing sensor...");
+  LOG_DEBUG("Initializing sensor...");
   sensor.begin(dtPin, sckPin);
-  Serial.println("WeightSensor - Setting scale...");
+  LOG_DEBUG("Setting scale...");
   sensor.set_scale(scale);
-  Serial.println("WeightSensor - Setting offset...");
+  LOG_DEBUG("Setting offset...");
   sensor.set_offset(offset);
-  Serial.println("WeightSensor - Powering up sensor...");
+  LOG_DEBUG("Powering up sensor...");
   sensor.power_up();
-  Serial.println("WeightSensor - Sensor initialized");
+
+  tail = head.load(std::memory_order_acquire);
+  samples = 0;
+  filtered = NAN;
+  sampling = this;
+  attachInterrupt(digitalPinToInterrupt(dtPin), onDataReady, FALLING);
+  LOG_INFO("Sensor initialized, sampling in the background");
 }
 
 void WeightSensor::end() {
-  Serial.println("WeightSensor - Powering down sensor...");
+  LOG_DEBUG("Powering down sensor...");
+  detachInterrupt(digitalPinToInterrupt(dtPin));
+  sampling = nullptr;
   sensor.power_down();
-  Serial.println("WeightSensor - Sensor powered down");
+  LOG_INFO("Sensor powered down");
 }
 
-float WeightSensor::readWeight() {
-  Serial.println("WeightSensor - Reading weight...");
-  if (sensor.wait_ready_timeout(1000)) {
-    float weight = sensor.get_units(10);  // Get an average of 10 readings
-    Serial.print("WeightSensor - Weight read: ");
-    Serial.println(weight);
-    return weight;
-  } else {
-    Serial.println("WeightSensor - Sensor not ready, returning NAN");
-    return NAN;
+// Moves everything the interrupt produced since the last call through the filters
+void WeightSensor::drain() {
+  uint32_t position = head.load(std::memory_order_acquire);
+  if (position - tail > RING_SIZE) {
+    tail = position - RING_SIZE;  // the reader fell behind, the oldest conversions are gone
+  }
+
+  while (tail != position) {
+    int32_t raw = ring[tail % RING_SIZE];
+    tail++;
+    addSample((float)(raw - offset) / scale);
   }
 }
+
+void WeightSensor::addSample(float grams) {
+  history[samples % HISTORY_SIZE] = grams;
+  samples++;
+
+  size_t count = min((size_t)samples, MEDIAN_WINDOW);
+  float window[MEDIAN_WINDOW];
+  for (size_t i = 0; i < count; i++) {
+    window[i] = history[(samples - 1 - i) % HISTORY_SIZE];
+  }
+  std::nth_element(window, window + count / 2, window + count);
+  float median = window[count / 2];
+
+  filtered = std::isnan(filtered) ? median : filtered + SMOOTHING * (median - filtered);
+}
+
+float WeightSensor::filteredWeight() {
+  drain();
+  return filtered;
+}
+
+uint32_t WeightSensor::filterDelayMs() const {
+  // Group delay of the median plus that of the IIR, in conversion periods
+  float periods = (MEDIAN_WINDOW - 1) / 2.0 + (1 - SMOOTHING) / SMOOTHING;
+  return periods * CONVERSION_PERIOD_MS;
+}
+
+float WeightSensor::readWeight(int conversions) {
+  WakeProfiler::Scope profile(WakePhase::WeightRead);
+  LOG_DEBUG("Reading weight...");
+  conversions = constrain(PowerPolicy::weightConversions(conversions), 1, (int)HISTORY_SIZE);
+
+  drain();
+  uint32_t wanted = samples + conversions;
+  uint32_t lastCount = samples;
+  unsigned long lastConversion = millis();
+
+  while (samples < wanted) {
+    delay(READ_POLL_MS);
+    drain();
+    if (samples != lastCount) {
+      lastCount = samples;
+      lastConversion = millis();
+    } else if (millis() - lastConversion > CONVERSION_TIMEOUT_MS) {
+      LOG_WARN("Sensor not ready, returning NAN");
+      return NAN;
+    }
+  }
+
+  float window[HISTORY_SIZE];
+  for (int i = 0; i < conversions; i++) {
+    window[i] = history[(samples - 1 - i) % HISTORY_SIZE];
+  }
+  std::nth_element(window, window + conversions / 2, window + conversions);
+  float weight = window[conversions / 2];
+
+  LOG_DEBUG("Weight read: %.2f", weight);
+  return weight;
+}
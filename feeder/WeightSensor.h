@@ -2,20 +2,50 @@
 #define WEIGHT_SENSOR_H
 
 #include <Arduino.h>
+#include <atomic>
 #include "HX711.h"
 
+// Load cell behind an HX711. While the sensor is on, every conversion is read from
+// the DOUT data-ready interrupt into a lock-free ring, so the weight is available at
+// any time, also while the motor runs. Readers run the samples through a short
+// median (against motor vibration spikes) followed by an IIR low-pass.
 class WeightSensor {
 private:
+  static const size_t RING_SIZE = 32;  // 3 s of conversions at 10 Hz
+  static const size_t HISTORY_SIZE = 16;
+
   int dtPin;
   int sckPin;
   int scale;
   int offset;
   HX711 sensor;
 
+  // Written by the interrupt only
+  int32_t ring[RING_SIZE];
+  std::atomic<uint32_t> head;
+  // Owned by the reader
+  uint32_t tail;
+  uint32_t samples;
+  float history[HISTORY_SIZE];
+  float filtered;
+
+  static WeightSensor* sampling;
+  static void onDataReady();
+
+  void drain();
+  void addSample(float grams);
+
 public:
   WeightSensor(int dtPin, int sckPin, int scale, int offset);
 
-  float readWeight();
+  // Waits for the given number of fresh conversions and returns their median, NAN on timeout.
+  float readWeight(int conversions = 10);
+
+  // Latest filtered weight, NAN before the first conversion. Never blocks.
+  float filteredWeight();
+
+  // How far the filtered weight lags behind a steadily changing load.
+  uint32_t filterDelayMs() const;
 
   void begin();
 
@@ -1,11 +1,15 @@
 #include "WiFiManagerWrapper.h"
 #include "PreferencesHandler.h"
+#include <WiFi.h>
 #include <WiFiManager.h>
 #include "CollectionUtils.h"
 #include <vector>
 #include "TelegramHandler.h"
 #include "Messages.h"
+#include "WakeProfiler.h"
+#include "Log.h"
 
+const LogModule LOG_MODULE = LogModule::WiFi;
 const char* const DEFAULT_AP_NAME = "PetFeeder";
 const char* const DEFAULT_AP_PASSWORD = "11111111";
 const char* const TELEGRAM_BOT_TOKEN_KEY = "botToken";
@@ -15,28 +19,141 @@ const char* const FEEDING_PORTION_WEIGHT_KEY = "feedingPortionWeight";
 const char* const FEEDING_BOWL_WEIGHT_KEY = "feedingBowlWeight";
 const int CONFIG_PORTAL_TIMEOUT_S = 300;
 
+const uint32_t FAST_CONNECT_MAGIC = 0x57494631;  // "WIF1"
+const unsigned long FAST_CONNECT_TIMEOUT_MS = 3000;
+const uint16_t FAST_CONNECTS_PER_LEASE = 48;  // renew the address through DHCP every so often so a stale lease cannot linger
+
+// Access point and address of the last successful connection, so the next wake can skip
+// the channel scan and the DHCP exchange, also after a reset. The password stays in the
+// Wi-Fi driver's own storage.
+struct FastConnectCache {
+  uint32_t magic;
+  bool valid;
+  char ssid[33];
+  uint8_t bssid[6];
+  int32_t channel;
+  uint32_t ip;
+  uint32_t gateway;
+  uint32_t subnet;
+  uint32_t dns;
+  uint16_t connectsSinceDhcp;
+  uint32_t fastConnects;
+  uint32_t fastConnectMs;
+  uint32_t fullConnects;
+  uint32_t fullConnectMs;
+};
+
+RTC_NOINIT_ATTR static FastConnectCache fastConnectCache;
+
+static void resetIfInvalid() {
+  // Random after a power loss
+  if (fastConnectCache.magic != FAST_CONNECT_MAGIC || memchr(fastConnectCache.ssid, 0, sizeof(fastConnectCache.ssid)) == nullptr) {
+    fastConnectCache = {};
+    fastConnectCache.magic = FAST_CONNECT_MAGIC;
+  }
+}
+
+static void rememberConnection(bool usedDhcp) {
+  uint8_t* bssid = WiFi.BSSID();
+  String ssid = WiFi.SSID();
+  if (bssid == nullptr || ssid.isEmpty() || ssid.length() >= sizeof(fastConnectCache.ssid)) {
+    fastConnectCache.valid = false;
+    return;
+  }
+
+  fastConnectCache.valid = true;
+  strncpy(fastConnectCache.ssid, ssid.c_str(), sizeof(fastConnectCache.ssid) - 1);
+  memcpy(fastConnectCache.bssid, bssid, sizeof(fastConnectCache.bssid));
+  fastConnectCache.channel = WiFi.channel();
+  fastConnectCache.ip = (uint32_t)WiFi.localIP();
+  fastConnectCache.gateway = (uint32_t)WiFi.gatewayIP();
+  fastConnectCache.subnet = (uint32_t)WiFi.subnetMask();
+  fastConnectCache.dns = (uint32_t)WiFi.dnsIP();
+  if (usedDhcp) {
+    fastConnectCache.connectsSinceDhcp = 0;
+  }
+}
+
+// Joins the cached access point on its known channel, reusing the cached address unless the lease is due
+static bool fastConnectWiFi() {
+  if (!fastConnectCache.valid) {
+    return false;
+  }
+
+  bool renewLease = fastConnectCache.connectsSinceDhcp >= FAST_CONNECTS_PER_LEASE;
+  WiFi.mode(WIFI_STA);
+  if (renewLease) {
+    WiFi.config(IPAddress(), IPAddress(), IPAddress());
+  } else {
+    WiFi.config(IPAddress(fastConnectCache.ip), IPAddress(fastConnectCache.gateway), IPAddress(fastConnectCache.subnet), IPAddress(fastConnectCache.dns));
+  }
+
+  String password = WiFi.psk();
+  WiFi.begin(fastConnectCache.ssid, password.c_str(), fastConnectCache.channel, fastConnectCache.bssid);
+  if (WiFi.waitForConnectResult(FAST_CONNECT_TIMEOUT_MS) != WL_CONNECTED) {
+    LOG_WARN("Fast connect failed, falling back to a full connect.");
+    WiFi.disconnect();
+    WiFi.config(IPAddress(), IPAddress(), IPAddress());
+    fastConnectCache.valid = false;
+    return false;
+  }
+
+  fastConnectCache.connectsSinceDhcp++;
+  rememberConnection(renewLease);
+  return true;
+}
+
+static void reportLatency(bool fast, unsigned long elapsedMs) {
+  if (fast) {
+    fastConnectCache.fastConnects++;
+    fastConnectCache.fastConnectMs += elapsedMs;
+  } else {
+    fastConnectCache.fullConnects++;
+    fastConnectCache.fullConnectMs += elapsedMs;
+  }
+
+  unsigned long fastAverageMs = fastConnectCache.fastConnects > 0 ? fastConnectCache.fastConnectMs / fastConnectCache.fastConnects : 0;
+  unsigned long fullAverageMs = fastConnectCache.fullConnects > 0 ? fastConnectCache.fullConnectMs / fastConnectCache.fullConnects : 0;
+  if (fast) {
+    LOG_INFO("Connected in %lu ms (fast connect). Average fast: %lu ms, full: %lu ms.", elapsedMs, fastAverageMs, fullAverageMs);
+  } else {
+    LOG_INFO("Connected in %lu ms (full connect). Average fast: %lu ms, full: %lu ms.", elapsedMs, fastAverageMs, fullAverageMs);
+  }
+}
+
 void WiFiManagerWrapper::autoConnectWiFi() {
-  Serial.println("WiFiManagerWrapper - Attempting to auto-connect to WiFi");
+  WakeProfiler::Scope profile(WakePhase::WiFiConnect);
+  LOG_INFO("Attempting to auto-connect to WiFi");
+  unsigned long start = millis();
+  resetIfInvalid();
+
+  if (fastConnectWiFi()) {
+    reportLatency(true, millis() - start);
+    return;
+  }
+
   WiFiManager wm;
   wm.setConfigPortalTimeout(1);
 
   int retries = 0;
   while (retries < 10) {
     if (wm.autoConnect()) {
-      Serial.println("WiFiManagerWrapper - Auto-connect successful.");
+      LOG_INFO("Auto-connect successful.");
+      rememberConnection(true);
+      reportLatency(false, millis() - start);
       return;  // Exit if connection is successful
     } else {
       retries++;
-      Serial.print("WiFiManagerWrapper - Auto-connect failed. Retry ");
-      Serial.print(retries);
-      Serial.println(" of 10.");
+      LOG_WARN("Auto-connect failed. Retry %d of 10.", retries);
     }
   }
-  Serial.println("WiFiManagerWrapper - Auto-connect failed after 10 retries. Check WiFi settings.");
+  LOG_ERROR("Auto-connect failed after 10 retries. Check WiFi settings.");
 }
 
 void WiFiManagerWrapper::setupWiFiManager(TelegramHandler& telegramHandler) {
-  Serial.println("WiFiManagerWrapper - Setting up WiFiManager");
+  LOG_INFO("Setting up WiFiManager");
+  resetIfInvalid();
+  fastConnectCache.valid = false;  // the portal may switch to another network
 
   bool success = false;
 
@@ -50,28 +167,24 @@ void WiFiManagerWrapper::setupWiFiManager(TelegramHandler& telegramHandler) {
     wm.setBreakAfterConfig(true);
 
     // Retrieve stored preferences for bot token and group ID
-    Serial.println("WiFiManagerWrapper - Retrieving stored preferences");
+    LOG_INFO("Retrieving stored preferences");
     String botToken = PreferencesHandler::getBotToken();
     String groupId = PreferencesHandler::getGroupId();
     String feedingSchedule = CollectionUtils::joinVector(PreferencesHandler::getFeedingSchedule());
     int feedingWeightPerPortion = PreferencesHandler::getFeedingWeightPerPortion();
     int feedingBowlWeight = PreferencesHandler::getFeedingBowlWeight();
 
-    Serial.println("WiFiManagerWrapper - Retrieved bot token: " + botToken);
-    Serial.println("WiFiManagerWrapper - Retrieved group ID: " + groupId);
-    Serial.println("WiFiManagerWrapper - Retrieved feeding schedule: " + feedingSchedule);
-    Serial.println("WiFiManagerWrapper - Retrieved feeding weight per portion: " + String(feedingWeightPerPortion));
-    Serial.println("WiFiManagerWrapper - Retrieved feeding bowl weight: " + String(feedingBowlWeight));
+    LOG_DEBUG("Retrieved feeding weight per portion %d g, bowl weight %d g", feedingWeightPerPortion, feedingBowlWeight);
 
     // Add custom parameters for WiFiManager
-    Serial.println("WiFiManagerWrapper - Adding custom parameters to WiFiManager");
+    LOG_INFO("Adding custom parameters to WiFiManager");
     WiFiManagerParameter custom_bot_token(TELEGRAM_BOT_TOKEN_KEY, "Telegram Bot Token", botToken.c_str(), 64);
     WiFiManagerParameter custom_group_id(TELEGRAM_GROUP_ID_KEY, "Telegram Group ID", groupId.c_str(), 20);
     WiFiManagerParameter custom_feeding_schedule(FEEDING_SCHEDULE_KEY, "Feeding schedule UTC (ex. 10:00,15:00,20:00). Asc order, min period between feedings - 2 hours", feedingSchedule.c_str(), 70);
     WiFiManagerParameter custom_feeding_portion_weight(FEEDING_PORTION_WEIGHT_KEY, "Feeding portion weight in grams", String(feedingWeightPerPortion).c_str(), 4);
     WiFiManagerParameter custom_feeding_bowl_weight(FEEDING_BOWL_WEIGHT_KEY, "Feeding bowl weight in grams", String(feedingBowlWeight).c_str(), 4);
 
-    Serial.println("WiFiManagerWrapper - Custom parameters added to WiFiManager");
+    LOG_INFO("Custom parameters added to WiFiManager");
 
     wm.addParameter(&custom_bot_token);
     wm.addParameter(&custom_group_id);
@@ -80,15 +193,20 @@ void WiFiManagerWrapper::setupWiFiManager(TelegramHandler& telegramHandler) {
     wm.addParameter(&custom_feeding_bowl_weight);
 
     // Start WiFi configuration portal
-    Serial.println("WiFiManagerWrapper - Starting configuration portal");
-    if (!wm.startConfigPortal(DEFAULT_AP_NAME, DEFAULT_AP_PASSWORD)) {
-      Serial.println("WiFiManagerWrapper - Failed to connect or configure. Continuing with existing settings.");
+    LOG_INFO("Starting configuration portal");
+    bool configured;
+    {
+      WakeProfiler::Scope profile(WakePhase::Portal);
+      configured = wm.startConfigPortal(DEFAULT_AP_NAME, DEFAULT_AP_PASSWORD);
+    }
+    if (!configured) {
+      LOG_WARN("Failed to connect or configure. Continuing with existing settings.");
     } else {
-      Serial.println("WiFiManagerWrapper - WiFi configuration completed successfully.");
+      LOG_INFO("WiFi configuration completed successfully.");
     }
 
     // Save updated preferences
-    Serial.println("WiFiManagerWrapper - Saving updated preferences");
+    LOG_INFO("Saving updated preferences");
 
     autoConnectWiFi();
 
@@ -96,46 +214,46 @@ void WiFiManagerWrapper::setupWiFiManager(TelegramHandler& telegramHandler) {
 
     if (!PreferencesHandler::saveBotToken(custom_bot_token.getValue())) {
       success = false;
-      Serial.println("WiFiManagerWrapper - Bot token not valid or not set.");
-      telegramHandler.sendBotMessage(MESSAGE_SETTINGS_INVALID_BOT_TOKEN);
+      LOG_WARN("Bot token not valid or not set.");
+      telegramHandler.sendBotMessage(Message::SettingsInvalidBotToken);
     } else {
-      Serial.println("WiFiManagerWrapper - Bot token saved successfully.");
+      LOG_INFO("Bot token saved successfully.");
     }
 
     if (!PreferencesHandler::saveGroupId(custom_group_id.getValue())) {
       success = false;
-      Serial.println("WiFiManagerWrapper - Group id not valid or not set.");
-      telegramHandler.sendBotMessage(MESSAGE_SETTINGS_INVALID_BOT_GROUP_ID);
+      LOG_WARN("Group id not valid or not set.");
+      telegramHandler.sendBotMessage(Message::SettingsInvalidGroupId);
     } else {
-      Serial.println("WiFiManagerWrapper - Group id saved successfully.");
+      LOG_INFO("Group id saved successfully.");
     }
 
     telegramHandler.begin(PreferencesHandler::getBotToken(), PreferencesHandler::getGroupId());
 
     if (!PreferencesHandler::saveFeedingSchedule(custom_feeding_schedule.getValue())) {
       success = false;
-      Serial.println("WiFiManagerWrapper - Feeding schedule not valid or not set.");
-      telegramHandler.sendBotMessage(MESSAGE_SETTINGS_INVALID_SCHEDULING);
+      LOG_WARN("Feeding schedule not valid or not set.");
+      telegramHandler.sendBotMessage(Message::SettingsInvalidScheduling);
     } else {
-      Serial.println("WiFiManagerWrapper - Feeding schedule saved successfully.");
+      LOG_INFO("Feeding schedule saved successfully.");
     }
 
     if (!PreferencesHandler::saveFeedingWeightPerPortion(custom_feeding_portion_weight.getValue())) {
       success = false;
-      Serial.println("WiFiManagerWrapper - Feeding weight not valid or not set.");
-      telegramHandler.sendBotMessage(MESSAGE_SETTINGS_INVALID_PORTION_WEIGHT);
+      LOG_WARN("Feeding weight not valid or not set.");
+      telegramHandler.sendBotMessage(Message::SettingsInvalidPortionWeight);
     } else {
-      Serial.println("WiFiManagerWrapper - Feeding weight per portion saved successfully.");
+      LOG_INFO("Feeding weight per portion saved successfully.");
     }
 
     if (!PreferencesHandler::saveFeedingBowlWeight(custom_feeding_bowl_weight.getValue())) {
       success = false;
-      Serial.println("WiFiManagerWrapper - Feeding bowl weight not valid or not set.");
-      telegramHandler.sendBotMessage(MESSAGE_SETTINGS_INVALID_BOWL_WEIGHT);
+      LOG_WARN("Feeding bowl weight not valid or not set.");
+      telegramHandler.sendBotMessage(Message::SettingsInvalidBowlWeight);
     } else {
-      Serial.println("WiFiManagerWrapper - Feeding bowl weight saved successfully.");
+      LOG_INFO("Feeding bowl weight saved successfully.");
     }
   }
 
-  Serial.println("WiFiManagerWrapper - Preferences saved");
+  LOG_INFO("Preferences saved");
 }
@@ -7,13 +7,31 @@
 #include "VoltageSensor.h"
 #include "WeightSensor.h"
 #include "DCMotor.h"
+#include "DispenseController.h"
+#include "EnergyModel.h"
+#include "JamDetector.h"
+#include "FeedingJournal.h"
+#include "FeedingState.h"
+#include "PowerPolicy.h"
+#include "Log.h"
 #include "Messages.h"
 #include "RtcModule.h"
+#include "WakeupPlanner.h"
+#include "WakeProfiler.h"
 #include "UsedPins.h"
 #include <cmath>
 
+const LogModule LOG_MODULE = LogModule::Main;
+
+// Set to 1 to print the log records of every wake to Serial right before deep sleep
+#ifndef LOG_DUMP_BEFORE_SLEEP
+#define LOG_DUMP_BEFORE_SLEEP 0
+#endif
+
 // Persistent variables
-RTC_DATA_ATTR bool initialSetupDone = false;
+// Kept over resets, so a brownout does not bring the setup portal back; a power loss clears it
+const uint32_t INITIAL_SETUP_DONE = 0x53455455;  // "SETU"
+RTC_NOINIT_ATTR uint32_t initialSetupDone;
 
 TelegramHandler telegramHandler;
 RtcModule rtcModule(RTC_MODULE_DAT_PIN, RTC_MODULE_CLK_PIN, RTC_MODULE_RST_PIN, telegramHandler);
@@ -21,186 +39,432 @@ VoltageSensor voltageSensor(VOLTAGE_SENSOR_PIN);
 WeightSensor weightSensor(LOADCELL_DOUT_PIN, LOADCELL_SCK_PIN, 1106, -62230);
 DCMotor dcMotor(MOTOR_IN1_PIN, MOTOR_IN2_PIN, MOTOR_STBY_PIN);
 
+void queueVoltageInfo() {
+  char message[MESSAGE_BUFFER_SIZE];
+  voltageSensor.formatVoltageInfo(message, sizeof(message));
+  telegramHandler.queueMessage(message);
+}
+
+// Says once what the feeder gives up, or takes up again, at the new charge level
+void queuePowerTierInfo() {
+  const Message TIER_MESSAGES[(size_t)PowerTier::Count] = { Message::PowerNormal, Message::PowerSaving, Message::PowerLow,
+                                                            Message::PowerCritical };
+  PowerTier tier = PowerPolicy::tier();
+  int threshold = PowerPolicy::threshold(tier == PowerTier::Normal ? PowerTier::Saving : tier);
+  telegramHandler.queueMessage(TIER_MESSAGES[(size_t)tier], { MessageArg::percent(threshold) });
+}
+
 // Setup function
 void setup() {
-  Serial.begin(115200);
-  delay(1000);  // Allow Serial to stabilize
-  Serial.println("Main - Device is waking up...");
+  WakeProfiler::begin();
+  Log::begin();
+  FeedingState::begin();
+  {
+    WakeProfiler::Scope profile(WakePhase::Boot);
+    Serial.begin(115200);
+    if (LOG_SERIAL_LEVEL != LogLevel::None) {
+      delay(1000);  // Allow the serial monitor to attach before the records printed as they happen
+    }
+  }
+  voltageSensor.measureAtRest();
+  EnergyModel::begin(VoltageSensor::stateOfCharge(voltageSensor.openCircuitVoltage()));
+  LOG_INFO("Device is waking up...");
 
   telegramHandler.begin(PreferencesHandler::getBotToken(), PreferencesHandler::getGroupId());
+  if (PowerPolicy::begin(EnergyModel::stateOfChargePercent())) {
+    queuePowerTierInfo();
+  }
   rtcModule.begin();
 
-  if (!initialSetupDone) {
-    Serial.println("Main - Initial setup not done. Launching WiFiManager...");
+  if (initialSetupDone != INITIAL_SETUP_DONE) {
+    LOG_INFO("Initial setup not done. Launching WiFiManager...");
 
     WiFiManagerWrapper::setupWiFiManager(telegramHandler);
-    Serial.println("Main - WiFiManager setup completed.");
+    LOG_INFO("WiFiManager setup completed.");
 
     WiFiManagerWrapper::autoConnectWiFi();
-    Serial.println("Main - WiFi connection attempt executed.");
+    LOG_INFO("WiFi connection attempt executed.");
 
     rtcModule.sync();
-    Serial.println("Main - RTC synchronization step executed.");
-
-    telegramHandler.sendBotMessage(MESSAGE_READY_TO_USE);
-    telegramHandler.sendBotMessage(
-      MESSAGE_CURRENT_SETTINGS + "\n" + MESSAGE_CURRENT_SETTINGS_SCHEDULING + PreferencesHandler::getFeedingScheduleString()
-      + "\n" + MESSAGE_CURRENT_SETTINGS_PORTION_WEIGHT + String(PreferencesHandler::getFeedingWeightPerPortion())
-      + "\n" + MESSAGE_CURRENT_SETTINGS_BOWL_WEIGHT + String(PreferencesHandler::getFeedingBowlWeight()));
-    telegramHandler.sendBotMessage(voltageSensor.getVoltageInfoMessage());
-
-    initialSetupDone = true;
-    Serial.println("Main - Initial setup completed and marked as done.");
+    LOG_INFO("RTC synchronization step executed.");
+
+    telegramHandler.queueMessage(Message::ReadyToUse);
+    String feedingSchedule = PreferencesHandler::getFeedingScheduleString();
+    telegramHandler.queueMessage(Message::CurrentSettings, { MessageArg::text(feedingSchedule.c_str()),
+                                                             MessageArg::number(PreferencesHandler::getFeedingWeightPerPortion()),
+                                                             MessageArg::number(PreferencesHandler::getFeedingBowlWeight()) });
+    queueVoltageInfo();
+    telegramHandler.flushMessages();
+
+    initialSetupDone = INITIAL_SETUP_DONE;
+    LOG_INFO("Initial setup completed and marked as done.");
   } else {
-    Serial.println("Main - Initial setup already done. Skipping.");
+    LOG_INFO("Initial setup already done. Skipping.");
   }
 }
 
-void goToDeepSleep(uint64_t seconds) {
-  Serial.println("Main - Going to deep sleep for " + String(seconds) + " seconds...");
-  delay(5000);                                       // For serial
-  esp_sleep_enable_timer_wakeup(seconds * 1000000);  // Convert seconds to microseconds
+void goToDeepSleep(time_t wakeupTime, bool feeding) {
+  if (feeding) {
+    FeedingState::enter(FeedingStep::Sleeping);
+  }
+  telegramHandler.end();
+  uint64_t sleepUs = WakeupPlanner::sleepDurationUs(wakeupTime, 0);
+  LOG_INFO("Going to deep sleep for %u seconds...", (uint32_t)(sleepUs / 1000000));
+  {
+    // Only what was printed has to leave the UART before the clocks stop
+    WakeProfiler::Scope profile(WakePhase::SleepDelay);
+    if (LOG_SERIAL_LEVEL != LogLevel::None) {
+      Serial.println(WakeProfiler::summary());
+      Serial.println(EnergyModel::summary());
+    }
+    if (LOG_DUMP_BEFORE_SLEEP) {
+      Log::dump(Serial);
+    }
+    Serial.flush();
+  }
+  WakeProfiler::end(feeding);
+  EnergyModel::endWake(sleepUs);
+  esp_sleep_enable_timer_wakeup(sleepUs);
   esp_deep_sleep_start();
 }
 
-int feedFood(int weightToFeed, int currentWeight) {
-  Serial.println("Main - Starting food feeding process...");
-  int previousWeight = currentWeight;
+int feedFood(int weightToFeed, int currentWeight, FeedingRecord& record) {
+  LOG_INFO("Starting food feeding process...");
+  const uint32_t reversePulseMs = 150;
+  const uint32_t spinDownMs = 50;  // lets the auger slow down before it is reversed
+  const uint32_t pulsePollMs = 10;
+  const uint32_t settleMs = 300;
+  const int settledConversions = 5;
+
+  int targetWeight = currentWeight + weightToFeed;
   int newWeight = -1;
+  float lastWeight = currentWeight;
   float newWeightFloat = -1;
-  unsigned long lastWeightChangeTime = millis();
+
+  DispenseCalibration saved = PreferencesHandler::getDispenseCalibration();
+  DispenseController controller(saved);
+  JamDetector jamDetector;
+  uint32_t motorBudgetMs = controller.motorBudgetMs(weightToFeed);
 
   bool weightSensorError = false;
-  bool noWeightChangeError = false;
+  bool motorTimeLimit = false;
   bool success = false;
 
   while (true) {
-    dcMotor.startMotor(false);
-    delay(300);
-    dcMotor.startMotor(true);
-    delay(150);
-    dcMotor.stopMotor();
-    delay(1000);
+    const MotorProfile& motorProfile = controller.nextProfile(targetWeight - lastWeight);
+    uint32_t pulseMs = max(controller.nextPulseMs(targetWeight - lastWeight, motorProfile), jamDetector.minPulseMs());
+    uint32_t forwardMs;
+    {
+      WakeProfiler::Scope profile(WakePhase::MotorCycle);
+
+      uint32_t antiJamMs = jamDetector.antiJamReverseMs();
+      if (antiJamMs > 0) {
+        dcMotor.startMotor(true, MOTOR_PROFILE_RETRACT);
+        delay(antiJamMs);
+        dcMotor.stopMotor();
+      }
 
-    newWeightFloat = weightSensor.readWeight();
+      // Rate at the cruise duty of this pulse
+      float rate = controller.current().gramsPerSecond * motorProfile.cruiseDuty / 100;
+      uint32_t filterDelayMs = weightSensor.filterDelayMs();
+
+      float startWeight = weightSensor.filteredWeight();
+
+      unsigned long pulseStart = millis();
+      dcMotor.startMotor(false, motorProfile);
+      while (millis() - pulseStart < pulseMs) {
+        // Food already dispensed during this pulse that the filter does not show yet
+        uint32_t elapsedMs = millis() - pulseStart;
+        float lagGrams = std::isnan(rate) ? 0 : rate * min(elapsedMs, filterDelayMs) / 1000;
+        float dispensed = weightSensor.filteredWeight() - startWeight;
+        if (!std::isnan(dispensed) && lastWeight + dispensed + lagGrams >= targetWeight) {
+          LOG_INFO("Target weight crossed during the pulse.");
+          break;
+        }
+        delay(pulsePollMs);
+      }
+      dcMotor.stopMotor();
+      forwardMs = dcMotor.fullSpeedMs();
+      pulseMs = millis() - pulseStart;
+
+      delay(spinDownMs);
+      dcMotor.startMotor(true, MOTOR_PROFILE_RETRACT);
+      delay(reversePulseMs);
+      dcMotor.stopMotor();
+      delay(settleMs);
+    }
+
+    newWeightFloat = weightSensor.readWeight(settledConversions);
 
     if (std::isnan(newWeightFloat)) {
-      Serial.println("Main - Error: Weight sensor not ready.");
+      LOG_ERROR("Weight sensor not ready.");
       weightSensorError = true;
       break;
     } else {
       newWeight = floor(newWeightFloat);
     }
 
-    if (newWeight > previousWeight + 2) {
-      lastWeightChangeTime = millis();
-      previousWeight = newWeight;
-      Serial.println("Main - Weight increased. Updated previous weight: " + String(previousWeight));
+    // What the pulse should have moved by the rate learned before it
+    float expectedGrams = controller.current().gramsPerSecond * forwardMs / 1000;
+    controller.update(forwardMs, pulseMs + reversePulseMs, newWeightFloat - lastWeight);
+    jamDetector.update(expectedGrams, newWeightFloat - lastWeight);
+    lastWeight = newWeightFloat;
+    LOG_DEBUG("Pulse of %u ms, %u ms at full speed, dispense rate estimate: %.2f g/s", pulseMs, forwardMs,
+              controller.current().gramsPerSecond);
+
+    if (newWeight >= targetWeight) {
+      LOG_INFO("Stopping motor: Target weight reached.");
+      success = true;
+      break;
     }
 
-    if (millis() - lastWeightChangeTime > 300000) {
-      Serial.println("Main - Stopping motor: No significant weight increase in the last 300 seconds.");
-      noWeightChangeError = true;
+    if (jamDetector.fault() != DispenseFault::None) {
+      LOG_WARN("Stopping motor: No food is coming out.");
       break;
     }
 
-    if (newWeight >= currentWeight + weightToFeed) {
-      Serial.println("Main - Stopping motor: Target weight reached.");
-      success = true;
+    if (controller.motorTimeMs() >= motorBudgetMs) {
+      LOG_WARN("Stopping motor: %u ms of motor time used, %d g still missing.", controller.motorTimeMs(), targetWeight - newWeight);
+      motorTimeLimit = true;
       break;
     }
   }
 
+  // Rewrite the calibration only when it moved noticeably, to spare the flash
+  const DispenseCalibration& learned = controller.current();
+  if (!std::isnan(learned.gramsPerSecond)
+      && (std::isnan(saved.gramsPerSecond) || fabs(learned.gramsPerSecond - saved.gramsPerSecond) > saved.gramsPerSecond * 0.1
+          || std::isnan(saved.spread) || fabs(learned.spread - saved.spread) > 0.1)) {
+    PreferencesHandler::saveDispenseCalibration(learned);
+  }
+
+  // Added up over the attempts of a feeding that resets cut short
+  record.pulses += controller.iterations();
+  record.unansweredPulses += jamDetector.unanswered();
+  record.antiJamRuns += jamDetector.antiJamRuns();
+
+  int overshoot = max(0, newWeight - targetWeight);
+  if (PowerPolicy::detailedReports()) {
+    telegramHandler.queueMessage(Message::FeedingStats, { MessageArg::number(controller.iterations()),
+                                                         MessageArg::milliseconds(controller.motorTimeMs()), MessageArg::grams(overshoot) });
+  }
+
   if (weightSensorError) {
-    telegramHandler.sendBotMessage(MESSAGE_WEIGHT_ERROR + MESSAGE_FEEDING_STOPPED);
+    record.result = FeedingResult::WeightSensorError;
+    telegramHandler.queueMessage(Message::WeightErrorFeedingStopped);
     return -1;
   }
 
-  if (noWeightChangeError) {
-    telegramHandler.sendBotMessage(MESSAGE_FEEDING_NO_WEIGHT_CHANGE);
+  if (jamDetector.fault() == DispenseFault::Jammed) {
+    record.result = FeedingResult::Jammed;
+    telegramHandler.queueMessage(Message::FeedingJammed);
+  } else if (jamDetector.fault() == DispenseFault::HopperEmpty) {
+    record.result = FeedingResult::HopperEmpty;
+    telegramHandler.queueMessage(Message::FeedingHopperEmpty);
+  } else if (motorTimeLimit) {
+    record.result = FeedingResult::MotorTimeLimit;
+    telegramHandler.queueMessage(Message::FeedingMotorTimeLimit);
   }
 
   if (success) {
-    telegramHandler.sendBotMessage(MESSAGE_FEEDING_SUCCESS);
+    telegramHandler.queueMessage(Message::FeedingSuccess);
   }
 
   return newWeight;
 }
 
-void startFeeding(time_t feedingTime) {
-  Serial.println("Main - Feeding time! Activating feeder...");
-  weightSensor.begin();
-  dcMotor.begin();
-
-  WiFiManagerWrapper::autoConnectWiFi();
-  Serial.println("Main - WiFi connection attempt executed.");
-
-  telegramHandler.sendBotMessage(voltageSensor.getVoltageInfoMessage());
-  telegramHandler.sendBotMessage(MESSAGE_TIME_TO_FEED);
-
+// Reads the bowl and decides whether to dispense. Enters Dispensing with the target set, or leaves the
+// step as it is when no food is needed.
+void weighBowl(FeedingProgress& progress, int weightPerPortion) {
+  FeedingRecord& record = progress.record;
   int bowlWeight = PreferencesHandler::getFeedingBowlWeight();
-  int weightPerPortion = PreferencesHandler::getFeedingWeightPerPortion();
   float initialWeightFloat = weightSensor.readWeight();
 
   if (std::isnan(initialWeightFloat)) {
-    Serial.println("Main - Error: Weight sensor not ready.");
-    telegramHandler.sendBotMessage(MESSAGE_WEIGHT_ERROR + MESSAGE_FEEDING_MISSED);
-  } else {
-    int initialWeight = floor(initialWeightFloat);
-    int adjustedWeight = max(0, initialWeight - bowlWeight);
+    LOG_ERROR("Weight sensor not ready.");
+    telegramHandler.queueMessage(Message::WeightErrorFeedingMissed);
+    record.result = FeedingResult::WeightSensorError;
+    return;
+  }
 
-    if (initialWeight < bowlWeight / 2) {
-      Serial.println("Main - No bowl. Feeding will not be executed.");
-      telegramHandler.sendBotMessage(MESSAGE_NO_BOWL);
-    } else {
-      Serial.println("Main - Current weight of food: " + String(adjustedWeight));
-      telegramHandler.sendBotMessage("Вес еды в миске: " + String(adjustedWeight) + " " + MESSAGE_GRAMM);
+  int initialWeight = floor(initialWeightFloat);
+  int adjustedWeight = max(0, initialWeight - bowlWeight);
+  record.startWeight = adjustedWeight;
+  record.endWeight = adjustedWeight;
 
-      int weightToFeed = weightPerPortion - adjustedWeight;
+  if (initialWeight < bowlWeight / 2) {
+    LOG_WARN("No bowl. Feeding will not be executed.");
+    telegramHandler.queueMessage(Message::FeedingNoBowl);
+    record.result = FeedingResult::NoBowl;
+    return;
+  }
+
+  LOG_INFO("Current weight of food: %d", adjustedWeight);
+  if (PowerPolicy::detailedReports()) {
+    telegramHandler.queueMessage(Message::FoodInBowl, { MessageArg::grams(adjustedWeight) });
+  }
+
+  int weightToFeed = weightPerPortion - adjustedWeight;
+  if (weightToFeed <= 0) {
+    LOG_INFO("Current weight of food is enough. Feeding will be skipped.");
+    telegramHandler.queueMessage(Message::FeedingEnoughFood);
+    record.result = FeedingResult::EnoughFood;
+    return;
+  }
+
+  LOG_INFO("Need to add the following amount of food (in grams): %d", weightToFeed);
+  if (PowerPolicy::detailedReports()) {
+    telegramHandler.queueMessage(Message::FeedingStart, { MessageArg::grams(weightToFeed) });
+  }
+  progress.checkpoint.initialWeight = initialWeight;
+  progress.checkpoint.targetWeight = initialWeight + weightToFeed;
+  progress.checkpoint.startWeight = adjustedWeight;
+  FeedingState::enter(FeedingStep::Dispensing);
+}
+
+// Dispenses up to the target of the checkpoint, also when a reset cut an earlier attempt short.
+void dispense(FeedingProgress& progress) {
+  const FeedingCheckpoint& checkpoint = progress.checkpoint;
+  FeedingRecord& record = progress.record;
+  int currentWeight = checkpoint.initialWeight;
+
+  if (progress.resets > 0) {
+    LOG_INFO("Resuming dispensing up to %d g on the scale", checkpoint.targetWeight);
+    telegramHandler.queueMessage(Message::FeedingResumed);
+    float weight = weightSensor.readWeight();
+    if (std::isnan(weight)) {
+      LOG_ERROR("Weight sensor not ready.");
+      telegramHandler.queueMessage(Message::WeightErrorFeedingStopped);
+      record.result = FeedingResult::WeightSensorError;
+      return;
+    }
+    currentWeight = floor(weight);
+  }
 
-      if (weightToFeed <= 0) {
-        Serial.println("Main - Current weight of food is enough. Feeding will be skipped.");
-        telegramHandler.sendBotMessage(MESSAGE_FEEDING_ENOUGH_FOOD);
-      } else {
-        Serial.println("Main - Need to add the following amount of food (in grams): " + String(weightToFeed));
-        telegramHandler.sendBotMessage(MESSAGE_FEEDING_START + String(weightToFeed) + " " + MESSAGE_GRAMM);
+  int newWeight = currentWeight;
+  if (currentWeight < checkpoint.targetWeight) {
+    newWeight = feedFood(checkpoint.targetWeight - currentWeight, currentWeight, record);
+  } else {
+    LOG_INFO("Target weight reached before the reset.");
+    telegramHandler.queueMessage(Message::FeedingSuccess);
+  }
 
-        int newWeight = feedFood(weightToFeed, initialWeight);
+  if (newWeight != -1) {
+    int foodInBowl = newWeight - checkpoint.initialWeight + checkpoint.startWeight;
+    record.endWeight = foodInBowl;
+    record.dispensedGrams = max(0, newWeight - checkpoint.initialWeight);
+    telegramHandler.queueMessage(Message::FoodInBowl, { MessageArg::grams(foodInBowl) });
+  }
+}
+
+// Runs the feeding from the step it is at: a new one from Weighing, one cut short by a
+// reset from where it stopped. Every step is persisted before the next one starts.
+void runFeeding() {
+  FeedingProgress& progress = FeedingState::current();
+  FeedingRecord& record = progress.record;
 
-        if (newWeight != -1) {
-          telegramHandler.sendBotMessage("Вес еды в миске: " + String(newWeight - initialWeight + adjustedWeight) + " " + MESSAGE_GRAMM);
+  if (progress.step == FeedingStep::Weighing || progress.step == FeedingStep::Dispensing) {
+    unsigned long feedingStart = millis();
+
+    if (record.result == FeedingResult::Interrupted) {
+      telegramHandler.queueMessage(Message::FeedingInterrupted);
+    } else {
+      LOG_INFO("Feeding time! Activating feeder...");
+      weightSensor.begin();
+      dcMotor.begin();
+
+      if (progress.step == FeedingStep::Weighing) {
+        // Notifications are collected during the feeding and sent as one report at the end. Saving
+        // power, the report of a day's feedings is sent at once, a line or two for each.
+        if (progress.resets == 0 && PowerPolicy::detailedReports()) {
+          telegramHandler.queueMessage(Message::TimeToFeed);
+          queueVoltageInfo();
+        } else if (progress.resets == 0) {
+          telegramHandler.queueMessage(Message::FeedingAt, { MessageArg::time(record.slotTime) });
         }
+        record.batteryMilliVolts = static_cast<uint16_t>(voltageSensor.readVoltage() * 1000);
+        weighBowl(progress, progress.portionGrams);
       }
+      if (progress.step == FeedingStep::Dispensing) {
+        dispense(progress);
+      }
+
+      weightSensor.end();
+      dcMotor.end();
+      LOG_INFO("Feeding process completed and hardware turned off.");
     }
+
+    record.durationMs += millis() - feedingStart;
+    if (!FeedingJournal::append(record)) {
+      // Without the journal the slot must still be marked as fed
+      PreferencesHandler::saveLastFeedingTime(record.slotTime);
+    }
+    LOG_INFO("Last feeding time saved.");
+    FeedingState::enter(FeedingStep::Connecting);
+  }
+
+  time_t slotTime = progress.checkpoint.slotTime;
+  if (!PowerPolicy::reportDue(slotTime)) {
+    LOG_INFO("Report kept for the daily one to save power.");
+    return;
+  }
+
+  if (progress.step == FeedingStep::Connecting) {
+    WiFiManagerWrapper::autoConnectWiFi();
+    LOG_INFO("WiFi connection attempt executed.");
+    FeedingState::enter(FeedingStep::Reporting);
   }
 
-  PreferencesHandler::saveLastFeedingTime(feedingTime);
-  Serial.println("Main - Last feeding time saved.");
+#if WAKE_PROFILER_REPORT_EVERY > 0
+  // This wake is only counted by WakeProfiler::end(), at the end of the wake
+  if ((WakeProfiler::feedingWakeCount() + 1) % WAKE_PROFILER_REPORT_EVERY == 0) {
+    telegramHandler.queueMessage(WakeProfiler::summary());
+  }
+#endif
 
-  weightSensor.end();
-  dcMotor.end();
-  Serial.println("Main - Feeding process completed and hardware turned off.");
+  if (!PowerPolicy::detailedReports()) {
+    queueVoltageInfo();
+  }
+  if (telegramHandler.flushMessages()) {
+    PowerPolicy::reported(slotTime);
+  }
 }
 
 // Main loop
 void loop() {
-  Serial.println("Main - Checking schedule for feeding time...");
+  LOG_INFO("Checking schedule for feeding time...");
   time_t now = rtcModule.getCurrentTime();
-
-  std::vector<time_t> feedingTimes = ScheduleHandler::parseFeedingSchedule(now);
-  time_t feedingTime = ScheduleHandler::shouldFeedNow(feedingTimes, now);
+  WakeupPlanner::begin(now);
+
+  FeedingSchedule schedule = PreferencesHandler::getFeedingSlots();
+  // The NVS key is only written when the journal is unavailable, or before it existed
+  time_t lastFeedingTime = max(FeedingJournal::lastSlotTime(), PreferencesHandler::getLastFeedingTime());
+  FeedingSlot slot = {};
+  time_t feedingTime;
+  if (FeedingState::resume(now, lastFeedingTime)) {
+    feedingTime = FeedingState::current().checkpoint.slotTime;
+    LOG_WARN("Resuming the feeding of %t cut short by a reset.", (uint32_t)feedingTime);
+  } else {
+    feedingTime = ScheduleHandler::shouldFeedNow(schedule, now, lastFeedingTime, slot);
+    if (feedingTime != 0) {
+      FeedingState::start(feedingTime, slot.portionGrams);
+    }
+  }
 
   bool feedNow = feedingTime != 0;
 
-  time_t nextWakeup = ScheduleHandler::calculateNextWakeup(feedingTimes, now, feedNow);
+  time_t nextWakeup = ScheduleHandler::calculateNextWakeup(schedule, now, feedNow);
 
   if (feedNow) {
-    Serial.println("Main - Feeding time detected. Starting feeding process...");
-    startFeeding(feedingTime);
-    rtcModule.sync();
+    LOG_INFO("Feeding time detected. Starting feeding process...");
+    runFeeding();
+    if (PowerPolicy::clockSyncDue(WiFi.status() == WL_CONNECTED)) {
+      rtcModule.sync();
+      WakeupPlanner::updateReference(rtcModule.getCurrentTime());
+    }
   } else {
-    Serial.println("Main - Not feeding time yet. Next wakeup scheduled.");
+    LOG_INFO("Not feeding time yet. Next wakeup scheduled.");
   }
 
-  goToDeepSleep(nextWakeup - now);
+  goToDeepSleep(nextWakeup, feedNow);
 }
@@ -0,0 +1,35 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+#pragma once
+
+#include <stdio.h>
+#include <chrono>
+
+namespace benchmark {
+
+// Runs f() until it took at least 100 ms, and returns the time per call.
+template <typename TFunction>
+double nanosecondsPerRun(TFunction f) {
+  using clock = std::chrono::steady_clock;
+  size_t runs = 0;
+  auto start = clock::now();
+  auto elapsed = clock::duration::zero();
+  do {
+    f();
+    runs++;
+    elapsed = clock::now() - start;
+  } while (elapsed < std::chrono::milliseconds(100));
+  return double(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed)
+                    .count()) /
+         double(runs);
+}
+
+// Prevents the compiler from optimizing away a result
+template <typename T>
+void doNotOptimize(const T& value) {
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+}  // namespace benchmark
@@ -0,0 +1,68 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+// Compares the throughput of deserializeJson() on documents made of numbers,
+// with and without ARDUINOJSON_EXACT_FLOAT_PARSING.
+
+#include <ArduinoJson.h>
+
+#include <stdio.h>
+#include <string>
+
+#include "Benchmark.hpp"
+
+namespace {
+
+// An array of 1000 numbers printed with printf("%.*<style>", precision)
+std::string makeNumbers(char style, int precision) {
+  std::string json = "[";
+  uint32_t seed = 1;
+  char buffer[32];
+  for (int i = 0; i < 1000; i++) {
+    seed = seed * 1103515245 + 12345;
+    double x = (seed >> 8) / 16777216.0 * 1000;  // [0, 1000)
+    if (style == 'e')
+      snprintf(buffer, sizeof(buffer), "%.*e", precision, x);
+    else if (style == 'f')
+      snprintf(buffer, sizeof(buffer), "%.*f", precision, x);
+    else
+      snprintf(buffer, sizeof(buffer), "%.*g", precision, x);
+    if (i)
+      json += ",";
+    json += buffer;
+  }
+  json += "]";
+  return json;
+}
+
+void runCases() {
+  struct {
+    const char* name;
+    char style;
+    int precision;
+  } kinds[] = {
+      {"weights", 'f', 2},
+      {"coordinates", 'f', 7},
+      {"full doubles", 'g', 17},
+      {"exponents", 'e', 6},
+  };
+
+  printf("%14s %12s %16s\n", "numbers", "MB/s", "Mnumbers/s");
+
+  for (auto& kind : kinds) {
+    auto json = makeNumbers(kind.style, kind.precision);
+    JsonDocument doc;
+
+    double ns = benchmark::nanosecondsPerRun([&]() {
+      benchmark::doNotOptimize(deserializeJson(doc, json.c_str()));
+    });
+
+    // bytes per nanosecond, times 1000 = MB/s
+    printf("%14s %12.1f %16.1f\n", kind.name, double(json.size()) / ns * 1000,
+           1000 / ns * 1000);
+  }
+  printf("\n");
+}
+
+}  // namespace
@@ -0,0 +1,54 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+// Compares the throughput of deserializeJson() on documents made of strings,
+// with and without ARDUINOJSON_FAST_STRING_SCAN.
+
+#include <ArduinoJson.h>
+
+#include <string>
+
+#include "Benchmark.hpp"
+
+namespace {
+
+// An array of messages, like the text of a getUpdates answer
+std::string makeMessages(size_t length) {
+  std::string text;
+  while (text.size() < length)
+    text += "Feeding done: 25 g at 08:00, next at 12:00. ";
+  text.resize(length);
+  std::string json = "[";
+  for (int i = 0; i < 20; i++) {
+    if (i)
+      json += ",";
+    json += "{\"text\":\"" + text + "\\n\"}";
+  }
+  json += "]";
+  return json;
+}
+
+void runCases() {
+  printf("%8s %16s %16s\n", "length", "char* (MB/s)", "size (MB/s)");
+
+  for (size_t length = 10; length <= 1000; length *= 10) {
+    auto json = makeMessages(length);
+    JsonDocument doc;
+
+    double zeroTerminated = benchmark::nanosecondsPerRun([&]() {
+      benchmark::doNotOptimize(deserializeJson(doc, json.c_str()));
+    });
+    double sized = benchmark::nanosecondsPerRun([&]() {
+      benchmark::doNotOptimize(deserializeJson(doc, json.data(), json.size()));
+    });
+
+    // bytes per nanosecond, times 1000 = MB/s
+    printf("%8zu %16.1f %16.1f\n", length,
+           double(json.size()) / zeroTerminated * 1000,
+           double(json.size()) / sized * 1000);
+  }
+  printf("\n");
+}
+
+}  // namespace
@@ -0,0 +1,15 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+// Runs the cases of a feature benchmark with the feature off, then on.
+// See add_feature_benchmark() in CMakeLists.txt.
+
+void runBenchmark0();
+void runBenchmark1();
+
+int main() {
+  runBenchmark0();
+  runBenchmark1();
+  return 0;
+}
@@ -0,0 +1,60 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+// Compares the cost of parsing objects and looking up their members,
+// with and without ARDUINOJSON_OBJECT_KEY_INDEX.
+
+#include <ArduinoJson.h>
+
+#include <string>
+#include <vector>
+
+#include "Benchmark.hpp"
+
+namespace {
+
+std::string makeObject(size_t n) {
+  std::string json = "{";
+  for (size_t i = 0; i < n; i++) {
+    if (i)
+      json += ",";
+    json += "\"field" + std::to_string(i) + "\":" + std::to_string(i);
+  }
+  json += "}";
+  return json;
+}
+
+// A dozen keys spread over the object, like a program that reads a few
+// fields of a wide API answer
+std::vector<std::string> makeLookups(size_t n) {
+  std::vector<std::string> keys;
+  for (size_t i = 0; i < 12; i++)
+    keys.push_back("field" + std::to_string(i * n / 12));
+  return keys;
+}
+
+void runCases() {
+  printf("%8s %16s %18s\n", "members", "parse (ns/key)", "12 lookups (ns)");
+
+  for (size_t n = 10; n <= 10000; n *= 10) {
+    auto json = makeObject(n);
+    auto lookups = makeLookups(n);
+    JsonDocument doc;
+
+    double parse = benchmark::nanosecondsPerRun(
+        [&]() { benchmark::doNotOptimize(deserializeJson(doc, json)); });
+
+    deserializeJson(doc, json);
+    JsonObjectConst obj = doc.as<JsonObjectConst>();
+    double lookup = benchmark::nanosecondsPerRun([&]() {
+      for (auto& key : lookups)
+        benchmark::doNotOptimize(obj[key].as<int>());
+    });
+
+    printf("%8zu %16.1f %18.1f\n", n, parse / double(n), lookup);
+  }
+  printf("\n");
+}
+
+}  // namespace
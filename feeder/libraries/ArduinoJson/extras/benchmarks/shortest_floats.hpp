@@ -0,0 +1,65 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+// Compares the throughput of serializeJson() on documents made of numbers,
+// with and without ARDUINOJSON_SHORTEST_FLOATS.
+
+#define ARDUINOJSON_USE_DOUBLE 1
+#include <ArduinoJson.h>
+
+#include <stdio.h>
+#include <string>
+
+#include "Benchmark.hpp"
+
+namespace {
+
+// An array of 1000 numbers in [0, 1000), rounded to the given number of
+// decimal places, or not rounded at all if decimals is negative
+void makeNumbers(JsonDocument& doc, int decimals) {
+  uint32_t seed = 1;
+  for (int i = 0; i < 1000; i++) {
+    seed = seed * 1103515245 + 12345;
+    double x = (seed >> 8) / 16777216.0 * 1000;
+    if (decimals >= 0) {
+      double scale = 1;
+      for (int j = 0; j < decimals; j++)
+        scale *= 10;
+      x = double(uint32_t(x * scale)) / scale;
+    }
+    doc.add(x);
+  }
+}
+
+void runCases() {
+  struct {
+    const char* name;
+    int decimals;
+  } kinds[] = {
+      {"weights", 2},
+      {"coordinates", 7},
+      {"full doubles", -1},
+  };
+
+  printf("%14s %12s %16s\n", "numbers", "MB/s", "Mnumbers/s");
+
+  for (auto& kind : kinds) {
+    JsonDocument doc;
+    makeNumbers(doc, kind.decimals);
+    std::string json;
+    serializeJson(doc, json);
+
+    double ns = benchmark::nanosecondsPerRun([&]() {
+      json.clear();
+      benchmark::doNotOptimize(serializeJson(doc, json));
+    });
+
+    // bytes per nanosecond, times 1000 = MB/s
+    printf("%14s %12.1f %16.1f\n", kind.name, double(json.size()) / ns * 1000,
+           1000 / ns * 1000);
+  }
+  printf("\n");
+}
+
+}  // namespace
@@ -0,0 +1,61 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+// Compares the cost of adding and finding strings in the StringPool,
+// with and without ARDUINOJSON_STRING_POOL_INDEX.
+
+#include <ArduinoJson.h>
+
+#include <string>
+#include <vector>
+
+#include "Benchmark.hpp"
+
+namespace {
+
+using namespace ArduinoJson::detail;
+
+std::vector<std::string> makeKeys(size_t n) {
+  std::vector<std::string> keys;
+  for (size_t i = 0; i < n; i++)
+    keys.push_back("key" + std::to_string(i));
+  return keys;
+}
+
+void runCases() {
+  printf("%8s %12s %12s %14s\n", "strings", "add (ns)", "get (ns)",
+         "overhead (B)");
+
+  for (size_t n = 10; n <= 10000; n *= 10) {
+    auto keys = makeKeys(n);
+    ResourceManager resources;
+
+    double add = benchmark::nanosecondsPerRun([&]() {
+      for (auto& key : keys)
+        resources.saveString(adaptString(key));
+      resources.clear();
+    });
+
+    size_t chars = 0;
+    for (auto& key : keys) {
+      resources.saveString(adaptString(key));
+      chars += key.size() + 1;
+    }
+
+    double get = benchmark::nanosecondsPerRun([&]() {
+      for (auto& key : keys)
+        benchmark::doNotOptimize(resources.getString(adaptString(key)));
+    });
+
+    // Bytes per string on top of the characters: the node header, plus the
+    // table when the pool is indexed
+    double overhead = double(resources.size() - chars) / double(n);
+
+    printf("%8zu %12.1f %12.1f %14.1f\n", n, add / double(n), get / double(n),
+           overhead);
+  }
+  printf("\n");
+}
+
+}  // namespace
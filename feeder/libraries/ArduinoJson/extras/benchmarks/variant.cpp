@@ -0,0 +1,16 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+// Compiled once per value of the feature macro, each time with a different
+// ARDUINOJSON_VERSION_NAMESPACE. See add_feature_benchmark() in CMakeLists.txt.
+
+#include BENCHMARK_CASES
+
+#define BENCHMARK_ENTRY_(value) runBenchmark##value
+#define BENCHMARK_ENTRY(value) BENCHMARK_ENTRY_(value)
+
+void BENCHMARK_ENTRY(BENCHMARK_VALUE)() {
+  printf("%s == %d\n", BENCHMARK_FEATURE, BENCHMARK_VALUE);
+  runCases();
+}
@@ -6,6 +6,9 @@
 #include <ArduinoJson.h>
 #include <catch.hpp>
 
+#include <sstream>
+#include <string>
+
 #include "Allocators.hpp"
 
 using ArduinoJson::detail::sizeofArray;
@@ -212,3 +215,50 @@ TEST_CASE("Deduplicate keys") {
               Reallocate(sizeofPool(), sizeofArray(2) + 2 * sizeofObject(1)),
           });
 }
+
+TEST_CASE("Strings read in place match strings read from a stream") {
+  // RAM inputs are scanned a chunk at a time, streams a char at a time.
+  // Put a special char at every offset, across the chunk boundaries.
+  const char specials[] = {'"', '\'', '\\', '\n', '\x01', '\x7f', '\xc3'};
+  JsonDocument doc1, doc2, doc3;
+
+  for (size_t length = 0; length < 40; length++) {
+    for (size_t pos = 0; pos <= length; pos++) {
+      for (char special : specials) {
+        std::string content(length, 'a');
+        if (pos < length) {
+          content[pos] = special;
+          if (special == '"' || special == '\\')
+            content.insert(pos, 1, '\\');
+        }
+        std::string input = "[\"" + content + "\",{\"" + content + "\":0}]";
+        CAPTURE(input);
+
+        std::istringstream stream(input);
+        auto err1 = deserializeJson(doc1, stream);
+        auto err2 = deserializeJson(doc2, input.c_str());
+        auto err3 = deserializeJson(doc3, input.data(), input.size());
+
+        REQUIRE(err1 == DeserializationError::Ok);
+        REQUIRE(err2 == err1);
+        REQUIRE(err3 == err1);
+        REQUIRE(doc2 == doc1);
+        REQUIRE(doc3 == doc1);
+      }
+    }
+  }
+}
+
+TEST_CASE("Truncated strings read in place") {
+  JsonDocument doc;
+
+  for (size_t length = 0; length < 40; length++) {
+    std::string input = "\"" + std::string(length, 'a');
+    CAPTURE(input);
+
+    REQUIRE(deserializeJson(doc, input.data(), input.size()) ==
+            DeserializationError::IncompleteInput);
+    REQUIRE(deserializeJson(doc, input.c_str()) ==
+            DeserializationError::IncompleteInput);
+  }
+}
@@ -0,0 +1,220 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+#define ARDUINOJSON_VERSION_NAMESPACE ObjectKeyIndex
+#define ARDUINOJSON_OBJECT_KEY_INDEX 1
+#include <ArduinoJson.h>
+
+#include <catch.hpp>
+#include <string>
+
+#include "Allocators.hpp"
+#include "Literals.hpp"
+
+static const size_t threshold = ARDUINOJSON_OBJECT_KEY_INDEX_THRESHOLD;
+
+static std::string key(size_t i) {
+  return "key" + std::to_string(i);
+}
+
+static void fill(JsonObject obj, size_t n, size_t first = 0) {
+  for (size_t i = first; i < first + n; i++)
+    obj[key(i)] = i;
+}
+
+static size_t sizeofKeyIndex(size_t capacity) {
+  using ArduinoJson::detail::SlotId;
+  return capacity * (sizeof(uint32_t) + 2 * sizeof(SlotId));
+}
+
+TEST_CASE("ARDUINOJSON_OBJECT_KEY_INDEX == 1") {
+  SpyingAllocator spy;
+  JsonDocument doc(&spy);
+  JsonObject obj = doc.to<JsonObject>();
+
+  SECTION("Doesn't index a small object") {
+    fill(obj, threshold - 1);
+    spy.clearLog();
+
+    REQUIRE(obj["missing"].isNull());
+    REQUIRE(spy.log() == AllocatorLog{});
+  }
+
+  SECTION("Indexes an object when a lookup scans the threshold") {
+    fill(obj, threshold);
+    spy.clearLog();
+
+    REQUIRE(obj["missing"].isNull());
+    REQUIRE(obj["missing"].isNull());
+    REQUIRE(spy.log() == AllocatorLog{
+                             Allocate(sizeofKeyIndex(32)),
+                         });
+  }
+
+  SECTION("Finds every member of a large object") {
+    fill(obj, 1000);
+
+    for (size_t i = 0; i < 1000; i++)
+      REQUIRE(obj[key(i)] == i);
+    REQUIRE(obj["key1000"].isNull());
+    REQUIRE(obj.size() == 1000);
+  }
+
+  SECTION("Finds the members added after the index") {
+    fill(obj, threshold);
+    REQUIRE(obj["missing"].isNull());  // builds the index
+
+    obj["missing"] = "found";
+
+    REQUIRE(obj["missing"] == "found");
+    REQUIRE(obj[key(0)] == 0);
+  }
+
+  SECTION("Finds the members of a const object") {
+    fill(obj, 100);
+    JsonObjectConst cobj = obj;
+
+    REQUIRE(cobj["missing"].isNull());
+    REQUIRE(cobj["key42"] == 42);
+  }
+
+  SECTION("remove()") {
+    fill(obj, 100);
+
+    SECTION("first member") {
+      obj.remove("key0");
+
+      REQUIRE(obj["key0"].isNull());
+      REQUIRE(obj["key1"] == 1);
+      REQUIRE(obj["key99"] == 99);
+    }
+
+    SECTION("middle member") {
+      obj.remove("key50");
+
+      REQUIRE(obj["key50"].isNull());
+      REQUIRE(obj["key49"] == 49);
+      REQUIRE(obj["key51"] == 51);
+    }
+
+    SECTION("last member") {
+      obj.remove("key99");
+
+      REQUIRE(obj["key99"].isNull());
+      REQUIRE(obj["key98"] == 98);
+    }
+
+    SECTION("iterator") {
+      obj.remove(obj.begin());
+
+      REQUIRE(obj["key0"].isNull());
+      REQUIRE(obj["key1"] == 1);
+    }
+
+    SECTION("every member") {
+      for (size_t i = 0; i < 100; i++)
+        obj.remove(key(i));
+
+      REQUIRE(obj.size() == 0);
+      REQUIRE(obj["key0"].isNull());
+    }
+  }
+
+  SECTION("clear() then refill with other keys") {
+    fill(obj, 100);
+    obj.clear();
+    fill(obj, 100, 100);
+
+    REQUIRE(obj["key0"].isNull());
+    REQUIRE(obj["key150"] == 150);
+  }
+
+  SECTION("Replacing the object by an array") {
+    JsonObject nested = obj["nested"].to<JsonObject>();
+    fill(nested, 100);
+    REQUIRE(nested["missing"].isNull());  // builds the index
+
+    JsonArray array = obj["nested"].to<JsonArray>();
+    for (int i = 0; i < 100; i++)
+      array.add(i);
+    JsonObject other = obj["other"].to<JsonObject>();
+    fill(other, 100, 1000);
+
+    REQUIRE(other["key1000"] == 1000);
+    REQUIRE(other["key0"].isNull());
+  }
+
+  SECTION("Indexes nested objects separately") {
+    JsonObject a = obj["a"].to<JsonObject>();
+    JsonObject b = obj["b"].to<JsonObject>();
+    for (size_t i = 0; i < 50; i++) {
+      a[key(i)] = "a";
+      b[key(i)] = "b";
+    }
+
+    REQUIRE(a["key7"] == "a");
+    REQUIRE(b["key7"] == "b");
+  }
+
+  SECTION("Survives shrinkToFit()") {
+    fill(obj, 100);
+    doc.shrinkToFit();
+
+    REQUIRE(obj["key42"] == 42);
+    REQUIRE(obj["missing"].isNull());
+  }
+
+  SECTION("Survives swapping documents") {
+    fill(obj, 100);
+    JsonDocument other(&spy);
+    fill(other.to<JsonObject>(), 100, 100);
+
+    JsonDocument moved(std::move(doc));
+    doc = std::move(other);
+
+    REQUIRE(moved["key42"] == 42);
+    REQUIRE(moved["key142"].isNull());
+    REQUIRE(doc["key142"] == 142);
+    REQUIRE(doc["key42"].isNull());
+  }
+
+  SECTION("deserializeJson()") {
+    std::string json = "{";
+    for (size_t i = 0; i < 100; i++) {
+      if (i)
+        json += ",";
+      json += "\"" + key(i) + "\":" + std::to_string(i);
+    }
+    json += ",\"key42\":-1}";  // duplicate key
+
+    REQUIRE(deserializeJson(doc, json) == DeserializationError::Ok);
+    REQUIRE(doc.size() == 100);
+    REQUIRE(doc["key42"] == -1);
+    REQUIRE(doc["key99"] == 99);
+  }
+
+  SECTION("clear() releases the index") {
+    fill(obj, 100);
+    doc.clear();
+
+    REQUIRE(spy.allocatedBytes() == 0);
+  }
+}
+
+TEST_CASE("ARDUINOJSON_OBJECT_KEY_INDEX == 1 without memory") {
+  TimebombAllocator timebomb(100);
+  JsonDocument doc(&timebomb);
+  JsonObject obj = doc.to<JsonObject>();
+
+  SECTION("Falls back to linear search") {
+    fill(obj, 8);  // one pool and 8 strings
+    timebomb.setCountdown(threshold - 8);
+    fill(obj, threshold - 8, 8);  // the rest of the strings
+    REQUIRE(obj.size() == threshold);
+
+    REQUIRE(obj["missing"].isNull());  // can't build the index
+    for (size_t i = 0; i < threshold; i++)
+      REQUIRE(obj[key(i)] == i);
+  }
+}
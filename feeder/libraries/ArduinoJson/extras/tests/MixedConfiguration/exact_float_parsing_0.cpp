@@ -0,0 +1,40 @@
+#define ARDUINOJSON_VERSION_NAMESPACE ExactFloatParsing0
+#define ARDUINOJSON_EXACT_FLOAT_PARSING 0
+#define ARDUINOJSON_USE_DOUBLE 1
+#include <ArduinoJson.h>
+
+#include <catch.hpp>
+
+TEST_CASE("ARDUINOJSON_EXACT_FLOAT_PARSING == 0") {
+  using ArduinoJson::detail::NumberType;
+  using ArduinoJson::detail::parseNumber;
+
+  SECTION("Float") {
+    auto result = parseNumber("3.14");
+    REQUIRE(result.type() == NumberType::Float);
+    REQUIRE(result.asFloat() == Approx(3.14f));
+  }
+
+  SECTION("Double") {
+    auto result = parseNumber("1.7976931348623157e308");
+    REQUIRE(result.type() == NumberType::Double);
+    REQUIRE(result.asDouble() == Approx(1.7976931348623157e308));
+  }
+
+  SECTION("MantissaTooLongToFit") {
+    auto result = parseNumber("0.179769313486231571111111111111");
+    REQUIRE(result.type() == NumberType::Double);
+    REQUIRE(result.asDouble() == Approx(0.17976931348623157));
+  }
+
+  SECTION("Invalid") {
+    REQUIRE(parseNumber("1.2.3").type() == NumberType::Invalid);
+  }
+
+  SECTION("deserializeJson()") {
+    JsonDocument doc;
+    deserializeJson(doc, "[1.5,-2.25e2]");
+    REQUIRE(doc[0].as<double>() == 1.5);
+    REQUIRE(doc[1].as<double>() == -225.0);
+  }
+}
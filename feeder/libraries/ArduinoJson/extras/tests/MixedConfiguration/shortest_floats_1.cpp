@@ -0,0 +1,35 @@
+#define ARDUINOJSON_VERSION_NAMESPACE ShortestFloats1
+#define ARDUINOJSON_SHORTEST_FLOATS 1
+#define ARDUINOJSON_USE_DOUBLE 1
+#include <ArduinoJson.h>
+
+#include <catch.hpp>
+#include <string>
+
+TEST_CASE("ARDUINOJSON_SHORTEST_FLOATS == 1") {
+  JsonDocument doc;
+  std::string json;
+
+  SECTION("serializeJson()") {
+    doc.add(0.1);
+    doc.add(1.0 / 3);
+    doc.add(3.14159265f);
+    doc.add(1e-7);
+    serializeJson(doc, json);
+
+    REQUIRE(json == "[0.1,0.3333333333333333,3.1415927,1e-7]");
+  }
+
+  SECTION("measureJson()") {
+    doc.add(1.0 / 3);
+
+    REQUIRE(measureJson(doc) == 20);
+  }
+
+  SECTION("serializeJsonPretty()") {
+    doc["pi"] = 3.141592653589793;
+    serializeJsonPretty(doc, json);
+
+    REQUIRE(json == "{\r\n  \"pi\": 3.141592653589793\r\n}");
+  }
+}
@@ -0,0 +1,152 @@
+#define ARDUINOJSON_VERSION_NAMESPACE StringPoolIndex
+#define ARDUINOJSON_STRING_POOL_INDEX 1
+#include <ArduinoJson.h>
+
+#include <catch.hpp>
+#include <string>
+#include <vector>
+
+#include "Allocators.hpp"
+#include "Literals.hpp"
+
+using namespace ArduinoJson::detail;
+
+static std::string key(int i) {
+  return "key" + std::to_string(i);
+}
+
+TEST_CASE("ARDUINOJSON_STRING_POOL_INDEX == 1") {
+  SpyingAllocator spy;
+
+  SECTION("ResourceManager") {
+    ResourceManager resources(&spy);
+
+    SECTION("Deduplicates identical strings") {
+      auto a = resources.saveString(adaptString("hello"));
+      auto b = resources.saveString(adaptString("hello"));
+      REQUIRE(a == b);
+      REQUIRE(a->references == 2);
+    }
+
+    SECTION("Tells apart strings that differ after a NUL") {
+      auto a = resources.saveString(adaptString("hello\0world", 11));
+      auto b = resources.saveString(adaptString("hello\0there", 11));
+      auto c = resources.saveString(adaptString("hello\0world", 11));
+      REQUIRE(a != b);
+      REQUIRE(a == c);
+    }
+
+    SECTION("Finds every string once the table grew") {
+      std::vector<StringNode*> nodes;
+      for (int i = 0; i < 5000; i++)
+        nodes.push_back(resources.saveString(adaptString(key(i))));
+
+      for (int i = 0; i < 5000; i++)
+        REQUIRE(resources.getString(adaptString(key(i))) == nodes[size_t(i)]);
+      REQUIRE(resources.getString(adaptString("key5000")) == nullptr);
+    }
+
+    SECTION("Finds the other strings after removing some") {
+      std::vector<StringNode*> nodes;
+      for (int i = 0; i < 1000; i++)
+        nodes.push_back(resources.saveString(adaptString(key(i))));
+
+      for (int i = 0; i < 1000; i += 3)
+        resources.dereferenceString(nodes[size_t(i)]->data);
+
+      for (int i = 0; i < 1000; i++) {
+        auto node = resources.getString(adaptString(key(i)));
+        if (i % 3 == 0)
+          REQUIRE(node == nullptr);
+        else
+          REQUIRE(node == nodes[size_t(i)]);
+      }
+    }
+
+    SECTION("Keeps a string until its last reference is gone") {
+      auto a = resources.saveString(adaptString("hello"));
+      resources.saveString(adaptString("hello"));
+
+      resources.dereferenceString(a->data);
+      REQUIRE(resources.getString(adaptString("hello")) == a);
+
+      resources.dereferenceString(a->data);
+      REQUIRE(resources.getString(adaptString("hello")) == nullptr);
+    }
+
+    SECTION("Counts the table in size()") {
+      resources.saveString(adaptString("hello"));
+      REQUIRE(resources.size() ==
+              sizeofString("hello") + 8 * sizeof(StringNode*));
+    }
+
+    SECTION("swap()") {
+      ResourceManager other(&spy);
+      auto a = resources.saveString(adaptString("hello"));
+      swap(resources, other);
+
+      REQUIRE(resources.getString(adaptString("hello")) == nullptr);
+      REQUIRE(other.getString(adaptString("hello")) == a);
+    }
+
+    SECTION("clear() frees the strings and the table") {
+      for (int i = 0; i < 100; i++)
+        resources.saveString(adaptString(key(i)));
+      resources.clear();
+
+      REQUIRE(spy.allocatedBytes() == 0);
+      REQUIRE(resources.size() == 0);
+      REQUIRE(resources.getString(adaptString("key0")) == nullptr);
+    }
+
+    SECTION("Overflows if the table can't grow") {
+      KillswitchAllocator killswitch;
+      ResourceManager failing(&killswitch);
+      killswitch.on();
+
+      REQUIRE(failing.saveString(adaptString("hello")) == nullptr);
+      REQUIRE(failing.overflowed() == true);
+      REQUIRE(failing.createString(5) == nullptr);
+    }
+  }
+
+  SECTION("JsonDocument") {
+    JsonDocument doc(&spy);
+
+    SECTION("deserializeJson() deduplicates keys") {
+      std::string json = "[";
+      for (int i = 0; i < 200; i++) {
+        if (i)
+          json += ",";
+        json += "{\"id\":" + std::to_string(i) + ",\"" + key(i % 10) +
+                "\":\"value\"}";
+      }
+      json += "]";
+
+      REQUIRE(deserializeJson(doc, json) == DeserializationError::Ok);
+      REQUIRE(doc[199]["key9"] == "value");
+
+      const char* a = doc[0]["key0"].as<const char*>();
+      const char* b = doc[10]["key0"].as<const char*>();
+      REQUIRE(a == b);
+    }
+
+    SECTION("Removing members releases their strings") {
+      for (int i = 0; i < 100; i++)
+        doc[key(i)] = key(i + 1000);
+      for (int i = 0; i < 100; i++)
+        doc.remove(key(i));
+      doc.clear();
+
+      REQUIRE(spy.allocatedBytes() == 0);
+    }
+
+    SECTION("set(MsgPackBinary) keeps the content") {
+      doc["a"] = MsgPackBinary("\x01\x02\x03", 3);
+      doc["b"] = MsgPackBinary("\x01\x02\x03", 3);
+
+      REQUIRE(doc["a"].as<MsgPackBinary>().size() == 3);
+      REQUIRE(doc["b"].as<MsgPackBinary>().size() == 3);
+    }
+  }
+}
@@ -0,0 +1,160 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+#define ARDUINOJSON_USE_DOUBLE 1
+#define ARDUINOJSON_EXACT_FLOAT_PARSING 1
+
+#include <ArduinoJson.hpp>
+#include <catch.hpp>
+
+#include <stdio.h>
+#include <string>
+
+using namespace ArduinoJson::detail;
+
+static uint64_t bitsOf(double x) {
+  return alias_cast<uint64_t>(x);
+}
+
+static uint32_t bitsOf(float x) {
+  return alias_cast<uint32_t>(x);
+}
+
+static void checkDoubleBits(const char* input, uint64_t expected) {
+  CAPTURE(input);
+  REQUIRE(parseNumber(input).type() == NumberType::Double);
+  REQUIRE(bitsOf(parseNumber<double>(input)) == expected);
+}
+
+static void checkDecimal(const char* input, uint32_t expected) {
+  CAPTURE(input);
+  REQUIRE(bitsOf(Decimal(input).toFloat<float>()) == expected);
+}
+
+static void checkDecimal(const char* input, uint64_t expected) {
+  CAPTURE(input);
+  REQUIRE(bitsOf(Decimal(input).toFloat<double>()) == expected);
+}
+
+// xorshift64, so the corpus is the same on every platform
+static uint64_t nextRandom() {
+  static uint64_t state = 0x2545F4914F6CDD1D;
+  state ^= state << 13;
+  state ^= state >> 7;
+  state ^= state << 17;
+  return state;
+}
+
+TEST_CASE("powerOfFive()") {
+  auto check = [](int q, uint64_t high, uint64_t low) {
+    CAPTURE(q);
+    auto p = powerOfFive(q);
+    REQUIRE(p.high == high);
+    REQUIRE(p.low == low);
+  };
+
+  check(-342, 0xEEF453D6923BD65A, 0x113FAA2906A13B3F);
+  check(-100, 0xDFF9772470297EBD, 0x59787E2B93BC56F7);
+  check(-1, 0xCCCCCCCCCCCCCCCC, 0xCCCCCCCCCCCCCCCC);
+  check(0, 0x8000000000000000, 0x0000000000000000);
+  check(1, 0xA000000000000000, 0x0000000000000000);
+  check(27, 0xCECB8F27F4200F3A, 0x0000000000000000);
+  check(100, 0x924D692CA61BE758, 0x593C2626705F9C56);
+  check(308, 0x8E679C2F5E44FF8F, 0x570F09EAA7EA7648);
+  check(325, 0xC5A05277621BE293, 0xC7098B7305241885);
+}
+
+TEST_CASE("eiselLemire()") {
+  double result = 0;
+
+  SECTION("Converts simple values") {
+    REQUIRE(eiselLemire(1, 0, result) == true);
+    REQUIRE(result == 1.0);
+    REQUIRE(eiselLemire(3, 1, result) == true);
+    REQUIRE(result == 30.0);
+  }
+
+  SECTION("Gives up on exact ties") {
+    REQUIRE(eiselLemire(9007199254740993, 0, result) == false);
+  }
+
+  SECTION("Gives up on subnormals") {
+    REQUIRE(eiselLemire(49406564584124654, -340, result) == false);
+  }
+}
+
+TEST_CASE("Decimal::toFloat()") {
+  SECTION("double") {
+    checkDecimal("9007199254740993", uint64_t(0x4340000000000000));
+    checkDecimal("9007199254740995", uint64_t(0x4340000000000002));
+    checkDecimal("4.9406564584124654e-324", uint64_t(0x0000000000000001));
+    checkDecimal("2.4703282292062327e-324", uint64_t(0x0000000000000000));
+    checkDecimal("2.2250738585072011e-308", uint64_t(0x000FFFFFFFFFFFFF));
+    checkDecimal("1.7976931348623159e308", uint64_t(0x7FF0000000000000));
+    checkDecimal("0", uint64_t(0));
+  }
+
+  SECTION("float") {
+    checkDecimal("1.0000000596046447753906250", uint32_t(0x3F800000));
+    checkDecimal("1.00000005960464477539062501", uint32_t(0x3F800001));
+    checkDecimal("3.4028235677973366e38", uint32_t(0x7F7FFFFF));
+    checkDecimal("3.4028235677973367e38", uint32_t(0x7F800000));
+    checkDecimal("1e-45", uint32_t(0x00000001));
+    checkDecimal("7e-46", uint32_t(0x00000000));
+    checkDecimal("7.1e-46", uint32_t(0x00000001));
+  }
+
+  SECTION("Digits beyond the buffer break ties") {
+    std::string input = "9007199254740993." + std::string(850, '0');
+    checkDecimal(input.c_str(), uint64_t(0x4340000000000000));
+    input += "1";
+    checkDecimal(input.c_str(), uint64_t(0x4340000000000001));
+  }
+}
+
+TEST_CASE("parseNumber() rounds correctly") {
+  SECTION("Hard cases") {
+    checkDoubleBits("2.2250738585072011e-308", 0x000FFFFFFFFFFFFF);
+    checkDoubleBits("2.2250738585072012e-308", 0x0010000000000000);
+    checkDoubleBits("7.3177701707893310e+15", 0x4339FF792393EDD3);
+    checkDoubleBits("9007199254740993.0", 0x4340000000000000);
+    checkDoubleBits("9007199254740993.0000000000000000001",
+                    0x4340000000000001);
+    checkDoubleBits("100000000000000000000000", 0x44B52D02C7E14AF6);
+    checkDoubleBits("8.988465674311580536566680e307", 0x7FE0000000000000);
+    checkDoubleBits("4.9406564584124654e-324", 0x0000000000000001);
+    checkDoubleBits("2.4703282292062327e-324", 0x0000000000000000);
+    checkDoubleBits("2.4703282292062328e-324", 0x0000000000000001);
+    checkDoubleBits("1.7976931348623158e308", 0x7FEFFFFFFFFFFFFF);
+    checkDoubleBits("1.7976931348623159e308", 0x7FF0000000000000);
+    checkDoubleBits("7.2057594037927933e16", 0x4370000000000000);
+    checkDoubleBits("123456789012345678901234567890", 0x45F8EE90FF6C373E);
+    checkDoubleBits("-1.00000005960464477539062499", 0xBFF0000010000000);
+  }
+
+  SECTION("Round trip of random doubles") {
+    char buffer[32];
+    for (int i = 0; i < 100000; i++) {
+      uint64_t bits = nextRandom();
+      if ((bits & 0x7FF0000000000000) == 0x7FF0000000000000)
+        continue;  // NaN or infinity
+      snprintf(buffer, sizeof(buffer), "%.17g", alias_cast<double>(bits));
+      CAPTURE(buffer);
+      REQUIRE(bitsOf(parseNumber<double>(buffer)) == bits);
+    }
+  }
+
+  SECTION("Round trip of random floats") {
+    char buffer[32];
+    for (int i = 0; i < 100000; i++) {
+      auto bits = uint32_t(nextRandom());
+      if ((bits & 0x7F800000) == 0x7F800000)
+        continue;  // NaN or infinity
+      snprintf(buffer, sizeof(buffer), "%.9g",
+               double(alias_cast<float>(bits)));
+      CAPTURE(buffer);
+      REQUIRE(bitsOf(parseNumber<float>(buffer)) == bits);
+    }
+  }
+}
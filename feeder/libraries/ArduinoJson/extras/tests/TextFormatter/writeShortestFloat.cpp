@@ -0,0 +1,127 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+#include <catch.hpp>
+#include <limits>
+#include <stdlib.h>
+#include <string>
+
+#define ARDUINOJSON_ENABLE_NAN 1
+#define ARDUINOJSON_ENABLE_INFINITY 1
+#include <ArduinoJson/Json/TextFormatter.hpp>
+#include <ArduinoJson/Serialization/Writer.hpp>
+
+using namespace ArduinoJson::detail;
+
+template <typename TFloat>
+static std::string format(TFloat input) {
+  std::string output;
+  Writer<std::string> sb(output);
+  TextFormatter<Writer<std::string>> writer(sb);
+  writer.writeShortestFloat(input);
+  REQUIRE(writer.bytesWritten() == output.size());
+  return output;
+}
+
+template <typename TFloat>
+static void check(TFloat input, const std::string& expected) {
+  CHECK(format(input) == expected);
+}
+
+// xorshift64, so the corpus is the same on every platform
+static uint64_t nextRandom() {
+  static uint64_t state = 0x9E3779B97F4A7C15;
+  state ^= state << 13;
+  state ^= state >> 7;
+  state ^= state << 17;
+  return state;
+}
+
+TEST_CASE("TextFormatter::writeShortestFloat(double)") {
+  SECTION("NaN") {
+    check<double>(std::numeric_limits<double>::quiet_NaN(), "NaN");
+  }
+
+  SECTION("Infinity") {
+    double inf = std::numeric_limits<double>::infinity();
+    check<double>(inf, "Infinity");
+    check<double>(-inf, "-Infinity");
+  }
+
+  SECTION("Zero") {
+    check<double>(0.0, "0");
+    check<double>(-0.0, "0");
+  }
+
+  SECTION("Only the digits needed") {
+    check<double>(0.1, "0.1");
+    check<double>(-2.5, "-2.5");
+    check<double>(100.0, "100");
+    check<double>(123456.789, "123456.789");
+    check<double>(0.001, "0.001");
+    check<double>(3.14159265359, "3.14159265359");
+  }
+
+  SECTION("All the digits needed") {
+    check<double>(1.0 / 3, "0.3333333333333333");
+    check<double>(0.1 + 0.2, "0.30000000000000004");
+    check<double>(9999999.999999998, "9999999.999999998");
+  }
+
+  SECTION("Exponentiation thresholds") {
+    check<double>(1e7, "1e7");
+    check<double>(9999999.0, "9999999");
+    check<double>(1e-5, "1e-5");
+    check<double>(1.5e-5, "0.000015");
+    check<double>(9007199254740992.0, "9.007199254740992e15");
+    check<double>(1e22, "1e22");
+    check<double>(1e23, "1e23");
+  }
+
+  SECTION("Limits") {
+    check<double>(1.7976931348623157e308, "1.7976931348623157e308");
+    check<double>(-1.7976931348623157e308, "-1.7976931348623157e308");
+    check<double>(2.2250738585072014e-308, "2.2250738585072014e-308");
+    check<double>(5e-324, "5e-324");
+  }
+}
+
+TEST_CASE("TextFormatter::writeShortestFloat(float)") {
+  check<float>(0.1f, "0.1");
+  check<float>(3.14159265f, "3.1415927");
+  check<float>(16777216.0f, "1.6777216e7");
+  check<float>(3.4028235e38f, "3.4028235e38");
+  check<float>(1e-45f, "1e-45");
+  check<float>(-0.0f, "0");
+}
+
+TEST_CASE("strtod(writeShortestFloat(x)) == x") {
+  SECTION("Random doubles") {
+    for (int i = 0; i < 2000000; i++) {
+      uint64_t bits = nextRandom();
+      if (i % 4 == 0)  // subnormals and tiny numbers
+        bits &= 0x803FFFFFFFFFFFFF;
+      auto x = alias_cast<double>(bits);
+      if (isnan(x) || isinf(x))
+        continue;
+      auto output = format(x);
+      CAPTURE(output);
+      REQUIRE(alias_cast<uint64_t>(strtod(output.c_str(), nullptr)) ==
+              (x == 0 ? 0 : bits));
+    }
+  }
+
+  SECTION("Random floats") {
+    for (int i = 0; i < 1000000; i++) {
+      auto bits = uint32_t(nextRandom());
+      auto x = alias_cast<float>(bits);
+      if (isnan(x) || isinf(x))
+        continue;
+      auto output = format(x);
+      CAPTURE(output);
+      REQUIRE(alias_cast<uint32_t>(strtof(output.c_str(), nullptr)) ==
+              (x == 0 ? 0 : bits));
+    }
+  }
+}
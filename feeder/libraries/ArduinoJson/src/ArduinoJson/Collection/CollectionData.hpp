@@ -104,6 +104,17 @@ class CollectionData {
   void removeOne(iterator it, ResourceManager* resources);
   void removePair(iterator it, ResourceManager* resources);
 
+#if ARDUINOJSON_OBJECT_KEY_INDEX
+  bool hasKeyIndex(const ResourceManager* resources) const;
+  void buildKeyIndex(const ResourceManager* resources) const;
+  void dropKeyIndex(const ResourceManager* resources) const;
+  void indexKey(Slot<VariantData> key, const ResourceManager* resources) const;
+
+  template <typename TAdaptedString>
+  iterator findIndexedKey(TAdaptedString key,
+                          const ResourceManager* resources) const;
+#endif
+
  private:
   Slot<VariantData> getPreviousSlot(VariantData*, const ResourceManager*) const;
 };
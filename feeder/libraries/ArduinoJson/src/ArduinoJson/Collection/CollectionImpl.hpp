@@ -58,6 +58,9 @@ inline void CollectionData::appendPair(Slot<VariantData> key,
 }
 
 inline void CollectionData::clear(ResourceManager* resources) {
+#if ARDUINOJSON_OBJECT_KEY_INDEX
+  dropKeyIndex(resources);
+#endif
   auto next = head_;
   while (next != NULL_SLOT) {
     auto currId = next;
@@ -104,6 +107,10 @@ inline void CollectionData::removePair(ObjectData::iterator it,
   if (it.done())
     return;
 
+#if ARDUINOJSON_OBJECT_KEY_INDEX
+  dropKeyIndex(resources);  // the index is rebuilt by the next lookups
+#endif
+
   auto keySlot = it.slot_;
 
   auto valueId = it.nextId_;
@@ -117,6 +124,88 @@ inline void CollectionData::removePair(ObjectData::iterator it,
   removeOne(it, resources);
 }
 
+#if ARDUINOJSON_OBJECT_KEY_INDEX
+template <typename TAdaptedString>
+struct IndexedKeyMatcher {
+  TAdaptedString key;
+  const ResourceManager* resources;
+
+  bool operator()(SlotId id) const {
+    return stringEquals(key, adaptString(resources->getVariant(id)->asString()));
+  }
+};
+
+template <typename TAdaptedString>
+IndexedKeyMatcher<TAdaptedString> matchIndexedKey(
+    TAdaptedString key, const ResourceManager* resources) {
+  return {key, resources};
+}
+
+inline bool CollectionData::hasKeyIndex(
+    const ResourceManager* resources) const {
+  return head_ != NULL_SLOT && resources->keyIndex()->contains(head_);
+}
+
+// Indexes the keys of an object, i.e., the even slots.
+// Only the first of duplicate keys is indexed, as it's the one findKey()
+// returns.
+inline void CollectionData::buildKeyIndex(
+    const ResourceManager* resources) const {
+  ARDUINOJSON_ASSERT(!hasKeyIndex(resources));
+  auto index = resources->keyIndex();
+  auto allocator = resources->allocator();
+  if (!index->reserve(size(resources) / 2 + 1, allocator))
+    return;
+  index->addObject(head_, allocator);
+  bool isKey = true;
+  for (auto it = createIterator(resources); !it.done(); it.next(resources)) {
+    if (isKey)
+      indexKey({it.slot_, it.currentId_}, resources);
+    isKey = !isKey;
+  }
+}
+
+inline void CollectionData::dropKeyIndex(
+    const ResourceManager* resources) const {
+  if (!hasKeyIndex(resources))
+    return;
+  auto index = resources->keyIndex();
+  bool isKey = true;
+  for (auto it = createIterator(resources); !it.done(); it.next(resources)) {
+    if (isKey)
+      index->removeKey(head_, it.currentId_,
+                       stringHash(adaptString(it->asString())));
+    isKey = !isKey;
+  }
+  index->removeObject(head_);
+}
+
+// Adds a key to the index of its object, if the object has one
+inline void CollectionData::indexKey(Slot<VariantData> key,
+                                     const ResourceManager* resources) const {
+  if (!hasKeyIndex(resources))
+    return;
+  auto index = resources->keyIndex();
+  auto str = adaptString(key->asString());
+  auto hash = stringHash(str);
+  if (index->find(head_, hash, matchIndexedKey(str, resources)) != NULL_SLOT)
+    return;  // duplicate key
+  if (!index->addKey(head_, key.id(), hash, resources->allocator()))
+    dropKeyIndex(resources);  // an incomplete index would miss keys
+}
+
+template <typename TAdaptedString>
+inline CollectionData::iterator CollectionData::findIndexedKey(
+    TAdaptedString key, const ResourceManager* resources) const {
+  ARDUINOJSON_ASSERT(hasKeyIndex(resources));
+  auto id = resources->keyIndex()->find(head_, stringHash(key),
+                                        matchIndexedKey(key, resources));
+  if (id == NULL_SLOT)
+    return iterator();
+  return iterator(resources->getVariant(id), id);
+}
+#endif
+
 inline size_t CollectionData::nesting(const ResourceManager* resources) const {
   size_t maxChildNesting = 0;
   for (auto it = createIterator(resources); !it.done(); it.next(resources)) {
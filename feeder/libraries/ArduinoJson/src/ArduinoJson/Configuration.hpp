@@ -257,6 +257,55 @@
 #  endif
 #endif
 
+// Index the string pool with a hash table, so that deduplicating a string
+// doesn't compare it with every string in the document.
+// Costs a hash per string and about two pointers per string for the table.
+// Like ARDUINOJSON_ENABLE_ALIGNMENT, this setting isn't part of the namespace,
+// so it must be the same in every translation unit.
+#ifndef ARDUINOJSON_STRING_POOL_INDEX
+#  define ARDUINOJSON_STRING_POOL_INDEX 0
+#endif
+
+// Index the keys of large objects with a hash table, so that looking up a
+// member doesn't compare the key with every member of the object.
+// The table is built by the first lookup that scans at least
+// ARDUINOJSON_OBJECT_KEY_INDEX_THRESHOLD members, and costs a few words per member.
+// Must also be the same in every translation unit.
+#ifndef ARDUINOJSON_OBJECT_KEY_INDEX
+#  define ARDUINOJSON_OBJECT_KEY_INDEX 0
+#endif
+
+// Number of members from which an object gets a key index
+#ifndef ARDUINOJSON_OBJECT_KEY_INDEX_THRESHOLD
+#  define ARDUINOJSON_OBJECT_KEY_INDEX_THRESHOLD 16
+#endif
+
+// Scan the strings of a RAM input a word at a time, instead of a char at a
+// time, and copy their plain runs in one go
+#ifndef ARDUINOJSON_FAST_STRING_SCAN
+#  if ARDUINOJSON_SIZEOF_POINTER >= 4  // 32 & 64 bits systems
+#    define ARDUINOJSON_FAST_STRING_SCAN 1
+#  else
+#    define ARDUINOJSON_FAST_STRING_SCAN 0
+#  endif
+#endif
+
+// Parse floats with the Eisel-Lemire algorithm, so they are correctly rounded,
+// instead of multiplying the mantissa by powers of ten
+#ifndef ARDUINOJSON_EXACT_FLOAT_PARSING
+#  if ARDUINOJSON_SIZEOF_POINTER >= 4  // 32 & 64 bits systems
+#    define ARDUINOJSON_EXACT_FLOAT_PARSING 1
+#  else
+#    define ARDUINOJSON_EXACT_FLOAT_PARSING 0
+#  endif
+#endif
+
+// Serialize floats with the fewest digits that parse back to the same value,
+// instead of a fixed number of decimal places (9 for double, 6 for float)
+#ifndef ARDUINOJSON_SHORTEST_FLOATS
+#  define ARDUINOJSON_SHORTEST_FLOATS 0
+#endif
+
 #ifndef ARDUINOJSON_TAB
 #  define ARDUINOJSON_TAB "  "
 #endif
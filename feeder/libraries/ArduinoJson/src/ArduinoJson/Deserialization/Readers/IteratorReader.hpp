@@ -29,6 +29,17 @@ class IteratorReader {
       buffer[i++] = *ptr_++;
     return i;
   }
+
+  // Reads, in place, the chars that TSkipper::skip() skips.
+  // Only for pointers, as other iterators might not be contiguous.
+  template <typename TSkipper, typename T = TIterator>
+  enable_if_t<is_same<T, const char*>::value, const char*> readSpan(
+      size_t& length) {
+    auto begin = ptr_;
+    ptr_ = TSkipper::skip(ptr_, end_);
+    length = static_cast<size_t>(ptr_ - begin);
+    return begin;
+  }
 };
 
 template <typename TSource>
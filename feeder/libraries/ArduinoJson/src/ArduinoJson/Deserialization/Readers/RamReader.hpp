@@ -35,6 +35,15 @@ struct Reader<TSource*, enable_if_t<IsCharOrVoid<TSource>::value>> {
       buffer[i] = *ptr_++;
     return length;
   }
+
+  // Reads, in place, the chars that TSkipper::skip() skips
+  template <typename TSkipper>
+  const char* readSpan(size_t& length) {
+    auto begin = ptr_;
+    ptr_ = TSkipper::skip(ptr_);
+    length = static_cast<size_t>(ptr_ - begin);
+    return begin;
+  }
 };
 
 template <typename TSource>
@@ -7,6 +7,7 @@
 #include <ArduinoJson/Deserialization/deserialize.hpp>
 #include <ArduinoJson/Json/EscapeSequence.hpp>
 #include <ArduinoJson/Json/Latch.hpp>
+#include <ArduinoJson/Json/PlainChars.hpp>
 #include <ArduinoJson/Json/Utf16.hpp>
 #include <ArduinoJson/Json/Utf8.hpp>
 #include <ArduinoJson/Memory/ResourceManager.hpp>
@@ -404,6 +405,9 @@ class JsonDeserializer {
 
     move();
     for (;;) {
+#if ARDUINOJSON_FAST_STRING_SCAN
+      appendPlainChars(CanReadSpan<TReader, PlainChars>());
+#endif
       char c = current();
       move();
       if (c == stopChar)
@@ -449,6 +453,26 @@ class JsonDeserializer {
     return DeserializationError::Ok;
   }
 
+#if ARDUINOJSON_FAST_STRING_SCAN
+  // Copies a run of plain chars straight from a RAM input
+  void appendPlainChars(true_type) {
+    size_t n;
+    const char* s = latch_.template readSpan<PlainChars>(n);
+    if (n)
+      stringBuilder_.append(s, n);
+  }
+
+  // Other inputs go char by char
+  void appendPlainChars(false_type) {}
+
+  void skipPlainChars(true_type) {
+    size_t n;
+    latch_.template readSpan<PlainChars>(n);
+  }
+
+  void skipPlainChars(false_type) {}
+#endif
+
   DeserializationError::Code parseNonQuotedString() {
     char c = current();
     ARDUINOJSON_ASSERT(c);
@@ -482,6 +506,9 @@ class JsonDeserializer {
 
     move();
     for (;;) {
+#if ARDUINOJSON_FAST_STRING_SCAN
+      skipPlainChars(CanReadSpan<TReader, PlainChars>());
+#endif
       char c = current();
       move();
       if (c == stopChar)
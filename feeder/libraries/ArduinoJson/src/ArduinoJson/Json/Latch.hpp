@@ -5,9 +5,22 @@
 #pragma once
 
 #include <ArduinoJson/Polyfills/assert.hpp>
+#include <ArduinoJson/Polyfills/type_traits.hpp>
+
+#include <stddef.h>  // size_t
 
 ARDUINOJSON_BEGIN_PRIVATE_NAMESPACE
 
+// Is true if the reader can read a span of the input in place,
+// i.e., if the input is a contiguous buffer in RAM
+template <typename TReader, typename TSkipper, typename Enable = void>
+struct CanReadSpan : false_type {};
+
+template <typename TReader, typename TSkipper>
+struct CanReadSpan<TReader, TSkipper,
+                   void_t<decltype(declval<TReader&>().template readSpan<TSkipper>(
+                       declval<size_t&>()))>> : true_type {};
+
 template <typename TReader>
 class Latch {
  public:
@@ -32,6 +45,17 @@ class Latch {
     return current_;
   }
 
+  // Reads, in place, the chars that TSkipper::skip() skips.
+  // Returns an empty span if the current char is already loaded.
+  template <typename TSkipper>
+  const char* readSpan(size_t& length) {
+    if (loaded_) {
+      length = 0;
+      return nullptr;
+    }
+    return reader_.template readSpan<TSkipper>(length);
+  }
+
  private:
   void load() {
     ARDUINOJSON_ASSERT(!ended_);
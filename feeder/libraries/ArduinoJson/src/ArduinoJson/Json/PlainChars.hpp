@@ -0,0 +1,118 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+#pragma once
+
+#include <ArduinoJson/Namespace.hpp>
+
+#include <stddef.h>  // ptrdiff_t
+#include <stdint.h>  // uint32_t, uint64_t
+#include <string.h>  // memcpy
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define ARDUINOJSON_PLAIN_CHARS_SSE2 1
+#  include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#  define ARDUINOJSON_PLAIN_CHARS_NEON 1
+#  include <arm_neon.h>
+#endif
+
+ARDUINOJSON_BEGIN_PRIVATE_NAMESPACE
+
+// Finds the runs of a quoted string that the deserializer copies verbatim,
+// i.e., everything but quotes, backslashes and control characters.
+class PlainChars {
+ public:
+  static bool isPlain(char c) {
+    return c != '"' && c != '\'' && c != '\\' &&
+           static_cast<unsigned char>(c) >= 0x20;
+  }
+
+  // Returns the first char that is not plain, or the terminator.
+  // Goes byte by byte because it can't read past the terminator.
+  static const char* skip(const char* p) {
+    while (isPlain(*p))
+      p++;
+    return p;
+  }
+
+  // Returns the first char that is not plain, or end.
+  static const char* skip(const char* p, const char* end) {
+#if defined(ARDUINOJSON_PLAIN_CHARS_SSE2)
+    const __m128i quotes = _mm_set1_epi8('"');
+    const __m128i apostrophes = _mm_set1_epi8('\'');
+    const __m128i backslashes = _mm_set1_epi8('\\');
+    const __m128i lastControl = _mm_set1_epi8(0x1f);
+    while (end - p >= 16) {
+      __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(
+          static_cast<const void*>(p)));
+      __m128i special = _mm_or_si128(
+          _mm_or_si128(_mm_cmpeq_epi8(chunk, quotes),
+                       _mm_cmpeq_epi8(chunk, apostrophes)),
+          _mm_or_si128(_mm_cmpeq_epi8(chunk, backslashes),
+                       // unsigned chunk <= 0x1f
+                       _mm_cmpeq_epi8(_mm_min_epu8(chunk, lastControl), chunk)));
+      if (_mm_movemask_epi8(special))
+        break;
+      p += 16;
+    }
+#elif defined(ARDUINOJSON_PLAIN_CHARS_NEON)
+    const uint8x16_t quotes = vdupq_n_u8('"');
+    const uint8x16_t apostrophes = vdupq_n_u8('\'');
+    const uint8x16_t backslashes = vdupq_n_u8('\\');
+    const uint8x16_t firstPlain = vdupq_n_u8(0x20);
+    while (end - p >= 16) {
+      uint8x16_t chunk = vld1q_u8(reinterpret_cast<const uint8_t*>(p));
+      uint8x16_t special =
+          vorrq_u8(vorrq_u8(vceqq_u8(chunk, quotes), vceqq_u8(chunk, apostrophes)),
+                   vorrq_u8(vceqq_u8(chunk, backslashes),
+                            vcltq_u8(chunk, firstPlain)));
+      if (vmaxvq_u8(special))
+        break;
+      p += 16;
+    }
+#endif
+    while (end - p >= static_cast<ptrdiff_t>(sizeof(chunk_t))) {
+      chunk_t chunk;
+      memcpy(&chunk, p, sizeof(chunk));
+      if (hasSpecial(chunk))
+        break;
+      p += sizeof(chunk_t);
+    }
+    // The special char is in the last chunk, or in the tail
+    while (p < end && isPlain(*p))
+      p++;
+    return p;
+  }
+
+ private:
+#if ARDUINOJSON_SIZEOF_POINTER >= 8
+  using chunk_t = uint64_t;
+#else
+  using chunk_t = uint32_t;
+#endif
+
+  // SWAR: non-zero if a byte of x is below n (n <= 0x80).
+  // The flagged bytes after the first match may be wrong, but we only need
+  // to know if there is one.
+  static chunk_t hasLess(chunk_t x, uint8_t n) {
+    return (x - repeat(n)) & ~x & repeat(0x80);
+  }
+
+  static chunk_t hasByte(chunk_t x, uint8_t n) {
+    return hasLess(x ^ repeat(n), 1);
+  }
+
+  static bool hasSpecial(chunk_t x) {
+    return (hasByte(x, '"') | hasByte(x, '\'') | hasByte(x, '\\') |
+            hasLess(x, 0x20)) != 0;
+  }
+
+  static chunk_t repeat(uint8_t n) {
+    return chunk_t(-1) / 0xff * n;
+  }
+};
+
+ARDUINOJSON_END_PRIVATE_NAMESPACE
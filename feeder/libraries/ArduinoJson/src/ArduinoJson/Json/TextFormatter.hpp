@@ -10,6 +10,7 @@
 #include <ArduinoJson/Json/EscapeSequence.hpp>
 #include <ArduinoJson/Numbers/FloatParts.hpp>
 #include <ArduinoJson/Numbers/JsonInteger.hpp>
+#include <ArduinoJson/Numbers/Ryu.hpp>
 #include <ArduinoJson/Polyfills/assert.hpp>
 #include <ArduinoJson/Polyfills/attributes.hpp>
 #include <ArduinoJson/Polyfills/type_traits.hpp>
@@ -66,30 +67,16 @@ class TextFormatter {
 
   template <typename T>
   void writeFloat(T value) {
+#if ARDUINOJSON_SHORTEST_FLOATS
+    writeShortestFloat(value);
+#else
     writeFloat(JsonFloat(value), sizeof(T) >= 8 ? 9 : 6);
+#endif
   }
 
   void writeFloat(JsonFloat value, int8_t decimalPlaces) {
-    if (isnan(value))
-      return writeRaw(ARDUINOJSON_ENABLE_NAN ? "NaN" : "null");
-
-#if ARDUINOJSON_ENABLE_INFINITY
-    if (value < 0.0) {
-      writeRaw('-');
-      value = -value;
-    }
-
-    if (isinf(value))
-      return writeRaw("Infinity");
-#else
-    if (isinf(value))
-      return writeRaw("null");
-
-    if (value < 0.0) {
-      writeRaw('-');
-      value = -value;
-    }
-#endif
+    if (writeSpecialFloat(value))
+      return;
 
     auto parts = decomposeFloat(value, decimalPlaces);
 
@@ -103,6 +90,57 @@ class TextFormatter {
     }
   }
 
+  // Writes the fewest digits that parse back to the same value
+  template <typename T>
+  void writeShortestFloat(T value) {
+    if (writeSpecialFloat(value))
+      return;
+
+    if (value == 0)
+      return writeRaw('0');
+
+    auto decimal = shortestDecimal(value);
+
+    // write the digits in reverse order
+    char buffer[20];
+    char* end = buffer + sizeof(buffer);
+    char* begin = end;
+    do {
+      *--begin = char(decimal.mantissa % 10 + '0');
+      decimal.mantissa /= 10;
+    } while (decimal.mantissa);
+    int digits = int(end - begin);
+
+    if (value >= ARDUINOJSON_POSITIVE_EXPONENTIATION_THRESHOLD ||
+        value <= ARDUINOJSON_NEGATIVE_EXPONENTIATION_THRESHOLD) {
+      writeRaw(*begin);
+      if (digits > 1) {
+        writeRaw('.');
+        writeRaw(begin + 1, end);
+      }
+      writeRaw('e');
+      writeInteger(decimal.exponent + digits - 1);
+      return;
+    }
+
+    // number of digits before the decimal point
+    int point = digits + decimal.exponent;
+    if (decimal.exponent >= 0) {
+      writeRaw(begin, end);
+      for (int i = 0; i < decimal.exponent; i++)
+        writeRaw('0');
+    } else if (point > 0) {
+      writeRaw(begin, begin + point);
+      writeRaw('.');
+      writeRaw(begin + point, end);
+    } else {
+      writeRaw("0.");
+      for (int i = point; i < 0; i++)
+        writeRaw('0');
+      writeRaw(begin, end);
+    }
+  }
+
   template <typename T>
   enable_if_t<is_signed<T>::value> writeInteger(T value) {
     typedef make_unsigned_t<T> unsigned_type;
@@ -171,6 +209,40 @@ class TextFormatter {
   }
 
  protected:
+  // Writes NaN and Infinity, or the minus sign of a negative value.
+  // Returns true if there is nothing left to write.
+  template <typename T>
+  bool writeSpecialFloat(T& value) {
+    if (isnan(value)) {
+      writeRaw(ARDUINOJSON_ENABLE_NAN ? "NaN" : "null");
+      return true;
+    }
+
+#if ARDUINOJSON_ENABLE_INFINITY
+    if (value < 0.0) {
+      writeRaw('-');
+      value = -value;
+    }
+
+    if (isinf(value)) {
+      writeRaw("Infinity");
+      return true;
+    }
+#else
+    if (isinf(value)) {
+      writeRaw("null");
+      return true;
+    }
+
+    if (value < 0.0) {
+      writeRaw('-');
+      value = -value;
+    }
+#endif
+
+    return false;
+  }
+
   CountingDecorator<TWriter> writer_;
 };
 
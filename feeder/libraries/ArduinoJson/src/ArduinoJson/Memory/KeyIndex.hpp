@@ -0,0 +1,204 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+#pragma once
+
+#include <ArduinoJson/Memory/Allocator.hpp>
+#include <ArduinoJson/Memory/MemoryPool.hpp>
+#include <ArduinoJson/Polyfills/assert.hpp>
+#include <ArduinoJson/Polyfills/utility.hpp>
+
+#include <string.h>  // memset
+
+ARDUINOJSON_BEGIN_PRIVATE_NAMESPACE
+
+// Maps the keys of the indexed objects to their slots.
+// It's one open-addressing table with linear probing for all the objects of
+// the document; an object is identified by the id of its first slot, which
+// doesn't change when the document moves or shrinks.
+// Each indexed object also has a marker entry (key == NULL_SLOT), so that an
+// indexed object that lacks a key can be told from an object without index.
+// The table is a cache: when it can't grow, the objects are searched linearly.
+class KeyIndex {
+  struct Entry {
+    uint32_t hash;
+    SlotId object;  // NULL_SLOT for an empty entry
+    SlotId key;     // NULL_SLOT for the marker
+  };
+
+  static const size_t initialCapacity = 16;  // must be a power of two
+
+ public:
+  KeyIndex() = default;
+  KeyIndex(const KeyIndex&) = delete;
+  void operator=(const KeyIndex&) = delete;
+
+  ~KeyIndex() {
+    ARDUINOJSON_ASSERT(table_ == nullptr);
+  }
+
+  friend void swap(KeyIndex& a, KeyIndex& b) {
+    swap_(a.table_, b.table_);
+    swap_(a.capacity_, b.capacity_);
+    swap_(a.count_, b.count_);
+  }
+
+  void clear(Allocator* allocator) {
+    if (table_)
+      allocator->deallocate(table_);
+    table_ = nullptr;
+    capacity_ = 0;
+    count_ = 0;
+  }
+
+  size_t size() const {
+    return capacity_ * sizeof(Entry);
+  }
+
+  bool contains(SlotId object) const {
+    return count_ > 0 && findEntry(object, NULL_SLOT, markerHash(object));
+  }
+
+  // Returns the first key of the object with this hash that matches,
+  // or NULL_SLOT.
+  // TMatches is a function object that takes the id of a key slot.
+  template <typename TMatches>
+  SlotId find(SlotId object, uint32_t keyHash, TMatches matches) const {
+    if (!table_)
+      return NULL_SLOT;
+    auto hash = entryHash(object, keyHash);
+    for (size_t i = home(hash); table_[i].object != NULL_SLOT;
+         i = nextEntry(i)) {
+      const Entry& entry = table_[i];
+      if (entry.hash == hash && entry.object == object &&
+          entry.key != NULL_SLOT && matches(entry.key))
+        return entry.key;
+    }
+    return NULL_SLOT;
+  }
+
+  // Makes room for n more entries.
+  // Returns false if the table can't grow.
+  bool reserve(size_t n, Allocator* allocator) {
+    size_t capacity = capacity_ ? capacity_ : initialCapacity;
+    while ((count_ + n) * 4 > capacity * 3) {
+      if (capacity > size_t(-1) / sizeof(Entry) / 2)  // integer overflow
+        return false;  // (not testable on 64-bit)
+      capacity *= 2;
+    }
+    return capacity == capacity_ || resize(capacity, allocator);
+  }
+
+  bool addObject(SlotId object, Allocator* allocator) {
+    return insert(object, NULL_SLOT, markerHash(object), allocator);
+  }
+
+  void removeObject(SlotId object) {
+    removeEntry(object, NULL_SLOT, markerHash(object));
+  }
+
+  bool addKey(SlotId object, SlotId key, uint32_t keyHash,
+              Allocator* allocator) {
+    ARDUINOJSON_ASSERT(key != NULL_SLOT);
+    return insert(object, key, entryHash(object, keyHash), allocator);
+  }
+
+  // Does nothing if the key isn't in the table, e.g., after a duplicate key
+  void removeKey(SlotId object, SlotId key, uint32_t keyHash) {
+    ARDUINOJSON_ASSERT(key != NULL_SLOT);
+    removeEntry(object, key, entryHash(object, keyHash));
+  }
+
+ private:
+  static uint32_t entryHash(SlotId object, uint32_t keyHash) {
+    return keyHash ^ (uint32_t(object) * 2654435761u);
+  }
+
+  static uint32_t markerHash(SlotId object) {
+    return entryHash(object, 0);
+  }
+
+  size_t home(uint32_t hash) const {
+    return hash & (capacity_ - 1);
+  }
+
+  size_t nextEntry(size_t i) const {
+    return (i + 1) & (capacity_ - 1);
+  }
+
+  Entry* findEntry(SlotId object, SlotId key, uint32_t hash) const {
+    if (!table_)
+      return nullptr;
+    for (size_t i = home(hash); table_[i].object != NULL_SLOT;
+         i = nextEntry(i)) {
+      if (table_[i].object == object && table_[i].key == key)
+        return &table_[i];
+    }
+    return nullptr;
+  }
+
+  bool insert(SlotId object, SlotId key, uint32_t hash, Allocator* allocator) {
+    ARDUINOJSON_ASSERT(object != NULL_SLOT);
+    if (!reserve(1, allocator))
+      return false;
+    place({hash, object, key});
+    return true;
+  }
+
+  void place(const Entry& entry) {
+    size_t i = home(entry.hash);
+    while (table_[i].object != NULL_SLOT)
+      i = nextEntry(i);
+    table_[i] = entry;
+    count_++;
+  }
+
+  // Backward-shift deletion, like in StringPool
+  void removeEntry(SlotId object, SlotId key, uint32_t hash) {
+    auto entry = findEntry(object, key, hash);
+    if (!entry)
+      return;
+    size_t hole = size_t(entry - table_);
+    for (size_t i = nextEntry(hole); table_[i].object != NULL_SLOT;
+         i = nextEntry(i)) {
+      size_t mask = capacity_ - 1;
+      size_t distanceFromHome = (i - home(table_[i].hash)) & mask;
+      size_t distanceFromHole = (i - hole) & mask;
+      if (distanceFromHome >= distanceFromHole) {
+        table_[hole] = table_[i];
+        hole = i;
+      }
+    }
+    table_[hole].object = NULL_SLOT;
+    count_--;
+  }
+
+  bool resize(size_t newCapacity, Allocator* allocator) {
+    auto newTable = reinterpret_cast<Entry*>(
+        allocator->allocate(newCapacity * sizeof(Entry)));
+    if (!newTable)
+      return false;
+    // NULL_SLOT is all ones
+    memset(newTable, 0xff, newCapacity * sizeof(Entry));
+
+    auto oldTable = table_;
+    auto oldCapacity = capacity_;
+    table_ = newTable;
+    capacity_ = newCapacity;
+    count_ = 0;
+    for (size_t i = 0; i < oldCapacity; i++) {
+      if (oldTable[i].object != NULL_SLOT)
+        place(oldTable[i]);
+    }
+    if (oldTable)
+      allocator->deallocate(oldTable);
+    return true;
+  }
+
+  Entry* table_ = nullptr;
+  size_t capacity_ = 0;
+  size_t count_ = 0;
+};
+
+ARDUINOJSON_END_PRIVATE_NAMESPACE
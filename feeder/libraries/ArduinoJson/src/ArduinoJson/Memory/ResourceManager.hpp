@@ -5,6 +5,7 @@
 #pragma once
 
 #include <ArduinoJson/Memory/Allocator.hpp>
+#include <ArduinoJson/Memory/KeyIndex.hpp>
 #include <ArduinoJson/Memory/MemoryPoolList.hpp>
 #include <ArduinoJson/Memory/StringPool.hpp>
 #include <ArduinoJson/Polyfills/assert.hpp>
@@ -34,6 +35,9 @@ class ResourceManager {
   ~ResourceManager() {
     stringPool_.clear(allocator_);
     variantPools_.clear(allocator_);
+#if ARDUINOJSON_OBJECT_KEY_INDEX
+    keyIndex_.clear(allocator_);
+#endif
   }
 
   ResourceManager(const ResourceManager&) = delete;
@@ -42,6 +46,9 @@ class ResourceManager {
   friend void swap(ResourceManager& a, ResourceManager& b) {
     swap(a.stringPool_, b.stringPool_);
     swap(a.variantPools_, b.variantPools_);
+#if ARDUINOJSON_OBJECT_KEY_INDEX
+    swap(a.keyIndex_, b.keyIndex_);
+#endif
     swap_(a.allocator_, b.allocator_);
     swap_(a.overflowed_, b.overflowed_);
   }
@@ -51,7 +58,11 @@ class ResourceManager {
   }
 
   size_t size() const {
+#if ARDUINOJSON_OBJECT_KEY_INDEX
+    return variantPools_.size() + stringPool_.size() + keyIndex_.size();
+#else
     return variantPools_.size() + stringPool_.size();
+#endif
   }
 
   bool overflowed() const {
@@ -90,6 +101,11 @@ class ResourceManager {
   }
 
   StringNode* createString(size_t length) {
+    // Room in the pool first, so that saveString(StringNode*) can't fail
+    if (!stringPool_.reserve(allocator_)) {
+      overflowed_ = true;
+      return nullptr;
+    }
     auto node = StringNode::create(length, allocator_);
     if (!node)
       overflowed_ = true;
@@ -115,17 +131,30 @@ class ResourceManager {
     variantPools_.clear(allocator_);
     overflowed_ = false;
     stringPool_.clear(allocator_);
+#if ARDUINOJSON_OBJECT_KEY_INDEX
+    keyIndex_.clear(allocator_);
+#endif
   }
 
   void shrinkToFit() {
     variantPools_.shrinkToFit(allocator_);
   }
 
+#if ARDUINOJSON_OBJECT_KEY_INDEX
+  // The index is a cache, so const lookups can fill it
+  KeyIndex* keyIndex() const {
+    return &keyIndex_;
+  }
+#endif
+
  private:
   Allocator* allocator_;
   bool overflowed_;
   StringPool stringPool_;
   MemoryPoolList<SlotData> variantPools_;
+#if ARDUINOJSON_OBJECT_KEY_INDEX
+  mutable KeyIndex keyIndex_;
+#endif
 };
 
 ARDUINOJSON_END_PRIVATE_NAMESPACE
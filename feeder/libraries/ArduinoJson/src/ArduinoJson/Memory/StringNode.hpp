@@ -21,7 +21,12 @@ struct StringNode {
 
   using length_type = uint_t<ARDUINOJSON_STRING_LENGTH_SIZE * 8>;
 
+#if ARDUINOJSON_STRING_POOL_INDEX
+  // The pool finds the node through its hash table instead of a list
+  uint32_t hash;
+#else
   struct StringNode* next;
+#endif
   references_type references;
   length_type length;
   char data[1];
@@ -65,6 +70,13 @@ struct StringNode {
   static void destroy(StringNode* node, Allocator* allocator) {
     allocator->deallocate(node);
   }
+
+  // Returns the node that holds the data of a saved string.
+  static StringNode* fromData(const char* data) {
+    ARDUINOJSON_ASSERT(data != nullptr);
+    return reinterpret_cast<StringNode*>(
+        const_cast<char*>(data) - offsetof(StringNode, data));
+  }
 };
 
 // Returns the size (in bytes) of an string with n characters.
@@ -10,8 +10,192 @@
 #include <ArduinoJson/Polyfills/utility.hpp>
 #include <ArduinoJson/Strings/StringAdapters.hpp>
 
+#include <string.h>  // memset
+
 ARDUINOJSON_BEGIN_PRIVATE_NAMESPACE
 
+#if ARDUINOJSON_STRING_POOL_INDEX
+
+// Stores the strings in an open-addressing hash table with linear probing.
+// The table always keeps an empty slot, so that a probe always ends.
+class StringPool {
+  static const size_t initialCapacity = 8;  // must be a power of two
+
+ public:
+  StringPool() = default;
+  StringPool(const StringPool&) = delete;
+  void operator=(StringPool&& src) = delete;
+
+  ~StringPool() {
+    ARDUINOJSON_ASSERT(table_ == nullptr);
+  }
+
+  friend void swap(StringPool& a, StringPool& b) {
+    swap_(a.table_, b.table_);
+    swap_(a.capacity_, b.capacity_);
+    swap_(a.count_, b.count_);
+  }
+
+  void clear(Allocator* allocator) {
+    for (size_t i = 0; i < capacity_; i++) {
+      if (table_[i])
+        StringNode::destroy(table_[i], allocator);
+    }
+    if (table_)
+      allocator->deallocate(table_);
+    table_ = nullptr;
+    capacity_ = 0;
+    count_ = 0;
+  }
+
+  size_t size() const {
+    size_t total = capacity_ * sizeof(StringNode*);
+    for (size_t i = 0; i < capacity_; i++) {
+      if (table_[i])
+        total += sizeofString(table_[i]->length);
+    }
+    return total;
+  }
+
+  // Makes room in the table for one more string.
+  // Returns false if the table is full and can't grow.
+  bool reserve(Allocator* allocator) {
+    if ((count_ + 1) * 4 <= capacity_ * 3)
+      return true;
+    // A table that can't grow is still usable until its last free slot
+    return grow(allocator) || count_ + 2 <= capacity_;
+  }
+
+  template <typename TAdaptedString>
+  StringNode* add(TAdaptedString str, Allocator* allocator) {
+    ARDUINOJSON_ASSERT(str.isNull() == false);
+
+    auto hash = stringHash(str);
+    auto node = find(str, hash);
+    if (node) {
+      node->references++;
+      return node;
+    }
+
+    if (!reserve(allocator))
+      return nullptr;
+
+    size_t n = str.size();
+
+    node = StringNode::create(n, allocator);
+    if (!node)
+      return nullptr;
+
+    stringGetChars(str, node->data, n);
+    node->data[n] = 0;  // force NUL terminator
+    node->hash = hash;
+    insert(node);
+    return node;
+  }
+
+  // Requires a successful call to reserve() before the node was created
+  void add(StringNode* node) {
+    ARDUINOJSON_ASSERT(node != nullptr);
+    node->hash = stringHash(adaptString(node->data, node->length));
+    insert(node);
+  }
+
+  template <typename TAdaptedString>
+  StringNode* get(const TAdaptedString& str) const {
+    return find(str, stringHash(str));
+  }
+
+  void dereference(const char* s, Allocator* allocator) {
+    auto node = StringNode::fromData(s);
+    if (--node->references > 0)
+      return;
+    remove(node);
+    StringNode::destroy(node, allocator);
+  }
+
+ private:
+  size_t home(uint32_t hash) const {
+    return hash & (capacity_ - 1);
+  }
+
+  size_t nextSlot(size_t i) const {
+    return (i + 1) & (capacity_ - 1);
+  }
+
+  template <typename TAdaptedString>
+  StringNode* find(const TAdaptedString& str, uint32_t hash) const {
+    if (!table_)
+      return nullptr;
+    for (size_t i = home(hash); table_[i]; i = nextSlot(i)) {
+      auto node = table_[i];
+      if (node->hash == hash &&
+          stringEquals(str, adaptString(node->data, node->length)))
+        return node;
+    }
+    return nullptr;
+  }
+
+  void insert(StringNode* node) {
+    ARDUINOJSON_ASSERT(count_ + 1 < capacity_);
+    size_t i = home(node->hash);
+    while (table_[i])
+      i = nextSlot(i);
+    table_[i] = node;
+    count_++;
+  }
+
+  // Backward-shift deletion: moves the following nodes of the cluster up,
+  // so that no probe stops early at the hole
+  void remove(StringNode* node) {
+    size_t hole = home(node->hash);
+    while (table_[hole] != node) {
+      ARDUINOJSON_ASSERT(table_[hole] != nullptr);
+      hole = nextSlot(hole);
+    }
+    for (size_t i = nextSlot(hole); table_[i]; i = nextSlot(i)) {
+      size_t mask = capacity_ - 1;
+      size_t distanceFromHome = (i - home(table_[i]->hash)) & mask;
+      size_t distanceFromHole = (i - hole) & mask;
+      if (distanceFromHome >= distanceFromHole) {
+        table_[hole] = table_[i];
+        hole = i;
+      }
+    }
+    table_[hole] = nullptr;
+    count_--;
+  }
+
+  bool grow(Allocator* allocator) {
+    size_t newCapacity = capacity_ ? capacity_ * 2 : initialCapacity;
+    if (newCapacity > size_t(-1) / sizeof(StringNode*))  // integer overflow
+      return false;  // (not testable on 64-bit)
+    auto newTable = reinterpret_cast<StringNode**>(
+        allocator->allocate(newCapacity * sizeof(StringNode*)));
+    if (!newTable)
+      return false;
+    memset(newTable, 0, newCapacity * sizeof(StringNode*));
+
+    auto oldTable = table_;
+    auto oldCapacity = capacity_;
+    table_ = newTable;
+    capacity_ = newCapacity;
+    count_ = 0;
+    for (size_t i = 0; i < oldCapacity; i++) {
+      if (oldTable[i])
+        insert(oldTable[i]);
+    }
+    if (oldTable)
+      allocator->deallocate(oldTable);
+    return true;
+  }
+
+  StringNode** table_ = nullptr;
+  size_t capacity_ = 0;
+  size_t count_ = 0;
+};
+
+#else
+
 class StringPool {
  public:
   StringPool() = default;
@@ -41,6 +225,10 @@ class StringPool {
     return total;
   }
 
+  bool reserve(Allocator*) {
+    return true;
+  }
+
   template <typename TAdaptedString>
   StringNode* add(TAdaptedString str, Allocator* allocator) {
     ARDUINOJSON_ASSERT(str.isNull() == false);
@@ -99,4 +287,6 @@ class StringPool {
   StringNode* strings_ = nullptr;
 };
 
+#endif
+
 ARDUINOJSON_END_PRIVATE_NAMESPACE
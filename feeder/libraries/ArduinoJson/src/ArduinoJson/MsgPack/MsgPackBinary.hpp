@@ -36,7 +36,6 @@ struct Converter<MsgPackBinary> : private detail::VariantAttorney {
                                                 : 2;
       auto str = resources->createString(src.size() + headerSize);
       if (str) {
-        resources->saveString(str);
         auto ptr = reinterpret_cast<uint8_t*>(str->data);
         switch (headerSize) {
           case 2:
@@ -59,6 +58,7 @@ struct Converter<MsgPackBinary> : private detail::VariantAttorney {
             ARDUINOJSON_ASSERT(false);
         }
         memcpy(ptr + headerSize, src.data(), src.size());
+        resources->saveString(str);  // once filled, as the pool may hash it
         data->setRawString(str);
         return;
       }
@@ -66,13 +66,13 @@ struct Converter<MsgPackExtension> : private detail::VariantAttorney {
 
       auto str = resources->createString(src.size() + 2 + sizeBytes);
       if (str) {
-        resources->saveString(str);
         auto ptr = reinterpret_cast<uint8_t*>(str->data);
         *ptr++ = uint8_t(format);
         for (uint8_t i = 0; i < sizeBytes; i++)
           *ptr++ = uint8_t(src.size() >> (sizeBytes - i - 1) * 8 & 0xff);
         *ptr++ = uint8_t(src.type());
         memcpy(ptr, src.data(), src.size());
+        resources->saveString(str);  // once filled, as the pool may hash it
         data->setRawString(str);
         return;
       }
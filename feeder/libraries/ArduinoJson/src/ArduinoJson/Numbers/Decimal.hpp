@@ -0,0 +1,252 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+#pragma once
+
+#include <ArduinoJson/Numbers/FloatTraits.hpp>
+#include <ArduinoJson/Polyfills/ctype.hpp>
+
+#include <string.h>  // memmove
+
+ARDUINOJSON_BEGIN_PRIVATE_NAMESPACE
+
+// A decimal number with enough digits to round any float exactly.
+// It's slow and uses almost 1KB of stack, so we only use it for the few
+// numbers that the Eisel-Lemire algorithm cannot round.
+// This is the "simple decimal conversion" used by Go's strconv package.
+class Decimal {
+ public:
+  // Reads digits[.digits][(e|E)[+|-]digits], which the caller has validated
+  explicit Decimal(const char* s) {
+    int count = 0;  // significant digits, including the ones we drop
+    bool hasPoint = false;
+    for (;; s++) {
+      if (*s == '.' && !hasPoint) {
+        hasPoint = true;
+        point_ = count;
+        continue;
+      }
+      if (!isdigit(*s))
+        break;
+      if (*s == '0' && count == 0) {  // leading zero
+        point_--;
+        continue;
+      }
+      if (count < maxDigits)
+        digits_[count] = uint8_t(*s - '0');
+      else if (*s != '0')
+        truncated_ = true;
+      count++;
+    }
+    if (!hasPoint)
+      point_ = count;
+    count_ = count;
+    if (count_ > maxDigits)
+      count_ = maxDigits;
+
+    if (*s == 'e' || *s == 'E') {
+      s++;
+      bool negative = *s == '-';
+      if (*s == '-' || *s == '+')
+        s++;
+      int exponent = 0;
+      for (; isdigit(*s); s++) {
+        if (exponent < 100000)
+          exponent = exponent * 10 + (*s - '0');
+      }
+      point_ += negative ? -exponent : exponent;
+    }
+    trim();
+  }
+
+  template <typename T>
+  T toFloat() {
+    using traits = FloatTraits<T>;
+    const int minExponent = 1 - traits::exponent_bias;
+    const int maxExponent = traits::exponent_bias;
+
+    if (count_ == 0 || point_ < -330)
+      return 0;
+    if (point_ > 310)
+      return traits::inf();
+
+    // scale to [0.5, 1)
+    int exponent = 0;
+    while (point_ > 0) {
+      int n = shiftFor(point_);
+      shift(-n);
+      exponent += n;
+    }
+    while (point_ < 0 || (point_ == 0 && digits_[0] < 5)) {
+      int n = shiftFor(-point_);
+      shift(n);
+      exponent -= n;
+    }
+
+    // the mantissa is in [1, 2)
+    exponent--;
+
+    // subnormal: shift the digits instead of the exponent
+    if (exponent < minExponent) {
+      shift(exponent - minExponent);
+      exponent = minExponent;
+    }
+    if (exponent > maxExponent)
+      return traits::inf();
+
+    shift(traits::mantissa_bits + 1);
+    uint64_t mantissa = roundedInteger();
+
+    // rounding may have added a bit
+    if (mantissa == uint64_t(2) << traits::mantissa_bits) {
+      mantissa >>= 1;
+      exponent++;
+      if (exponent > maxExponent)
+        return traits::inf();
+    }
+
+    if (!(mantissa & (uint64_t(1) << traits::mantissa_bits)))
+      exponent = -traits::exponent_bias;  // subnormal
+
+    mantissa &= (uint64_t(1) << traits::mantissa_bits) - 1;
+    return traits::forge(typename traits::mantissa_type(
+        mantissa | uint64_t(exponent + traits::exponent_bias)
+                       << traits::mantissa_bits));
+  }
+
+ private:
+  // largest shift for which the left shift can't overflow a uint64_t
+  static const int maxShift = 60;
+
+  // 768 digits are enough to tell which way a tie rounds
+  static const int maxDigits = 800;
+
+  // binary shift that moves the decimal point by at most n digits
+  static int shiftFor(int n) {
+    static const uint8_t shifts[] = {1, 3, 6, 9, 13, 16, 19, 23, 26};
+    return n < 9 ? shifts[n] : 27;
+  }
+
+  void shift(int k) {
+    if (count_ == 0)
+      return;
+    for (; k > maxShift; k -= maxShift)
+      leftShift(maxShift);
+    for (; k < -maxShift; k += maxShift)
+      rightShift(maxShift);
+    if (k > 0)
+      leftShift(k);
+    else if (k < 0)
+      rightShift(-k);
+  }
+
+  // multiplies by 2^k
+  void leftShift(int k) {
+    // the product has at most floor(k * log10(2)) + 1 more digits
+    int extra = (k * 1233 >> 12) + 1;
+    int r = count_ - 1;
+    int w = count_ + extra - 1;
+    uint64_t n = 0;
+    for (; r >= 0; r--, w--) {
+      n += uint64_t(digits_[r]) << k;
+      n = putDigit(w, n);
+    }
+    for (; n > 0; w--)
+      n = putDigit(w, n);
+
+    int first = w + 1;  // 0 or 1, depending on the number of new digits
+    int end = count_ + extra;
+    if (end > maxDigits)
+      end = maxDigits;
+    memmove(digits_, digits_ + first, size_t(end - first));
+    count_ = end - first;
+    point_ += extra - first;
+    trim();
+  }
+
+  // divides by 2^k
+  void rightShift(int k) {
+    int r = 0, w = 0;
+    uint64_t n = 0;
+    for (; (n >> k) == 0; r++) {
+      if (r >= count_) {
+        if (n == 0) {
+          count_ = 0;
+          return;
+        }
+        while ((n >> k) == 0) {
+          n *= 10;
+          r++;
+        }
+        break;
+      }
+      n = n * 10 + digits_[r];
+    }
+    point_ -= r - 1;
+
+    uint64_t mask = (uint64_t(1) << k) - 1;
+    for (; r < count_; r++) {
+      digits_[w++] = uint8_t(n >> k);
+      n = (n & mask) * 10 + digits_[r];
+    }
+    while (n > 0) {
+      auto digit = uint8_t(n >> k);
+      if (w < maxDigits)
+        digits_[w++] = digit;
+      else if (digit > 0)
+        truncated_ = true;
+      n = (n & mask) * 10;
+    }
+    count_ = w;
+    trim();
+  }
+
+  // stores n % 10 at index i, and returns n / 10
+  uint64_t putDigit(int i, uint64_t n) {
+    uint64_t quotient = n / 10;
+    auto digit = uint8_t(n - 10 * quotient);
+    if (i < maxDigits)
+      digits_[i] = digit;
+    else if (digit > 0)
+      truncated_ = true;
+    return quotient;
+  }
+
+  uint64_t roundedInteger() const {
+    uint64_t n = 0;
+    int i = 0;
+    for (; i < point_ && i < count_; i++)
+      n = n * 10 + digits_[i];
+    for (; i < point_; i++)
+      n *= 10;
+    if (shouldRoundUp())
+      n++;
+    return n;
+  }
+
+  bool shouldRoundUp() const {
+    if (point_ < 0 || point_ >= count_)
+      return false;
+    if (digits_[point_] == 5 && point_ + 1 == count_) {  // tie
+      if (truncated_)
+        return true;
+      return point_ > 0 && digits_[point_ - 1] % 2 != 0;  // round to even
+    }
+    return digits_[point_] >= 5;
+  }
+
+  void trim() {
+    while (count_ > 0 && digits_[count_ - 1] == 0)
+      count_--;
+    if (count_ == 0)
+      point_ = 0;
+  }
+
+  uint8_t digits_[maxDigits];
+  int count_ = 0;
+  int point_ = 0;  // position of the decimal point in digits_
+  bool truncated_ = false;
+};
+
+ARDUINOJSON_END_PRIVATE_NAMESPACE
@@ -0,0 +1,73 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+#pragma once
+
+#include <ArduinoJson/Numbers/FloatTraits.hpp>
+#include <ArduinoJson/Numbers/powerOfFive.hpp>
+
+ARDUINOJSON_BEGIN_PRIVATE_NAMESPACE
+
+// Converts w * 10^q to the nearest float with the Eisel-Lemire algorithm.
+// Returns false when it cannot decide how to round (an exact tie, a product
+// too close to the rounding boundary, or a subnormal result); the caller must
+// then fall back to an exact conversion.
+// https://arxiv.org/abs/2101.11408
+template <typename T>
+inline bool eiselLemire(uint64_t w, int q, T& result) {
+  using traits = FloatTraits<T>;
+  ARDUINOJSON_ASSERT(w != 0);
+
+  // we want 1 more bit for the rounding, and 1 more in case the product has a
+  // leading zero
+  const int shift = 64 - traits::mantissa_bits - 3;
+  const uint64_t mask = (uint64_t(1) << shift) - 1;
+
+  int leadingZeros = countLeadingZeros(w);
+  w <<= leadingZeros;
+
+  uint128_parts factor = powerOfFive(q);
+  uint128_parts product = multiply(w, factor.high);
+
+  // the leading bits are exact, unless the truncated part of the factor can
+  // carry into them
+  if ((product.high & mask) == mask && product.low + w < product.low) {
+    uint128_parts lowProduct = multiply(w, factor.low);
+    uint64_t middle = product.low + lowProduct.high;
+    if (middle < product.low)
+      product.high++;
+    if (middle + 1 == 0 && (product.high & mask) == mask &&
+        lowProduct.low + w < lowProduct.low)
+      return false;
+    product.low = middle;
+  }
+
+  int upperBit = int(product.high >> 63);
+  uint64_t mantissa = product.high >> (upperBit + shift);
+
+  // floor(q * log2(10)) + the bias, adjusted for the normalization of w
+  int exponent = ((217706 * q) >> 16) + 63 + traits::exponent_bias + upperBit -
+                 leadingZeros;
+
+  // an exact tie requires to round to even, which we can't check here
+  if (product.low == 0 && (product.high & mask) == 0 && (mantissa & 3) == 1)
+    return false;
+
+  mantissa += mantissa & 1;
+  mantissa >>= 1;
+  if (mantissa >= (uint64_t(2) << traits::mantissa_bits)) {
+    mantissa = uint64_t(1) << traits::mantissa_bits;
+    exponent++;
+  }
+  mantissa &= ~(uint64_t(1) << traits::mantissa_bits);
+
+  if (exponent < 1 || exponent > 2 * traits::exponent_bias)
+    return false;
+
+  result = traits::forge(typename traits::mantissa_type(
+      mantissa | uint64_t(exponent) << traits::mantissa_bits));
+  return true;
+}
+
+ARDUINOJSON_END_PRIVATE_NAMESPACE
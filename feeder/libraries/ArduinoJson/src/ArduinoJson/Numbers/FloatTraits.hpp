@@ -29,6 +29,13 @@ struct FloatTraits<T, 8 /*64bits*/> {
   typedef int16_t exponent_type;
   static const exponent_type exponent_max = 308;
 
+  // below 10^exponent_min, a 19-digit mantissa rounds to zero
+  static const exponent_type exponent_min = -342;
+  static const short exponent_bias = 1023;
+
+  // largest power of ten in exactPowersOfTen()
+  static const exponent_type exact_exponent_max = 22;
+
   static pgm_ptr<T> positiveBinaryPowersOfTen() {
     ARDUINOJSON_DEFINE_PROGMEM_ARRAY(  //
         uint64_t, factors,
@@ -63,6 +70,38 @@ struct FloatTraits<T, 8 /*64bits*/> {
     return pgm_ptr<T>(reinterpret_cast<const T*>(factors));
   }
 
+  // 1e0 to 1e22, the powers of ten that are exactly representable
+  static pgm_ptr<T> exactPowersOfTen() {
+    ARDUINOJSON_DEFINE_PROGMEM_ARRAY(  //
+        uint64_t, factors,
+        {
+            0x3FF0000000000000,  // 1e0
+            0x4024000000000000,  // 1e1
+            0x4059000000000000,  // 1e2
+            0x408F400000000000,  // 1e3
+            0x40C3880000000000,  // 1e4
+            0x40F86A0000000000,  // 1e5
+            0x412E848000000000,  // 1e6
+            0x416312D000000000,  // 1e7
+            0x4197D78400000000,  // 1e8
+            0x41CDCD6500000000,  // 1e9
+            0x4202A05F20000000,  // 1e10
+            0x42374876E8000000,  // 1e11
+            0x426D1A94A2000000,  // 1e12
+            0x42A2309CE5400000,  // 1e13
+            0x42D6BCC41E900000,  // 1e14
+            0x430C6BF526340000,  // 1e15
+            0x4341C37937E08000,  // 1e16
+            0x4376345785D8A000,  // 1e17
+            0x43ABC16D674EC800,  // 1e18
+            0x43E158E460913D00,  // 1e19
+            0x4415AF1D78B58C40,  // 1e20
+            0x444B1AE4D6E2EF50,  // 1e21
+            0x4480F0CF064DD592,  // 1e22
+        });
+    return pgm_ptr<T>(reinterpret_cast<const T*>(factors));
+  }
+
   static T nan() {
     return forge(0x7ff8000000000000);
   }
@@ -113,6 +152,13 @@ struct FloatTraits<T, 4 /*32bits*/> {
   typedef int8_t exponent_type;
   static const exponent_type exponent_max = 38;
 
+  // below 10^exponent_min, a 19-digit mantissa rounds to zero
+  static const exponent_type exponent_min = -64;
+  static const short exponent_bias = 127;
+
+  // largest power of ten in exactPowersOfTen()
+  static const exponent_type exact_exponent_max = 10;
+
   static pgm_ptr<T> positiveBinaryPowersOfTen() {
     ARDUINOJSON_DEFINE_PROGMEM_ARRAY(uint32_t, factors,
                                      {
@@ -139,6 +185,25 @@ struct FloatTraits<T, 4 /*32bits*/> {
     return pgm_ptr<T>(reinterpret_cast<const T*>(factors));
   }
 
+  // 1e0 to 1e10, the powers of ten that are exactly representable
+  static pgm_ptr<T> exactPowersOfTen() {
+    ARDUINOJSON_DEFINE_PROGMEM_ARRAY(uint32_t, factors,
+                                     {
+                                         0x3f800000,  // 1e0f
+                                         0x41200000,  // 1e1f
+                                         0x42c80000,  // 1e2f
+                                         0x447a0000,  // 1e3f
+                                         0x461c4000,  // 1e4f
+                                         0x47c35000,  // 1e5f
+                                         0x49742400,  // 1e6f
+                                         0x4b189680,  // 1e7f
+                                         0x4cbebc20,  // 1e8f
+                                         0x4e6e6b28,  // 1e9f
+                                         0x501502f9,  // 1e10f
+                                     });
+    return pgm_ptr<T>(reinterpret_cast<const T*>(factors));
+  }
+
   static T forge(uint32_t bits) {
     return alias_cast<T>(bits);
   }
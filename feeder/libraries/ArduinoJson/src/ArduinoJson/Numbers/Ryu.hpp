@@ -0,0 +1,212 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+#pragma once
+
+#include <ArduinoJson/Numbers/FloatTraits.hpp>
+#include <ArduinoJson/Numbers/powerOfFive.hpp>
+
+ARDUINOJSON_BEGIN_PRIVATE_NAMESPACE
+
+// A float written as mantissa * 10^exponent
+struct ShortestDecimal {
+  uint64_t mantissa;
+  int exponent;
+};
+
+// number of bits of the factors returned by pow5() and invPow5()
+const int pow5BitCount = 125;
+
+// ceil(log2(5^e)), or 1 for e == 0
+inline int pow5bits(int e) {
+  return int((uint32_t(e) * 1217359) >> 19) + 1;
+}
+
+// floor(log10(2^e))
+inline int log10Pow2(int e) {
+  return int((uint32_t(e) * 78913) >> 18);
+}
+
+// floor(log10(5^e))
+inline int log10Pow5(int e) {
+  return int((uint32_t(e) * 732923) >> 20);
+}
+
+// The 125 most significant bits of 5^i
+inline uint128_parts pow5(int i) {
+  uint128_parts p = powerOfFive(i);
+  return {p.high >> 3, p.low >> 3 | p.high << 61};
+}
+
+// floor(2^(pow5bits(q) - 1 + 125) / 5^q) + 1
+inline uint128_parts invPow5(int q) {
+  if (q == 0)
+    return {uint64_t(1) << 61, 1};
+  uint128_parts p = powerOfFive(-q);
+  uint128_parts result = {p.high >> 3, (p.low >> 3 | p.high << 61) + 1};
+  if (result.low == 0)
+    result.high++;
+  return result;
+}
+
+// (m * factor) >> shift, with 64 < shift < 128
+inline uint64_t mulShift(uint64_t m, uint128_parts factor, int shift) {
+  ARDUINOJSON_ASSERT(shift > 64 && shift < 128);
+  uint128_parts low = multiply(m, factor.low);
+  uint128_parts high = multiply(m, factor.high);
+  uint64_t middle = low.high + high.low;
+  if (middle < low.high)
+    high.high++;
+  shift -= 64;
+  return high.high << (64 - shift) | middle >> shift;
+}
+
+inline bool multipleOfPowerOf5(uint64_t value, int p) {
+  int count = 0;
+  while (value % 5 == 0) {
+    value /= 5;
+    count++;
+  }
+  return count >= p;
+}
+
+inline bool multipleOfPowerOf2(uint64_t value, int p) {
+  return (value & ((uint64_t(1) << p) - 1)) == 0;
+}
+
+// Finds the decimal with the fewest digits that converts back to value, and,
+// among those, the closest to value.
+// value must be finite and strictly positive.
+// This is Ulf Adams' Ryu algorithm; instead of its two tables of 128-bit
+// powers of five, it derives them from powerOfFive(), which Eisel-Lemire also
+// uses. https://dl.acm.org/doi/10.1145/3192366.3192369
+template <typename T>
+inline ShortestDecimal shortestDecimal(T value) {
+  using traits = FloatTraits<T>;
+  ARDUINOJSON_ASSERT(value > 0);
+
+  uint64_t bits = alias_cast<typename traits::mantissa_type>(value);
+  uint64_t ieeeMantissa = bits & ((uint64_t(1) << traits::mantissa_bits) - 1);
+  int ieeeExponent = int(bits >> traits::mantissa_bits);
+
+  // value == m2 * 2^e2, with two extra bits to represent the halfway points
+  int e2;
+  uint64_t m2;
+  if (ieeeExponent == 0) {  // subnormal
+    e2 = 1 - traits::exponent_bias - traits::mantissa_bits - 2;
+    m2 = ieeeMantissa;
+  } else {
+    e2 = ieeeExponent - traits::exponent_bias - traits::mantissa_bits - 2;
+    m2 = (uint64_t(1) << traits::mantissa_bits) | ieeeMantissa;
+  }
+  bool acceptBounds = (m2 & 1) == 0;  // round to even
+
+  // the halfway points to the neighbors are mv + 2 and mv - 1 - mmShift
+  uint64_t mv = 4 * m2;
+  uint64_t mmShift = ieeeMantissa != 0 || ieeeExponent <= 1;
+  uint64_t mp = mv + 2, mm = mv - 1 - mmShift;
+
+  // convert mv, mp, and mm to base 10
+  uint64_t vr, vp, vm;
+  int e10;
+  bool vmIsTrailingZeros = false;
+  bool vrIsTrailingZeros = false;
+  if (e2 >= 0) {
+    int q = log10Pow2(e2) - (e2 > 3);
+    e10 = q;
+    int shift = -e2 + q + pow5BitCount + pow5bits(q) - 1;
+    uint128_parts factor = invPow5(q);
+    vr = mulShift(mv, factor, shift);
+    vp = mulShift(mp, factor, shift);
+    vm = mulShift(mm, factor, shift);
+    if (q <= 21) {  // otherwise, 5^q doesn't divide numbers below 2^55
+      if (mv % 5 == 0)
+        vrIsTrailingZeros = multipleOfPowerOf5(mv, q);
+      else if (acceptBounds)
+        vmIsTrailingZeros = multipleOfPowerOf5(mm, q);
+      else
+        vp -= multipleOfPowerOf5(mp, q);
+    }
+  } else {
+    int q = log10Pow5(-e2) - (-e2 > 1);
+    e10 = q + e2;
+    int i = -e2 - q;
+    int shift = q - (pow5bits(i) - pow5BitCount);
+    uint128_parts factor = pow5(i);
+    vr = mulShift(mv, factor, shift);
+    vp = mulShift(mp, factor, shift);
+    vm = mulShift(mm, factor, shift);
+    if (q <= 1) {
+      // mv has at least q trailing zero bits, since it's a multiple of 4
+      vrIsTrailingZeros = true;
+      if (acceptBounds)
+        vmIsTrailingZeros = mmShift == 1;
+      else
+        vp--;
+    } else if (q < 63) {
+      vrIsTrailingZeros = multipleOfPowerOf2(mv, q);
+    }
+  }
+
+  // remove the digits that vp and vm have in common
+  int removed = 0;
+  uint64_t lastRemovedDigit = 0;
+  uint64_t output;
+  if (vmIsTrailingZeros || vrIsTrailingZeros) {  // rare
+    while (vp / 10 > vm / 10) {
+      vmIsTrailingZeros &= vm % 10 == 0;
+      vrIsTrailingZeros &= lastRemovedDigit == 0;
+      lastRemovedDigit = vr % 10;
+      vr /= 10;
+      vp /= 10;
+      vm /= 10;
+      removed++;
+    }
+    if (vmIsTrailingZeros) {
+      while (vm % 10 == 0) {
+        vrIsTrailingZeros &= lastRemovedDigit == 0;
+        lastRemovedDigit = vr % 10;
+        vr /= 10;
+        vp /= 10;
+        vm /= 10;
+        removed++;
+      }
+    }
+    // the exact value is ...50...0: round to even
+    if (vrIsTrailingZeros && lastRemovedDigit == 5 && vr % 2 == 0)
+      lastRemovedDigit = 4;
+    output = vr + ((vr == vm && (!acceptBounds || !vmIsTrailingZeros)) ||
+                   lastRemovedDigit >= 5);
+  } else {
+    // only the last removed digit matters, so we remove four at a time, then
+    // two, then one
+    bool roundUp = false;
+    while (vp / 10000 > vm / 10000) {
+      roundUp = vr % 10000 >= 5000;
+      vr /= 10000;
+      vp /= 10000;
+      vm /= 10000;
+      removed += 4;
+    }
+    if (vp / 100 > vm / 100) {
+      roundUp = vr % 100 >= 50;
+      vr /= 100;
+      vp /= 100;
+      vm /= 100;
+      removed += 2;
+    }
+    if (vp / 10 > vm / 10) {
+      roundUp = vr % 10 >= 5;
+      vr /= 10;
+      vp /= 10;
+      vm /= 10;
+      removed++;
+    }
+    output = vr + (vr == vm || roundUp);
+  }
+
+  return {output, e10 + removed};
+}
+
+ARDUINOJSON_END_PRIVATE_NAMESPACE
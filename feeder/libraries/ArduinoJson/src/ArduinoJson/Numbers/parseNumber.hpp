@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <ArduinoJson/Numbers/Decimal.hpp>
+#include <ArduinoJson/Numbers/EiselLemire.hpp>
 #include <ArduinoJson/Numbers/FloatTraits.hpp>
 #include <ArduinoJson/Numbers/JsonFloat.hpp>
 #include <ArduinoJson/Numbers/convertNumber.hpp>
@@ -102,10 +104,131 @@ class Number {
 #endif
 };
 
+#if ARDUINOJSON_EXACT_FLOAT_PARSING
+// Converts mantissa * 10^exponent to the nearest float.
+// mantissa holds the first 19 significant digits; if the number has more,
+// truncated is true, and digits points to the full text.
+template <typename T>
+inline T decimalToFloat(uint64_t mantissa, int exponent, bool truncated,
+                        const char* digits) {
+  using traits = FloatTraits<T>;
+
+  if (mantissa == 0 || exponent < traits::exponent_min)
+    return 0;
+  if (exponent > traits::exponent_max)
+    return traits::inf();
+
+  // Clinger's fast path: when both operands are exact, so is the result
+  if (!truncated && mantissa <= (uint64_t(2) << traits::mantissa_bits) &&
+      exponent >= -traits::exact_exponent_max &&
+      exponent <= traits::exact_exponent_max) {
+    T powerOfTen =
+        traits::exactPowersOfTen()[exponent < 0 ? -exponent : exponent];
+    return exponent < 0 ? T(mantissa) / powerOfTen : T(mantissa) * powerOfTen;
+  }
+
+  // With the dropped digits, the number is between mantissa and mantissa + 1
+  T result, upper;
+  if (eiselLemire(mantissa, exponent, result) &&
+      (!truncated ||
+       (eiselLemire(mantissa + 1, exponent, upper) && upper == result)))
+    return result;
+
+  return Decimal(digits).toFloat<T>();
+}
+
+// Parses digits[.digits][(e|E)[+|-]digits] into a correctly rounded float.
+// s and mantissa are where parseNumber() stopped reading the integer part.
+inline Number parseDecimal(const char* digits, const char* s,
+                           uint64_t mantissa, bool is_negative) {
+  const int maxDigits = 19;  // the most a uint64_t can hold
+  int exponent = 0;
+  bool truncated = false;
+
+  const char* p = digits;
+  while (p < s && *p == '0')
+    p++;
+  int significantDigits = int(s - p);
+
+  // start over if the integer part doesn't fit
+  if (isdigit(*s) || significantDigits > maxDigits) {
+    mantissa = 0;
+    significantDigits = 0;
+    for (s = p; isdigit(*s); s++) {
+      if (significantDigits < maxDigits) {
+        mantissa = mantissa * 10 + uint8_t(*s - '0');
+        significantDigits++;
+      } else {
+        exponent++;
+        if (*s != '0')
+          truncated = true;
+      }
+    }
+  }
+
+  if (*s == '.') {
+    s++;
+    if (mantissa == 0) {
+      while (*s == '0') {
+        exponent--;
+        s++;
+      }
+    }
+    for (; isdigit(*s) && significantDigits < maxDigits; s++) {
+      mantissa = mantissa * 10 + uint8_t(*s - '0');
+      significantDigits++;
+      exponent--;
+    }
+    // remaining digits can't fit in the mantissa
+    for (; isdigit(*s); s++) {
+      if (*s != '0')
+        truncated = true;
+    }
+  }
+
+  if (*s == 'e' || *s == 'E') {
+    s++;
+    bool negative_exponent = false;
+    if (*s == '-') {
+      negative_exponent = true;
+      s++;
+    } else if (*s == '+') {
+      s++;
+    }
+
+    int e = 0;
+    for (; isdigit(*s); s++) {
+      if (e < 100000)  // large enough to saturate
+        e = e * 10 + (*s - '0');
+    }
+    exponent += negative_exponent ? -e : e;
+  }
+
+  // we should be at the end of the string, otherwise it's an error
+  if (*s != '\0')
+    return Number();
+
+#  if ARDUINOJSON_USE_DOUBLE
+  bool isDouble = exponent < -FloatTraits<float>::exponent_max ||
+                  exponent > FloatTraits<float>::exponent_max ||
+                  mantissa > FloatTraits<float>::mantissa_max;
+  if (isDouble) {
+    auto final_result =
+        decimalToFloat<double>(mantissa, exponent, truncated, digits);
+    return Number(is_negative ? -final_result : final_result);
+  } else
+#  endif
+  {
+    auto final_result =
+        decimalToFloat<float>(mantissa, exponent, truncated, digits);
+    return Number(is_negative ? -final_result : final_result);
+  }
+}
+#endif
+
 inline Number parseNumber(const char* s) {
   typedef FloatTraits<JsonFloat> traits;
   typedef largest_type<traits::mantissa_type, JsonUInt> mantissa_t;
-  typedef traits::exponent_type exponent_t;
 
   ARDUINOJSON_ASSERT(s != 0);
 
@@ -135,8 +258,10 @@ inline Number parseNumber(const char* s) {
   if (!isdigit(*s) && *s != '.')
     return Number();
 
+#if ARDUINOJSON_EXACT_FLOAT_PARSING
+  const char* digits = s;
+#endif
   mantissa_t mantissa = 0;
-  exponent_t exponent_offset = 0;
   const mantissa_t maxUint = JsonUInt(-1);
 
   while (isdigit(*s)) {
@@ -162,6 +287,12 @@ inline Number parseNumber(const char* s) {
     }
   }
 
+#if ARDUINOJSON_EXACT_FLOAT_PARSING
+  return parseDecimal(digits, s, mantissa, is_negative);
+#else
+  typedef traits::exponent_type exponent_t;
+  exponent_t exponent_offset = 0;
+
   // avoid mantissa overflow
   while (mantissa > traits::mantissa_max) {
     mantissa /= 10;
@@ -228,6 +359,7 @@ inline Number parseNumber(const char* s) {
     auto final_result = make_float(float(mantissa), exponent);
     return Number(is_negative ? -final_result : final_result);
   }
+#endif
 }
 
 template <typename T>
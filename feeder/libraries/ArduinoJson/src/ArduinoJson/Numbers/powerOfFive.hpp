@@ -0,0 +1,150 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+#pragma once
+
+#include <ArduinoJson/Polyfills/assert.hpp>
+#include <ArduinoJson/Polyfills/pgmspace_generic.hpp>
+
+#include <stdint.h>
+
+ARDUINOJSON_BEGIN_PRIVATE_NAMESPACE
+
+struct uint128_parts {
+  uint64_t high;
+  uint64_t low;
+};
+
+inline uint128_parts multiply(uint64_t a, uint64_t b) {
+#ifdef __SIZEOF_INT128__
+  __extension__ typedef unsigned __int128 uint128_t;
+  uint128_t product = uint128_t(a) * b;
+  return {uint64_t(product >> 64), uint64_t(product)};
+#else
+  uint64_t aLow = uint32_t(a), aHigh = a >> 32;
+  uint64_t bLow = uint32_t(b), bHigh = b >> 32;
+  uint64_t lowLow = aLow * bLow, lowHigh = aLow * bHigh;
+  uint64_t highLow = aHigh * bLow, highHigh = aHigh * bHigh;
+  uint64_t middle = (lowLow >> 32) + uint32_t(lowHigh) + uint32_t(highLow);
+  return {highHigh + (lowHigh >> 32) + (highLow >> 32) + (middle >> 32),
+          (middle << 32) | uint32_t(lowLow)};
+#endif
+}
+
+inline int countLeadingZeros(uint64_t x) {
+  ARDUINOJSON_ASSERT(x != 0);
+#ifdef __GNUC__
+  return __builtin_clzll(x);
+#else
+  int n = 0;
+  while (!(x & 0x8000000000000000)) {
+    x <<= 1;
+    n++;
+  }
+  return n;
+#endif
+}
+
+const int powerOfFiveMin = -342;
+const int powerOfFiveMax = 325;
+
+// Returns the 128 most significant bits of 5^q, rounded down.
+// Instead of a table of 668 entries, we store 5^(27k) and the exact 5^i for
+// i < 27; their product only differs from the expected value by 0, 1, or 2,
+// so we keep that difference in a table of 2-bit corrections.
+inline uint128_parts powerOfFive(int q) {
+  ARDUINOJSON_ASSERT(q >= powerOfFiveMin);
+  ARDUINOJSON_ASSERT(q <= powerOfFiveMax);
+
+  ARDUINOJSON_DEFINE_PROGMEM_ARRAY(
+      uint32_t, largePowers,
+      {
+          0x8049A4AC, 0x0C5811AE, 0x205B896D, 0x777D6278,  // 5^-351
+          0xCF42894A, 0x5DCE35EA, 0x52064CAC, 0x828675B9,  // 5^-324
+          0xA76C5823, 0x38ED2621, 0xAF2AF2B8, 0x0AF6F24E,  // 5^-297
+          0x873E4F75, 0xE2224E68, 0x5A7744A6, 0xE804A291,  // 5^-270
+          0xDA7F5BF5, 0x90966848, 0xAF39A475, 0x506A899E,  // 5^-243
+          0xB080392C, 0xC4349DEC, 0xBD8D794D, 0x96AACFB3,  // 5^-216
+          0x8E938662, 0x882AF53E, 0x547EB47B, 0x7282EE9C,  // 5^-189
+          0xE65829B3, 0x046B0AFA, 0x0CB4A5A3, 0x112A5112,  // 5^-162
+          0xBA121A46, 0x50E4DDEB, 0x92F34D62, 0x616CE413,  // 5^-135
+          0x964E858C, 0x91BA2655, 0x3A6A07F8, 0xD510F86F,  // 5^-108
+          0xF2D56790, 0xAB41C2A2, 0xFAE27299, 0x423FB9C3,  // 5^-81
+          0xC428D05A, 0xA4751E4C, 0xAA97E14C, 0x3C26B886,  // 5^-54
+          0x9E74D1B7, 0x91E07E48, 0x775EA264, 0xCF55347D,  // 5^-27
+          0x80000000, 0x00000000, 0x00000000, 0x00000000,  // 5^0
+          0xCECB8F27, 0xF4200F3A, 0x00000000, 0x00000000,  // 5^27
+          0xA70C3C40, 0xA64E6C51, 0x999090B6, 0x5F67D924,  // 5^54
+          0x86F0AC99, 0xB4E8DAFD, 0x69A028BB, 0x3DED71A3,  // 5^81
+          0xDA01EE64, 0x1A708DE9, 0xE80E6F48, 0x20CC9495,  // 5^108
+          0xB01AE745, 0xB101E9E4, 0x5EC05DCF, 0xF72E7F8F,  // 5^135
+          0x8E41ADE9, 0xFBEBC27D, 0x14588F13, 0xBE847307,  // 5^162
+          0xE5D3EF28, 0x2A242E81, 0x8F1668C8, 0xA86DA5FA,  // 5^189
+          0xB9A74A06, 0x37CE2EE1, 0x6D953E2B, 0xD7173692,  // 5^216
+          0x95F83D0A, 0x1FB69CD9, 0x4ABDAF10, 0x1564F98E,  // 5^243
+          0xF24A01A7, 0x3CF2DCCF, 0xBC633B39, 0x673C8CEC,  // 5^270
+          0xC3B83581, 0x09E84F07, 0x0A862F80, 0xEC4700C8,  // 5^297
+          0x9E19DB92, 0xB4E31BA9, 0x6C07A2C2, 0x6A8346D1,  // 5^324
+      });
+  ARDUINOJSON_DEFINE_PROGMEM_ARRAY(
+      uint32_t, smallPowers,
+      {
+          0x00000000, 0x00000001, 0x00000000, 0x00000005,  // 5^0, 5^1
+          0x00000000, 0x00000019, 0x00000000, 0x0000007D,  // 5^2, 5^3
+          0x00000000, 0x00000271, 0x00000000, 0x00000C35,  // 5^4, 5^5
+          0x00000000, 0x00003D09, 0x00000000, 0x0001312D,  // 5^6, 5^7
+          0x00000000, 0x0005F5E1, 0x00000000, 0x001DCD65,  // 5^8, 5^9
+          0x00000000, 0x009502F9, 0x00000000, 0x02E90EDD,  // 5^10, 5^11
+          0x00000000, 0x0E8D4A51, 0x00000000, 0x48C27395,  // 5^12, 5^13
+          0x00000001, 0x6BCC41E9, 0x00000007, 0x1AFD498D,  // 5^14, 5^15
+          0x00000023, 0x86F26FC1, 0x000000B1, 0xA2BC2EC5,  // 5^16, 5^17
+          0x00000378, 0x2DACE9D9, 0x00001158, 0xE460913D,  // 5^18, 5^19
+          0x000056BC, 0x75E2D631, 0x0001B1AE, 0x4D6E2EF5,  // 5^20, 5^21
+          0x00087867, 0x8326EAC9, 0x002A5A05, 0x8FC295ED,  // 5^22, 5^23
+          0x00D3C21B, 0xCECCEDA1, 0x0422CA8B, 0x0A00A425,  // 5^24, 5^25
+          0x14ADF4B7, 0x320334B9,                          // 5^26
+      });
+  ARDUINOJSON_DEFINE_PROGMEM_ARRAY(
+      uint32_t, corrections,
+      {
+          0x55555551, 0x15010004, 0x41450500, 0x00014000, 0x44541005,
+          0x95655559, 0x44544116, 0x41055405, 0x96525555, 0x10415515,
+          0x41054005, 0x40104044, 0x10040015, 0x00000000, 0x55400000,
+          0x95515569, 0x50401165, 0x00100000, 0x15051554, 0x45155441,
+          0x51055195, 0x00000454, 0x00000000, 0x00000000, 0x00000000,
+          0x00000000, 0x55590000, 0x969965A5, 0x55455505, 0x50501555,
+          0x14545511, 0x00105555, 0x00110100, 0x55155410, 0x45545455,
+          0x44150504, 0x00015414, 0x00100000, 0x00400000, 0x00000004,
+          0x00000000, 0x00000000,
+      });
+
+  auto index = unsigned(q - powerOfFiveMin + 9);  // 0 for 5^-351
+  auto large = pgm_ptr<uint32_t>(largePowers);
+  auto small = pgm_ptr<uint32_t>(smallPowers);
+  unsigned i = index / 27 * 4, j = index % 27 * 2;
+  uint128_parts result = {uint64_t(large[i]) << 32 | large[i + 1],
+                          uint64_t(large[i + 2]) << 32 | large[i + 3]};
+  if (j == 0)
+    return result;
+
+  // 192-bit product, normalized so that the most significant bit is set
+  uint64_t factor = uint64_t(small[j]) << 32 | small[j + 1];
+  uint128_parts low = multiply(result.low, factor);
+  uint128_parts high = multiply(result.high, factor);
+  uint64_t middle = high.low + low.high;
+  if (middle < high.low)
+    high.high++;
+  int shift = countLeadingZeros(high.high);
+  result.high = high.high << shift | middle >> (64 - shift);
+  result.low = middle << shift | low.low >> (64 - shift);
+
+  unsigned k = unsigned(q - powerOfFiveMin);
+  uint32_t correction = (corrections[k / 16] >> (k % 16 * 2)) & 3;
+  result.low += correction;
+  if (result.low < correction)
+    result.high++;
+  return result;
+}
+
+ARDUINOJSON_END_PRIVATE_NAMESPACE
@@ -34,13 +34,27 @@ inline ObjectData::iterator ObjectData::findKey(
     TAdaptedString key, const ResourceManager* resources) const {
   if (key.isNull())
     return iterator();
+#if ARDUINOJSON_OBJECT_KEY_INDEX
+  if (hasKeyIndex(resources))
+    return findIndexedKey(key, resources);
+  size_t scannedSlots = 0;
+#endif
   bool isKey = true;
-  for (auto it = createIterator(resources); !it.done(); it.next(resources)) {
+  auto it = createIterator(resources);
+  for (; !it.done(); it.next(resources)) {
     if (isKey && stringEquals(key, adaptString(it->asString())))
-      return it;
+      break;
     isKey = !isKey;
+#if ARDUINOJSON_OBJECT_KEY_INDEX
+    scannedSlots++;
+#endif
   }
-  return iterator();
+#if ARDUINOJSON_OBJECT_KEY_INDEX
+  // This object is large, so index it for the next lookups
+  if (scannedSlots >= 2 * ARDUINOJSON_OBJECT_KEY_INDEX_THRESHOLD)
+    buildKeyIndex(resources);
+#endif
+  return it;
 }
 
 template <typename TAdaptedString>
@@ -64,6 +78,9 @@ inline VariantData* ObjectData::addMember(TAdaptedString key,
     return nullptr;
 
   CollectionData::appendPair(keySlot, valueSlot, resources);
+#if ARDUINOJSON_OBJECT_KEY_INDEX
+  indexKey(keySlot, resources);
+#endif
 
   return valueSlot.ptr();
 }
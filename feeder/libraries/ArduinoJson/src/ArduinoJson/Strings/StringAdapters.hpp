@@ -70,4 +70,16 @@ static void stringGetChars(TAdaptedString s, char* p, size_t n) {
   }
 }
 
+// FNV-1a
+template <typename TAdaptedString>
+inline uint32_t stringHash(const TAdaptedString& str) {
+  uint32_t hash = 2166136261u;
+  size_t n = str.size();
+  for (size_t i = 0; i < n; i++) {
+    hash ^= static_cast<uint8_t>(str[i]);
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
 ARDUINOJSON_END_PRIVATE_NAMESPACE
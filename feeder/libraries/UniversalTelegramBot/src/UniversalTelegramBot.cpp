@@ -31,6 +31,10 @@
    be closed manually after calling sendGetToTelegram or sendPostToTelegram by
    calling closeClient(); Failure to close connection causes memory leakage and
    SSL errors
+
+   With keepAlive set the functions that normally close the connection leave
+   it open, so consecutive requests share one TLS session. The caller then
+   closes it with closeClient() when done.
  */
 
 #include "UniversalTelegramBot.h"
@@ -62,34 +66,30 @@ String UniversalTelegramBot::buildCommand(const String& cmd) {
   return command;
 }
 
-String UniversalTelegramBot::sendGetToTelegram(const String& command) {
-  String body, headers;
-  
+bool UniversalTelegramBot::sendGetRequest(const String& command) {
   // Connect with api.telegram.org if not already connected
-  if (!client->connected()) {
-    #ifdef TELEGRAM_DEBUG  
-        Serial.println(F("[BOT]Connecting to server"));
-    #endif
-    if (!client->connect(TELEGRAM_HOST, TELEGRAM_SSL_PORT)) {
-      #ifdef TELEGRAM_DEBUG  
-        Serial.println(F("[BOT]Conection error"));
-      #endif
-    }
+  if (!connectClient()) {
+    return false;
   }
-  if (client->connected()) {
 
-    #ifdef TELEGRAM_DEBUG  
-        Serial.println("sending: " + command);
-    #endif  
+  #ifdef TELEGRAM_DEBUG  
+      Serial.println("sending: " + command);
+  #endif  
+
+  client->print(F("GET /"));
+  client->print(command);
+  client->println(F(" HTTP/1.1"));
+  client->println(F("Host:" TELEGRAM_HOST));
+  client->println(F("Accept: application/json"));
+  client->println(F("Cache-Control: no-cache"));
+  client->println();
+  return true;
+}
 
-    client->print(F("GET /"));
-    client->print(command);
-    client->println(F(" HTTP/1.1"));
-    client->println(F("Host:" TELEGRAM_HOST));
-    client->println(F("Accept: application/json"));
-    client->println(F("Cache-Control: no-cache"));
-    client->println();
+String UniversalTelegramBot::sendGetToTelegram(const String& command) {
+  String body, headers;
 
+  if (sendGetRequest(command)) {
     readHTTPAnswer(body, headers);
   }
 
@@ -102,6 +102,10 @@ bool UniversalTelegramBot::readHTTPAnswer(String &body, String &headers) {
   bool finishedHeaders = false;
   bool currentLineIsBlank = true;
   bool responseReceived = false;
+  long contentLength = -1;
+  long bodyLength = 0;
+  String headerLine;
+  bool complete = false;
 
   while (millis() - now < longPoll * 1000 + waitForResponse) {
     while (client->available()) {
@@ -113,8 +117,19 @@ bool UniversalTelegramBot::readHTTPAnswer(String &body, String &headers) {
           finishedHeaders = true;
         } else {
           headers += c;
+          if (c == '\n') {
+            // The body length tells where this response ends on a kept-alive connection
+            headerLine.toLowerCase();
+            if (headerLine.startsWith(F("content-length:"))) {
+              contentLength = headerLine.substring(15).toInt();
+            }
+            headerLine = "";
+          } else if (c != '\r') {
+            headerLine += c;
+          }
         }
       } else {
+        bodyLength++;
         if (ch_count < maxMessageLength) {
           body += c;
           ch_count++;
@@ -123,9 +138,13 @@ bool UniversalTelegramBot::readHTTPAnswer(String &body, String &headers) {
 
       if (c == '\n') currentLineIsBlank = true;
       else if (c != '\r') currentLineIsBlank = false;
+
+      if (finishedHeaders && contentLength >= 0 && bodyLength >= contentLength) break;
     }
 
-    if (responseReceived) {
+    // Without a Content-Length the first burst of data is taken as the whole answer
+    complete = finishedHeaders && contentLength >= 0 ? bodyLength >= contentLength : responseReceived;
+    if (complete) {
       #ifdef TELEGRAM_DEBUG  
         Serial.println();
         Serial.println(body);
@@ -134,50 +153,179 @@ bool UniversalTelegramBot::readHTTPAnswer(String &body, String &headers) {
       break;
     }
   }
+
+  // A half-read answer would be mistaken for the next one on a reused connection
+  if (!complete) {
+    closeClient();
+  }
   return responseReceived;
 }
 
-String UniversalTelegramBot::sendPostToTelegram(const String& command, JsonObject payload) {
+// Feeds ArduinoJson straight from the client. Stops at the end of the body so
+// nothing of the next answer on a kept-alive connection is consumed, and gives
+// up when the answer takes longer than the bot waits for one.
+class HttpBodyReader {
+public:
+  HttpBodyReader(Client& client, long contentLength, unsigned long start, unsigned long timeoutMs)
+    : client(client), remaining(contentLength), start(start), timeoutMs(timeoutMs) {}
+
+  int read() {
+    char c;
+    return readBytes(&c, 1) == 1 ? (uint8_t)c : -1;
+  }
 
-  String body;
-  String headers;
+  size_t readBytes(char* buffer, size_t length) {
+    size_t count = 0;
+    while (count < length && remaining != 0) {
+      int available = client.available();
+      if (available <= 0) {
+        if (millis() - start >= timeoutMs) {
+          break;
+        }
+        continue;
+      }
 
-  // Connect with api.telegram.org if not already connected
-  if (!client->connected()) {
-    #ifdef TELEGRAM_DEBUG  
-        Serial.println(F("[BOT Client]Connecting to server"));
-    #endif
-    if (!client->connect(TELEGRAM_HOST, TELEGRAM_SSL_PORT)) {
-      #ifdef TELEGRAM_DEBUG  
-        Serial.println(F("[BOT Client]Conection error"));
-      #endif
+      size_t chunk = min(length - count, (size_t)available);
+      if (remaining > 0 && chunk > (size_t)remaining) {
+        chunk = remaining;
+      }
+      int received = client.read((uint8_t*)buffer + count, chunk);
+      if (received <= 0) {
+        break;
+      }
+      count += received;
+      if (remaining > 0) {
+        remaining -= received;
+      }
     }
+    return count;
   }
-  if (client->connected()) {
-    // POST URI
-    client->print(F("POST /"));
-    client->print(command);
-    client->println(F(" HTTP/1.1"));
-    // Host header
-    client->println(F("Host:" TELEGRAM_HOST));
-    // JSON content type
-    client->println(F("Content-Type: application/json"));
-
-    // Content length
-    int length = measureJson(payload);
-    client->print(F("Content-Length:"));
-    client->println(length);
-    // End of headers
-    client->println();
-    // POST message body
-    String out;
-    serializeJson(payload, out);
-    
-    client->println(out);
-    #ifdef TELEGRAM_DEBUG
-        Serial.println(String("Posting:") + out);
+
+  // Discards what is left of the body; true once all of it was read
+  bool finish() {
+    char buffer[32];
+    if (remaining < 0) {
+      // Without a Content-Length whatever already arrived is taken as the rest
+      while (client.available() > 0 && client.read((uint8_t*)buffer, sizeof(buffer)) > 0) {}
+      return true;
+    }
+    while (remaining > 0 && readBytes(buffer, min((long)sizeof(buffer), remaining)) > 0) {}
+    return remaining == 0;
+  }
+
+private:
+  Client& client;
+  long remaining;
+  unsigned long start;
+  unsigned long timeoutMs;
+};
+
+bool UniversalTelegramBot::readHTTPHeaders(unsigned long start, long& contentLength) {
+  bool currentLineIsBlank = true;
+  String headerLine;
+  contentLength = -1;
+
+  while (millis() - start < longPoll * 1000 + waitForResponse) {
+    while (client->available()) {
+      char c = client->read();
+
+      if (currentLineIsBlank && c == '\n') {
+        return true;
+      }
+      if (c == '\n') {
+        headerLine.toLowerCase();
+        if (headerLine.startsWith(F("content-length:"))) {
+          contentLength = headerLine.substring(15).toInt();
+        }
+        headerLine = "";
+        currentLineIsBlank = true;
+      } else if (c != '\r') {
+        headerLine += c;
+        currentLineIsBlank = false;
+      }
+    }
+  }
+  return false;
+}
+
+// Reads the answer to the request just sent into doc, keeping only what the filter allows
+bool UniversalTelegramBot::readJsonAnswer(JsonDocument& doc, JsonDocument& filter) {
+  unsigned long start = millis();
+  long contentLength;
+  if (!readHTTPHeaders(start, contentLength)) {
+    closeClient();
+    return false;
+  }
+
+  HttpBodyReader body(*client, contentLength, start, longPoll * 1000 + waitForResponse);
+  DeserializationError error = deserializeJson(doc, body, DeserializationOption::Filter(filter));
+
+  // A half-read answer would be mistaken for the next one on a reused connection
+  if (!body.finish() || error) {
+    #ifdef TELEGRAM_DEBUG  
+      Serial.print(F("Failed to read the answer: "));
+      Serial.println(error.c_str());
     #endif
+    closeClient();
+  }
+  return !error;
+}
+
+// Streaming counterpart of checkForOkResponse() for the request just sent
+bool UniversalTelegramBot::checkForOkAnswer() {
+  JsonDocument filter;
+  filter["ok"] = true;
+  filter["result"]["message_id"] = true;
+
+  JsonDocument doc;
+  if (!readJsonAnswer(doc, filter)) {
+    return false;
+  }
+
+  int last_id = doc["result"]["message_id"];
+  if (last_id > 0) last_sent_message_id = last_id;
+
+  return doc["ok"] | false;
+}
+
+bool UniversalTelegramBot::sendPostRequest(const String& command, JsonObject payload) {
+  // Connect with api.telegram.org if not already connected
+  if (!connectClient()) {
+    return false;
+  }
+
+  // POST URI
+  client->print(F("POST /"));
+  client->print(command);
+  client->println(F(" HTTP/1.1"));
+  // Host header
+  client->println(F("Host:" TELEGRAM_HOST));
+  // JSON content type
+  client->println(F("Content-Type: application/json"));
+
+  // Content length
+  int length = measureJson(payload);
+  client->print(F("Content-Length:"));
+  client->println(length);
+  // End of headers
+  client->println();
+  // POST message body
+  String out;
+  serializeJson(payload, out);
+  
+  client->println(out);
+  #ifdef TELEGRAM_DEBUG
+      Serial.println(String("Posting:") + out);
+  #endif
+  return true;
+}
+
+String UniversalTelegramBot::sendPostToTelegram(const String& command, JsonObject payload) {
+
+  String body;
+  String headers;
 
+  if (sendPostRequest(command, payload)) {
     readHTTPAnswer(body, headers);
   }
 
@@ -198,17 +346,7 @@ String UniversalTelegramBot::sendMultipartFormDataToTelegram(
   const String boundary = F("------------------------b8f610217e83e29b");
 
   // Connect with api.telegram.org if not already connected
-  if (!client->connected()) {
-    #ifdef TELEGRAM_DEBUG  
-        Serial.println(F("[BOT Client]Connecting to server"));
-    #endif
-    if (!client->connect(TELEGRAM_HOST, TELEGRAM_SSL_PORT)) {
-      #ifdef TELEGRAM_DEBUG  
-        Serial.println(F("[BOT Client]Conection error"));
-      #endif
-    }
-  }
-  if (client->connected()) {
+  if (connectClient()) {
     String start_request;
     String end_request;
     
@@ -295,7 +433,7 @@ String UniversalTelegramBot::sendMultipartFormDataToTelegram(
     readHTTPAnswer(body, headers);
   }
 
-  closeClient();
+  releaseClient();
   return body;
 }
 
@@ -304,7 +442,7 @@ bool UniversalTelegramBot::getMe() {
   String response = sendGetToTelegram(BOT_CMD("getMe")); // receive reply from telegram.org
   DynamicJsonDocument doc(maxMessageLength);
   DeserializationError error = deserializeJson(doc, ZERO_COPY(response));
-  closeClient();
+  releaseClient();
 
   if (!error) {
     if (doc.containsKey("result")) {
@@ -342,7 +480,7 @@ bool UniversalTelegramBot::setMyCommands(const String& commandArray) {
     if (sent) break;
   }
 
-  closeClient();
+  releaseClient();
   return sent;
 }
 
@@ -352,6 +490,39 @@ bool UniversalTelegramBot::setMyCommands(const String& commandArray) {
  * (Argument to pass: the last+1 message to read)             *
  * Returns the number of new messages           *
  ***************************************************************/
+// Fields processResult() reads, for the streaming parse of getUpdates
+static void buildUpdateFilter(JsonDocument& filter) {
+  JsonObject update = filter["result"].add<JsonObject>();
+  update["update_id"] = true;
+
+  JsonObject message = update["message"].to<JsonObject>();
+  message["message_id"] = true;
+  message["from"]["id"] = true;
+  message["from"]["first_name"] = true;
+  message["date"] = true;
+  message["chat"]["id"] = true;
+  message["chat"]["title"] = true;
+  message["text"] = true;
+  message["location"] = true;
+  message["caption"] = true;
+  message["document"]["file_id"] = true;
+  message["document"]["file_name"] = true;
+  message["reply_to_message"]["message_id"] = true;
+  message["reply_to_message"]["text"] = true;
+
+  update["channel_post"] = message;
+  update["edited_message"] = message;
+
+  JsonObject callback = update["callback_query"].to<JsonObject>();
+  callback["id"] = true;
+  callback["from"] = message["from"];
+  callback["data"] = true;
+  callback["date"] = true;
+  callback["message"]["message_id"] = true;
+  callback["message"]["chat"]["id"] = true;
+  callback["message"]["text"] = true;
+}
+
 int UniversalTelegramBot::getUpdates(long offset) {
 
   #ifdef TELEGRAM_DEBUG  
@@ -366,6 +537,24 @@ int UniversalTelegramBot::getUpdates(long offset) {
     command += F("&timeout=");
     command += String(longPoll);
   }
+  if (streamResponses) {
+    JsonDocument filter;
+    buildUpdateFilter(filter);
+    JsonDocument doc;
+    if (sendGetRequest(command) && readJsonAnswer(doc, filter)) {
+      int newMessageIndex = 0;
+      for (JsonObject result : doc["result"].as<JsonArray>()) {
+        if (processResult(result, newMessageIndex)) newMessageIndex++;
+      }
+      if (newMessageIndex > 0) {
+        // Keep the client open as there may be a response to be given
+        return newMessageIndex;
+      }
+    }
+    releaseClient();
+    return 0;
+  }
+
   String response = sendGetToTelegram(command); // receive reply from telegram.org
 
   if (response == "") {
@@ -373,7 +562,7 @@ int UniversalTelegramBot::getUpdates(long offset) {
         Serial.println(F("Received empty string in response!"));
     #endif
     // close the client as there's nothing to do with an empty string
-    closeClient();
+    releaseClient();
     return 0;
   } else {
     #ifdef TELEGRAM_DEBUG  
@@ -430,7 +619,7 @@ int UniversalTelegramBot::getUpdates(long offset) {
       }
     }
     // Close the client as no response is to be given
-    closeClient();
+    releaseClient();
     return 0;
   }
 }
@@ -555,7 +744,7 @@ bool UniversalTelegramBot::sendSimpleMessage(const String& chat_id, const String
       if (sent) break;
     }
   }
-  closeClient();
+  releaseClient();
   return sent;
 }
 
@@ -641,16 +830,21 @@ bool UniversalTelegramBot::sendPostMessage(JsonObject payload, bool edit) { // a
 
   if (payload.containsKey("text")) {
     while (millis() < sttime + 8000) { // loop for a while to send the message
-        String response = sendPostToTelegram((edit ? BOT_CMD("editMessageText") : BOT_CMD("sendMessage")), payload); // if edit is true we send a editMessageText CMD
-         #ifdef TELEGRAM_DEBUG  
-        Serial.println(response);
-      #endif
-      sent = checkForOkResponse(response);
+      String command = edit ? BOT_CMD("editMessageText") : BOT_CMD("sendMessage"); // if edit is true we send a editMessageText CMD
+      if (streamResponses) {
+        sent = sendPostRequest(command, payload) && checkForOkAnswer();
+      } else {
+        String response = sendPostToTelegram(command, payload);
+        #ifdef TELEGRAM_DEBUG  
+          Serial.println(response);
+        #endif
+        sent = checkForOkResponse(response);
+      }
       if (sent) break;
     }
   }
 
-  closeClient();
+  releaseClient();
   return sent;
 }
 
@@ -675,7 +869,7 @@ String UniversalTelegramBot::sendPostPhoto(JsonObject payload) {
     }
   }
 
-  closeClient();
+  releaseClient();
   return response;
 }
 
@@ -765,10 +959,37 @@ bool UniversalTelegramBot::sendChatAction(const String& chat_id, const String& t
     }
   }
 
-  closeClient();
+  releaseClient();
   return sent;
 }
 
+bool UniversalTelegramBot::connectClient() {
+  if (client->connected()) {
+    reusedConnectionCount++;
+    return true;
+  }
+
+  #ifdef TELEGRAM_DEBUG  
+      Serial.println(F("[BOT Client]Connecting to server"));
+  #endif
+  unsigned long start = millis();
+  if (!client->connect(TELEGRAM_HOST, TELEGRAM_SSL_PORT)) {
+    #ifdef TELEGRAM_DEBUG  
+      Serial.println(F("[BOT Client]Conection error"));
+    #endif
+    return false;
+  }
+  connectionCount++;
+  connectMillis += millis() - start;
+  return client->connected();
+}
+
+void UniversalTelegramBot::releaseClient() {
+  if (!keepAlive) {
+    closeClient();
+  }
+}
+
 void UniversalTelegramBot::closeClient() {
   if (client->connected()) {
     #ifdef TELEGRAM_DEBUG  
@@ -785,7 +1006,7 @@ bool UniversalTelegramBot::getFile(String& file_path, long& file_size, const Str
   String response = sendGetToTelegram(command); // receive reply from telegram.org
   DynamicJsonDocument doc(maxMessageLength);
   DeserializationError error = deserializeJson(doc, ZERO_COPY(response));
-  closeClient();
+  releaseClient();
 
   if (!error) {
     if (doc.containsKey("result")) {
@@ -814,6 +1035,6 @@ bool UniversalTelegramBot::answerCallbackQuery(const String &query_id, const Str
      Serial.println(response);
   #endif
   bool answer = checkForOkResponse(response);
-  closeClient();
+  releaseClient();
   return answer;
 }
@@ -128,11 +128,33 @@ public:
   int last_sent_message_id = 0;
   int maxMessageLength = 1500;
 
+  // Keep the connection open between requests instead of closing it after each
+  // one; call closeClient() when done.
+  bool keepAlive = false;
+  // Parse answers straight from the client instead of collecting the body in a
+  // String first. Only the fields the library reads are kept (ok,
+  // result.message_id and the update fields), so memory and copying no longer
+  // grow with the size of the answer. Applies to getUpdates() and the
+  // sendMessage family; the functions returning the body as a String are unchanged.
+  bool streamResponses = false;
+  // Connection statistics since construction
+  unsigned long connectionCount = 0;
+  unsigned long reusedConnectionCount = 0;
+  unsigned long connectMillis = 0;
+
+  void closeClient();
+
 private:
   // JsonObject * parseUpdates(String response);
   String _token;
   Client *client;
-  void closeClient();
+  bool connectClient();
+  bool sendGetRequest(const String& command);
+  bool sendPostRequest(const String& command, JsonObject payload);
+  bool readHTTPHeaders(unsigned long start, long& contentLength);
+  bool readJsonAnswer(JsonDocument& doc, JsonDocument& filter);
+  bool checkForOkAnswer();
+  void releaseClient();
   bool getFile(String& file_path, long& file_size, const String& file_id);
   bool processResult(JsonObject result, int messageIndex);
 };
@@ -0,0 +1,2 @@
+// The sketch is compiled exactly as the Arduino IDE would see it.
+#include "feeder.ino"
@@ -0,0 +1,133 @@
+#ifndef ARDUINO_H
+#define ARDUINO_H
+
+// Host replacement for the ESP32 Arduino core. Everything that touches time,
+// pins, radio or flash is routed to the simulation (see core/Simulation.h).
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <vector>
+#include <sys/time.h>
+
+#include "WString.h"
+#include "Print.h"
+#include "Stream.h"
+#include "IPAddress.h"
+#include "HardwareSerial.h"
+#include "esp_sleep.h"
+#include "esp_system.h"
+
+using std::max;
+using std::min;
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+typedef uint8_t byte;
+typedef bool boolean;
+typedef uint16_t word;
+
+#define HIGH 0x1
+#define LOW 0x0
+
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define PULLUP 0x04
+#define INPUT_PULLUP 0x05
+#define PULLDOWN 0x08
+#define INPUT_PULLDOWN 0x09
+
+#define LSBFIRST 0
+#define MSBFIRST 1
+
+// Everything lives in one address space on the host, as it does on the ESP32
+#define PROGMEM
+#define PGM_P const char*
+#define PSTR(s) (s)
+#define pgm_read_byte(addr) (*reinterpret_cast<const uint8_t*>(addr))
+#define pgm_read_word(addr) (*reinterpret_cast<const uint16_t*>(addr))
+#define pgm_read_dword(addr) (*reinterpret_cast<const uint32_t*>(addr))
+#define pgm_read_float(addr) (*reinterpret_cast<const float*>(addr))
+#define pgm_read_double(addr) (*reinterpret_cast<const double*>(addr))
+#define pgm_read_ptr(addr) (*(void* const*)(addr))
+#define memcpy_P memcpy
+#define memcmp_P memcmp
+#define strlen_P strlen
+#define strcpy_P strcpy
+#define strncpy_P strncpy
+#define strcmp_P strcmp
+#define strncmp_P strncmp
+#define sprintf_P sprintf
+#define snprintf_P snprintf
+
+#define _BV(bit) (1UL << (bit))
+#define bitRead(value, bit) (((value) >> (bit)) & 0x01)
+
+#define IRAM_ATTR
+#define ICACHE_RAM_ATTR
+#define DRAM_ATTR
+
+// RTC slow memory is a dedicated section so the simulation can keep it across
+// deep sleep and wipe it on power loss. Like the bootloader, a reset loads
+// RTC_DATA_ATTR again, while RTC_NOINIT_ATTR keeps whatever it held; after a
+// power loss it holds a fill pattern instead of zeros.
+#define RTC_DATA_ATTR __attribute__((section("rtc_data"), used))
+#define RTC_NOINIT_ATTR __attribute__((section("rtc_noinit"), used))
+
+typedef int portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED 0
+#define portENTER_CRITICAL(mux) ((void)(mux))
+#define portEXIT_CRITICAL(mux) ((void)(mux))
+#define noInterrupts()
+#define interrupts()
+
+#define RISING 0x01
+#define FALLING 0x02
+#define CHANGE 0x03
+#define digitalPinToInterrupt(pin) (pin)
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+void attachInterrupt(uint8_t pin, void (*handler)(), int mode);
+void detachInterrupt(uint8_t pin);
+
+// LEDC PWM, as in ESP32 Arduino core 3.x: a duty of 2^resolution - 1 is fully on
+bool ledcAttach(uint8_t pin, uint32_t frequency, uint8_t resolution);
+bool ledcWrite(uint8_t pin, uint32_t duty);
+bool ledcDetach(uint8_t pin);
+
+void analogReadResolution(uint8_t bits);
+uint16_t analogRead(uint8_t pin);
+uint32_t analogReadMilliVolts(uint8_t pin);
+
+unsigned long millis();
+unsigned long micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+void yield();
+
+bool getLocalTime(struct tm* info, uint32_t ms = 5000);
+void configTime(long gmtOffsetSec, int daylightOffsetSec, const char* server1, const char* server2 = nullptr, const char* server3 = nullptr);
+
+inline bool isDigit(int c) {
+  return c >= '0' && c <= '9';
+}
+
+inline bool isAlpha(int c) {
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+
+inline bool isAlphaNumeric(int c) {
+  return isAlpha(c) || isDigit(c);
+}
+
+inline bool isSpace(int c) {
+  return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+#endif
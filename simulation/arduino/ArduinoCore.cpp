@@ -0,0 +1,199 @@
+#include <Arduino.h>
+#include <sntp.h>
+#include "Board.h"
+
+using sim::Board;
+using sim::Phase;
+using sim::Simulation;
+
+// One SAR conversion including the driver overhead
+const int64_t ADC_CONVERSION_US = 25;
+// What delay(0) and yield() cost: one pass through the FreeRTOS scheduler
+const int64_t YIELD_US = 100;
+const uint32_t GET_LOCAL_TIME_POLL_MS = 10;
+
+const uint8_t LEDC_MAX_RESOLUTION = 20;
+const uint8_t GPIO_COUNT = 64;
+
+static uint8_t adcResolution = 12;
+static uint8_t ledcResolution[GPIO_COUNT];  // 0 while the pin is not attached
+static sntp_sync_time_cb_t timeSyncCallback = nullptr;
+
+static Simulation& simulation() {
+  return Board::get().simulation();
+}
+
+void pinMode(uint8_t pin, uint8_t mode) {
+  simulation().pinMode(pin, mode);
+}
+
+void digitalWrite(uint8_t pin, uint8_t value) {
+  simulation().digitalWrite(pin, value);
+}
+
+int digitalRead(uint8_t pin) {
+  return simulation().digitalRead(pin);
+}
+
+void attachInterrupt(uint8_t pin, void (*handler)(), int mode) {
+  simulation().attachInterrupt(pin, handler, mode);
+}
+
+void detachInterrupt(uint8_t pin) {
+  simulation().detachInterrupt(pin);
+}
+
+bool ledcAttach(uint8_t pin, uint32_t frequency, uint8_t resolution) {
+  if (pin >= GPIO_COUNT || frequency == 0 || resolution == 0 || resolution > LEDC_MAX_RESOLUTION) {
+    return false;
+  }
+  ledcResolution[pin] = resolution;
+  simulation().pinMode(pin, OUTPUT);
+  simulation().pwmWrite(pin, 0);
+  return true;
+}
+
+bool ledcWrite(uint8_t pin, uint32_t duty) {
+  if (pin >= GPIO_COUNT || ledcResolution[pin] == 0) {
+    return false;
+  }
+  uint32_t maxDuty = (1u << ledcResolution[pin]) - 1;
+  simulation().pwmWrite(pin, duty >= maxDuty ? 1.0 : static_cast<double>(duty) / (maxDuty + 1));
+  return true;
+}
+
+bool ledcDetach(uint8_t pin) {
+  if (pin >= GPIO_COUNT || ledcResolution[pin] == 0) {
+    return false;
+  }
+  ledcResolution[pin] = 0;
+  simulation().pwmWrite(pin, 0);
+  return true;
+}
+
+void analogReadResolution(uint8_t bits) {
+  adcResolution = bits;
+}
+
+uint16_t analogRead(uint8_t pin) {
+  Board& board = Board::get();
+  Simulation::PhaseScope scope(Phase::Voltage);
+  board.simulation().elapse(ADC_CONVERSION_US, Phase::Voltage);
+
+  if (pin != board.battery().sensePin()) {
+    return 0;
+  }
+
+  uint16_t raw = board.battery().adcRaw();
+  return adcResolution >= 12 ? raw << (adcResolution - 12) : raw >> (12 - adcResolution);
+}
+
+uint32_t analogReadMilliVolts(uint8_t pin) {
+  Board& board = Board::get();
+  Simulation::PhaseScope scope(Phase::Voltage);
+  board.simulation().elapse(ADC_CONVERSION_US, Phase::Voltage);
+
+  return pin == board.battery().sensePin() ? board.battery().adcMilliVolts() : 0;
+}
+
+unsigned long millis() {
+  Simulation& sim = simulation();
+  sim.clockRead();
+  return static_cast<unsigned long>(sim.uptimeUs() / sim::US_PER_MS);
+}
+
+unsigned long micros() {
+  Simulation& sim = simulation();
+  sim.clockRead();
+  return static_cast<unsigned long>(sim.uptimeUs());
+}
+
+void delay(uint32_t ms) {
+  if (ms == 0) {
+    yield();
+    return;
+  }
+  simulation().wait(static_cast<int64_t>(ms) * sim::US_PER_MS);
+}
+
+void delayMicroseconds(uint32_t us) {
+  simulation().poll(us);
+}
+
+void yield() {
+  simulation().poll(YIELD_US);
+}
+
+// Same loop as the ESP32 core: poll the system time until it looks set
+bool getLocalTime(struct tm* info, uint32_t ms) {
+  uint32_t start = millis();
+  time_t now;
+
+  while ((millis() - start) <= ms) {
+    time(&now);
+    localtime_r(&now, info);
+    if (info->tm_year > (2016 - 1900)) {
+      return true;
+    }
+    delay(GET_LOCAL_TIME_POLL_MS);
+  }
+  return false;
+}
+
+void configTime(long gmtOffsetSec, int daylightOffsetSec, const char* server1, const char* server2, const char* server3) {
+  Board::get().network().requestTime([]() {
+    if (timeSyncCallback != nullptr) {
+      struct timeval tv;
+      tv.tv_sec = time(nullptr);
+      tv.tv_usec = 0;
+      timeSyncCallback(&tv);
+    }
+  });
+}
+
+void sntp_set_time_sync_notification_cb(sntp_sync_time_cb_t callback) {
+  timeSyncCallback = callback;
+}
+
+void sntp_set_sync_mode(sntp_sync_mode_t mode) {}
+
+esp_err_t esp_sleep_enable_timer_wakeup(uint64_t timeInUs) {
+  simulation().requestTimerWakeup(timeInUs);
+  return ESP_OK;
+}
+
+esp_sleep_wakeup_cause_t esp_sleep_get_wakeup_cause() {
+  const std::vector<sim::WakeRecord>& wakes = simulation().meter().wakes();
+  return wakes.empty() || wakes.back().coldBoot || wakes.back().brownout ? ESP_SLEEP_WAKEUP_UNDEFINED : ESP_SLEEP_WAKEUP_TIMER;
+}
+
+esp_reset_reason_t esp_reset_reason() {
+  const std::vector<sim::WakeRecord>& wakes = simulation().meter().wakes();
+  if (wakes.empty() || wakes.back().coldBoot) {
+    return ESP_RST_POWERON;
+  }
+  return wakes.back().brownout ? ESP_RST_BROWNOUT : ESP_RST_DEEPSLEEP;
+}
+
+void esp_deep_sleep_start() {
+  throw sim::DeepSleep();
+}
+
+// The firmware's time() is the ESP32 system clock, not the host's
+extern "C" time_t time(time_t* out) __THROW {
+  Simulation* sim = Simulation::current();
+  time_t now = 0;
+
+  if (sim != nullptr) {
+    now = static_cast<time_t>(sim->espClockUs() / sim::US_PER_SECOND);
+  } else {
+    struct timespec host;
+    clock_gettime(CLOCK_REALTIME, &host);
+    now = host.tv_sec;
+  }
+
+  if (out != nullptr) {
+    *out = now;
+  }
+  return now;
+}
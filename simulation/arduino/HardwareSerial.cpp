@@ -0,0 +1,73 @@
+#include "HardwareSerial.h"
+#include <cstdio>
+#include "Simulation.h"
+
+using sim::Phase;
+using sim::Simulation;
+
+// UART0 hardware TX FIFO
+const size_t TX_FIFO_BYTES = 128;
+const double BITS_PER_BYTE = 10;
+
+HardwareSerial Serial;
+
+// Time (uptime, us) at which the FIFO runs empty
+static double fifoEmptyUs = 0;
+
+void HardwareSerial::begin(unsigned long baud) {
+  this->baud = baud;
+  fifoEmptyUs = 0;
+}
+
+void HardwareSerial::end() {
+  baud = 0;
+  fifoEmptyUs = 0;
+}
+
+size_t HardwareSerial::write(uint8_t c) {
+  return write(&c, 1);
+}
+
+size_t HardwareSerial::write(const uint8_t* buffer, size_t size) {
+  Simulation* simulation = Simulation::current();
+  if (baud == 0 || simulation == nullptr || !simulation->isAwake()) {
+    return size;
+  }
+
+  if (simulation->config().verbose) {
+    fwrite(buffer, 1, size, stdout);
+  }
+
+  Simulation::PhaseScope scope(Phase::Serial);
+  double byteUs = BITS_PER_BYTE * 1e6 / baud;
+
+  for (size_t i = 0; i < size; ++i) {
+    double now = static_cast<double>(simulation->uptimeUs());
+    if (fifoEmptyUs < now) {
+      fifoEmptyUs = now;
+    }
+
+    // Block until there is room for one more byte
+    double fullUntil = fifoEmptyUs - (TX_FIFO_BYTES - 1) * byteUs;
+    if (fullUntil > now) {
+      simulation->elapse(static_cast<int64_t>(fullUntil - now + 0.999), Phase::Serial);
+    }
+
+    fifoEmptyUs += byteUs;
+  }
+
+  return size;
+}
+
+void HardwareSerial::flush() {
+  Simulation* simulation = Simulation::current();
+  if (baud == 0 || simulation == nullptr) {
+    return;
+  }
+
+  Simulation::PhaseScope scope(Phase::Serial);
+  double now = static_cast<double>(simulation->uptimeUs());
+  if (fifoEmptyUs > now) {
+    simulation->elapse(static_cast<int64_t>(fifoEmptyUs - now + 0.999), Phase::Serial);
+  }
+}
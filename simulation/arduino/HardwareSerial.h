@@ -0,0 +1,30 @@
+#ifndef HARDWARE_SERIAL_H
+#define HARDWARE_SERIAL_H
+
+#include "Stream.h"
+
+// UART0. Output costs wall time at the configured baud rate once the TX FIFO
+// is full, which is what the firmware pays for its logging.
+class HardwareSerial : public Stream {
+public:
+  void begin(unsigned long baud);
+  void end();
+
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t* buffer, size_t size) override;
+  using Print::write;
+
+  int available() override { return 0; }
+  int read() override { return -1; }
+  int peek() override { return -1; }
+  void flush() override;
+
+  operator bool() const { return baud != 0; }
+
+private:
+  unsigned long baud = 0;
+};
+
+extern HardwareSerial Serial;
+
+#endif
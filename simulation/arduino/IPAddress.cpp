@@ -0,0 +1,26 @@
+#include "IPAddress.h"
+#include <cstdio>
+
+// Same byte order as the ESP32 core: first octet in the lowest byte
+IPAddress::IPAddress(uint32_t address)
+  : octets{ uint8_t(address), uint8_t(address >> 8), uint8_t(address >> 16), uint8_t(address >> 24) } {}
+
+IPAddress::operator uint32_t() const {
+  return uint32_t(octets[0]) | uint32_t(octets[1]) << 8 | uint32_t(octets[2]) << 16 | uint32_t(octets[3]) << 24;
+}
+
+bool IPAddress::fromString(const char* address) {
+  unsigned int a, b, c, d;
+  char trailing;
+  if (sscanf(address, "%u.%u.%u.%u%c", &a, &b, &c, &d, &trailing) != 4 || a > 255 || b > 255 || c > 255 || d > 255) {
+    return false;
+  }
+  *this = IPAddress(a, b, c, d);
+  return true;
+}
+
+String IPAddress::toString() const {
+  char buffer[16];
+  snprintf(buffer, sizeof(buffer), "%u.%u.%u.%u", octets[0], octets[1], octets[2], octets[3]);
+  return String(buffer);
+}
@@ -0,0 +1,25 @@
+#ifndef IP_ADDRESS_H
+#define IP_ADDRESS_H
+
+#include <cstdint>
+#include "WString.h"
+
+class IPAddress {
+public:
+  IPAddress() : IPAddress(0, 0, 0, 0) {}
+  IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : octets{ a, b, c, d } {}
+  IPAddress(uint32_t address);
+
+  operator uint32_t() const;
+  uint8_t operator[](int index) const { return octets[index]; }
+  bool operator==(const IPAddress& other) const { return uint32_t(*this) == uint32_t(other); }
+  bool operator!=(const IPAddress& other) const { return !(*this == other); }
+
+  bool fromString(const char* address);
+  String toString() const;
+
+private:
+  uint8_t octets[4];
+};
+
+#endif
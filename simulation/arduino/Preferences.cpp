@@ -0,0 +1,267 @@
+#include "Preferences.h"
+#include "Board.h"
+
+using sim::Board;
+using sim::Nvs;
+
+static uint8_t typeCode(Nvs::Type type) {
+  return static_cast<uint8_t>(type);
+}
+
+Preferences::~Preferences() {
+  end();
+}
+
+bool Preferences::begin(const char* name, bool readOnly, const char* partitionLabel) {
+  if (started) {
+    return false;
+  }
+  Board::get().nvs().open(name);
+  space = name;
+  this->readOnly = readOnly;
+  started = true;
+  return true;
+}
+
+void Preferences::end() {
+  if (!started) {
+    return;
+  }
+  Board::get().nvs().close();
+  started = false;
+}
+
+bool Preferences::clear() {
+  return started && !readOnly && Board::get().nvs().clear(space.c_str());
+}
+
+bool Preferences::remove(const char* key) {
+  return started && !readOnly && Board::get().nvs().remove(space.c_str(), key);
+}
+
+template <typename T>
+size_t Preferences::put(const char* key, uint8_t type, T value) {
+  if (!started || readOnly || key == nullptr) {
+    return 0;
+  }
+  return Board::get().nvs().put(space.c_str(), key, static_cast<Nvs::Type>(type), &value, sizeof(T));
+}
+
+template <typename T>
+T Preferences::get(const char* key, uint8_t type, T defaultValue) {
+  if (!started || key == nullptr) {
+    return defaultValue;
+  }
+
+  const Nvs::Entry* entry = Board::get().nvs().get(space.c_str(), key);
+  if (entry == nullptr || typeCode(entry->type) != type || entry->value.size() != sizeof(T)) {
+    return defaultValue;
+  }
+
+  T value;
+  memcpy(&value, entry->value.data(), sizeof(T));
+  return value;
+}
+
+size_t Preferences::putChar(const char* key, int8_t value) {
+  return put(key, typeCode(Nvs::Type::I8), value);
+}
+
+size_t Preferences::putUChar(const char* key, uint8_t value) {
+  return put(key, typeCode(Nvs::Type::U8), value);
+}
+
+size_t Preferences::putShort(const char* key, int16_t value) {
+  return put(key, typeCode(Nvs::Type::I16), value);
+}
+
+size_t Preferences::putUShort(const char* key, uint16_t value) {
+  return put(key, typeCode(Nvs::Type::U16), value);
+}
+
+size_t Preferences::putInt(const char* key, int32_t value) {
+  return put(key, typeCode(Nvs::Type::I32), value);
+}
+
+size_t Preferences::putUInt(const char* key, uint32_t value) {
+  return put(key, typeCode(Nvs::Type::U32), value);
+}
+
+size_t Preferences::putLong(const char* key, int32_t value) {
+  return putInt(key, value);
+}
+
+size_t Preferences::putULong(const char* key, uint32_t value) {
+  return putUInt(key, value);
+}
+
+size_t Preferences::putLong64(const char* key, int64_t value) {
+  return put(key, typeCode(Nvs::Type::I64), value);
+}
+
+size_t Preferences::putULong64(const char* key, uint64_t value) {
+  return put(key, typeCode(Nvs::Type::U64), value);
+}
+
+size_t Preferences::putFloat(const char* key, float value) {
+  return putBytes(key, &value, sizeof(value));
+}
+
+size_t Preferences::putDouble(const char* key, double value) {
+  return putBytes(key, &value, sizeof(value));
+}
+
+size_t Preferences::putBool(const char* key, bool value) {
+  return putUChar(key, value ? 1 : 0);
+}
+
+size_t Preferences::putString(const char* key, const char* value) {
+  if (!started || readOnly || key == nullptr || value == nullptr) {
+    return 0;
+  }
+  return Board::get().nvs().put(space.c_str(), key, Nvs::Type::String, value, strlen(value));
+}
+
+size_t Preferences::putString(const char* key, const String& value) {
+  return putString(key, value.c_str());
+}
+
+size_t Preferences::putBytes(const char* key, const void* value, size_t length) {
+  if (!started || readOnly || key == nullptr || value == nullptr || length == 0) {
+    return 0;
+  }
+  return Board::get().nvs().put(space.c_str(), key, Nvs::Type::Blob, value, length);
+}
+
+bool Preferences::isKey(const char* key) {
+  return getType(key) != PT_INVALID;
+}
+
+PreferenceType Preferences::getType(const char* key) {
+  if (!started || key == nullptr) {
+    return PT_INVALID;
+  }
+
+  const Nvs::Entry* entry = Board::get().nvs().get(space.c_str(), key);
+  if (entry == nullptr) {
+    return PT_INVALID;
+  }
+
+  switch (entry->type) {
+    case Nvs::Type::I8: return PT_I8;
+    case Nvs::Type::U8: return PT_U8;
+    case Nvs::Type::I16: return PT_I16;
+    case Nvs::Type::U16: return PT_U16;
+    case Nvs::Type::I32: return PT_I32;
+    case Nvs::Type::U32: return PT_U32;
+    case Nvs::Type::I64: return PT_I64;
+    case Nvs::Type::U64: return PT_U64;
+    case Nvs::Type::String: return PT_STR;
+    case Nvs::Type::Blob: return PT_BLOB;
+  }
+  return PT_INVALID;
+}
+
+int8_t Preferences::getChar(const char* key, int8_t defaultValue) {
+  return get(key, typeCode(Nvs::Type::I8), defaultValue);
+}
+
+uint8_t Preferences::getUChar(const char* key, uint8_t defaultValue) {
+  return get(key, typeCode(Nvs::Type::U8), defaultValue);
+}
+
+int16_t Preferences::getShort(const char* key, int16_t defaultValue) {
+  return get(key, typeCode(Nvs::Type::I16), defaultValue);
+}
+
+uint16_t Preferences::getUShort(const char* key, uint16_t defaultValue) {
+  return get(key, typeCode(Nvs::Type::U16), defaultValue);
+}
+
+int32_t Preferences::getInt(const char* key, int32_t defaultValue) {
+  return get(key, typeCode(Nvs::Type::I32), defaultValue);
+}
+
+uint32_t Preferences::getUInt(const char* key, uint32_t defaultValue) {
+  return get(key, typeCode(Nvs::Type::U32), defaultValue);
+}
+
+int32_t Preferences::getLong(const char* key, int32_t defaultValue) {
+  return getInt(key, defaultValue);
+}
+
+uint32_t Preferences::getULong(const char* key, uint32_t defaultValue) {
+  return getUInt(key, defaultValue);
+}
+
+int64_t Preferences::getLong64(const char* key, int64_t defaultValue) {
+  return get(key, typeCode(Nvs::Type::I64), defaultValue);
+}
+
+uint64_t Preferences::getULong64(const char* key, uint64_t defaultValue) {
+  return get(key, typeCode(Nvs::Type::U64), defaultValue);
+}
+
+float Preferences::getFloat(const char* key, float defaultValue) {
+  float value = defaultValue;
+  getBytes(key, &value, sizeof(value));
+  return value;
+}
+
+double Preferences::getDouble(const char* key, double defaultValue) {
+  double value = defaultValue;
+  getBytes(key, &value, sizeof(value));
+  return value;
+}
+
+bool Preferences::getBool(const char* key, bool defaultValue) {
+  return getUChar(key, defaultValue ? 1 : 0) == 1;
+}
+
+String Preferences::getString(const char* key, const String& defaultValue) {
+  if (!started || key == nullptr) {
+    return defaultValue;
+  }
+
+  const Nvs::Entry* entry = Board::get().nvs().get(space.c_str(), key);
+  if (entry == nullptr || entry->type != Nvs::Type::String) {
+    return defaultValue;
+  }
+  return String(std::string(entry->value.begin(), entry->value.end()).c_str());
+}
+
+size_t Preferences::getString(const char* key, char* value, size_t maxLength) {
+  if (!started || key == nullptr || value == nullptr) {
+    return 0;
+  }
+
+  const Nvs::Entry* entry = Board::get().nvs().get(space.c_str(), key);
+  if (entry == nullptr || entry->type != Nvs::Type::String || entry->value.size() + 1 > maxLength) {
+    return 0;
+  }
+  memcpy(value, entry->value.data(), entry->value.size());
+  value[entry->value.size()] = '\0';
+  return entry->value.size() + 1;
+}
+
+size_t Preferences::getBytesLength(const char* key) {
+  if (!started || key == nullptr) {
+    return 0;
+  }
+
+  const Nvs::Entry* entry = Board::get().nvs().get(space.c_str(), key);
+  return entry != nullptr && entry->type == Nvs::Type::Blob ? entry->value.size() : 0;
+}
+
+size_t Preferences::getBytes(const char* key, void* buffer, size_t maxLength) {
+  if (!started || key == nullptr || buffer == nullptr) {
+    return 0;
+  }
+
+  const Nvs::Entry* entry = Board::get().nvs().get(space.c_str(), key);
+  if (entry == nullptr || entry->type != Nvs::Type::Blob || entry->value.size() > maxLength) {
+    return 0;
+  }
+  memcpy(buffer, entry->value.data(), entry->value.size());
+  return entry->value.size();
+}
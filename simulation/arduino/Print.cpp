@@ -0,0 +1,140 @@
+#include "Print.h"
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+size_t Print::write(const uint8_t* buffer, size_t size) {
+  size_t written = 0;
+  while (size--) {
+    written += write(*buffer++);
+  }
+  return written;
+}
+
+size_t Print::write(const char* str) {
+  return str ? write(reinterpret_cast<const uint8_t*>(str), strlen(str)) : 0;
+}
+
+size_t Print::write(const char* buffer, size_t size) {
+  return write(reinterpret_cast<const uint8_t*>(buffer), size);
+}
+
+size_t Print::printf(const char* format, ...) {
+  va_list args;
+  va_start(args, format);
+  va_list copy;
+  va_copy(copy, args);
+  int length = vsnprintf(nullptr, 0, format, copy);
+  va_end(copy);
+
+  if (length < 0) {
+    va_end(args);
+    return 0;
+  }
+
+  std::vector<char> buffer(length + 1);
+  vsnprintf(buffer.data(), buffer.size(), format, args);
+  va_end(args);
+  return write(buffer.data(), length);
+}
+
+size_t Print::print(const __FlashStringHelper* str) {
+  return write(reinterpret_cast<const char*>(str));
+}
+
+size_t Print::print(const String& str) {
+  return write(str.c_str(), str.length());
+}
+
+size_t Print::print(const char* str) {
+  return write(str);
+}
+
+size_t Print::print(char c) {
+  return write(static_cast<uint8_t>(c));
+}
+
+size_t Print::print(unsigned char value, int base) {
+  return print(String(value, base));
+}
+
+size_t Print::print(int value, int base) {
+  return print(String(value, base));
+}
+
+size_t Print::print(unsigned int value, int base) {
+  return print(String(value, base));
+}
+
+size_t Print::print(long value, int base) {
+  return print(String(value, base));
+}
+
+size_t Print::print(unsigned long value, int base) {
+  return print(String(value, base));
+}
+
+size_t Print::print(long long value, int base) {
+  return print(String(value, base));
+}
+
+size_t Print::print(unsigned long long value, int base) {
+  return print(String(value, base));
+}
+
+size_t Print::print(double value, int digits) {
+  return print(String(value, digits));
+}
+
+size_t Print::println() {
+  return write("\r\n");
+}
+
+size_t Print::println(const __FlashStringHelper* str) {
+  return print(str) + println();
+}
+
+size_t Print::println(const String& str) {
+  return print(str) + println();
+}
+
+size_t Print::println(const char* str) {
+  return print(str) + println();
+}
+
+size_t Print::println(char c) {
+  return print(c) + println();
+}
+
+size_t Print::println(unsigned char value, int base) {
+  return print(value, base) + println();
+}
+
+size_t Print::println(int value, int base) {
+  return print(value, base) + println();
+}
+
+size_t Print::println(unsigned int value, int base) {
+  return print(value, base) + println();
+}
+
+size_t Print::println(long value, int base) {
+  return print(value, base) + println();
+}
+
+size_t Print::println(unsigned long value, int base) {
+  return print(value, base) + println();
+}
+
+size_t Print::println(long long value, int base) {
+  return print(value, base) + println();
+}
+
+size_t Print::println(unsigned long long value, int base) {
+  return print(value, base) + println();
+}
+
+size_t Print::println(double value, int digits) {
+  return print(value, digits) + println();
+}
@@ -0,0 +1,14 @@
+#ifndef PRINTABLE_H
+#define PRINTABLE_H
+
+#include <cstddef>
+
+class Print;
+
+class Printable {
+public:
+  virtual ~Printable() = default;
+  virtual size_t printTo(Print& p) const = 0;
+};
+
+#endif
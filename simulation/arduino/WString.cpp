@@ -0,0 +1,399 @@
+#include "WString.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+static std::string integerToString(unsigned long long magnitude, bool negative, unsigned char base) {
+  if (base < 2 || base > 36) {
+    base = 10;
+  }
+
+  char buffer[72];
+  char* cursor = buffer + sizeof(buffer) - 1;
+  *cursor = '\0';
+
+  do {
+    int digit = magnitude % base;
+    *--cursor = digit < 10 ? '0' + digit : 'a' + digit - 10;
+    magnitude /= base;
+  } while (magnitude != 0);
+
+  if (negative) {
+    *--cursor = '-';
+  }
+
+  return std::string(cursor);
+}
+
+static std::string signedToString(long long value, unsigned char base) {
+  // Like the ESP32 core, only base 10 keeps the sign
+  if (base == 10 && value < 0) {
+    return integerToString(0ULL - static_cast<unsigned long long>(value), true, base);
+  }
+  return integerToString(static_cast<unsigned long long>(value), false, base);
+}
+
+static std::string floatToString(double value, unsigned int decimalPlaces) {
+  char buffer[64];
+  snprintf(buffer, sizeof(buffer), "%.*f", decimalPlaces, value);
+  return std::string(buffer);
+}
+
+String::String(const char* cstr)
+  : value(cstr ? cstr : "") {}
+
+String::String(const char* cstr, size_t length)
+  : value(cstr ? std::string(cstr, length) : std::string()) {}
+
+String::String(const __FlashStringHelper* str)
+  : String(reinterpret_cast<const char*>(str)) {}
+
+String::String(const std::string& str)
+  : value(str) {}
+
+String::String(char c)
+  : value(1, c) {}
+
+String::String(unsigned char value, unsigned char base)
+  : value(integerToString(value, false, base)) {}
+
+String::String(int value, unsigned char base)
+  : value(signedToString(value, base)) {}
+
+String::String(unsigned int value, unsigned char base)
+  : value(integerToString(value, false, base)) {}
+
+String::String(long value, unsigned char base)
+  : value(signedToString(value, base)) {}
+
+String::String(unsigned long value, unsigned char base)
+  : value(integerToString(value, false, base)) {}
+
+String::String(long long value, unsigned char base)
+  : value(signedToString(value, base)) {}
+
+String::String(unsigned long long value, unsigned char base)
+  : value(integerToString(value, false, base)) {}
+
+String::String(float value, unsigned int decimalPlaces)
+  : value(floatToString(value, decimalPlaces)) {}
+
+String::String(double value, unsigned int decimalPlaces)
+  : value(floatToString(value, decimalPlaces)) {}
+
+String& String::operator=(const char* cstr) {
+  if (cstr) {
+    value.assign(cstr);
+  } else {
+    value.clear();
+  }
+  return *this;
+}
+
+String& String::operator=(const __FlashStringHelper* str) {
+  return *this = reinterpret_cast<const char*>(str);
+}
+
+bool String::reserve(unsigned int size) {
+  value.reserve(size);
+  return true;
+}
+
+bool String::concat(const String& str) {
+  value += str.value;
+  return true;
+}
+
+bool String::concat(const char* cstr) {
+  if (!cstr) {
+    return false;
+  }
+  value += cstr;
+  return true;
+}
+
+bool String::concat(const char* cstr, unsigned int length) {
+  if (!cstr) {
+    return false;
+  }
+  value.append(cstr, length);
+  return true;
+}
+
+bool String::concat(char c) {
+  value += c;
+  return true;
+}
+
+bool String::concat(int num) {
+  return concat(String(num));
+}
+
+bool String::concat(unsigned int num) {
+  return concat(String(num));
+}
+
+bool String::concat(long num) {
+  return concat(String(num));
+}
+
+bool String::concat(unsigned long num) {
+  return concat(String(num));
+}
+
+bool String::concat(long long num) {
+  return concat(String(num));
+}
+
+bool String::concat(unsigned long long num) {
+  return concat(String(num));
+}
+
+bool String::concat(float num) {
+  return concat(String(num));
+}
+
+bool String::concat(double num) {
+  return concat(String(num));
+}
+
+bool String::concat(const __FlashStringHelper* str) {
+  return concat(reinterpret_cast<const char*>(str));
+}
+
+int String::compareTo(const String& s) const {
+  return value.compare(s.value);
+}
+
+bool String::equals(const char* cstr) const {
+  return value == (cstr ? cstr : "");
+}
+
+bool String::equalsIgnoreCase(const String& s) const {
+  if (value.size() != s.value.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < value.size(); i++) {
+    if (tolower(static_cast<unsigned char>(value[i])) != tolower(static_cast<unsigned char>(s.value[i]))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool String::startsWith(const String& prefix) const {
+  return startsWith(prefix, 0);
+}
+
+bool String::startsWith(const String& prefix, unsigned int offset) const {
+  return offset <= value.size() && value.compare(offset, prefix.value.size(), prefix.value) == 0;
+}
+
+bool String::endsWith(const String& suffix) const {
+  return suffix.value.size() <= value.size()
+         && value.compare(value.size() - suffix.value.size(), suffix.value.size(), suffix.value) == 0;
+}
+
+char String::charAt(unsigned int index) const {
+  return index < value.size() ? value[index] : '\0';
+}
+
+void String::setCharAt(unsigned int index, char c) {
+  if (index < value.size()) {
+    value[index] = c;
+  }
+}
+
+char& String::operator[](unsigned int index) {
+  static char dummy;
+  if (index >= value.size()) {
+    dummy = '\0';
+    return dummy;
+  }
+  return value[index];
+}
+
+int String::indexOf(char ch, unsigned int fromIndex) const {
+  size_t position = value.find(ch, fromIndex);
+  return position == std::string::npos ? -1 : static_cast<int>(position);
+}
+
+int String::indexOf(const String& str, unsigned int fromIndex) const {
+  size_t position = value.find(str.value, fromIndex);
+  return position == std::string::npos ? -1 : static_cast<int>(position);
+}
+
+int String::lastIndexOf(char ch) const {
+  size_t position = value.rfind(ch);
+  return position == std::string::npos ? -1 : static_cast<int>(position);
+}
+
+int String::lastIndexOf(const String& str) const {
+  size_t position = value.rfind(str.value);
+  return position == std::string::npos ? -1 : static_cast<int>(position);
+}
+
+String String::substring(unsigned int beginIndex) const {
+  return substring(beginIndex, value.size());
+}
+
+String String::substring(unsigned int beginIndex, unsigned int endIndex) const {
+  if (beginIndex > endIndex) {
+    std::swap(beginIndex, endIndex);
+  }
+  if (beginIndex >= value.size()) {
+    return String();
+  }
+  endIndex = std::min<unsigned int>(endIndex, value.size());
+  return String(value.substr(beginIndex, endIndex - beginIndex));
+}
+
+void String::replace(char find, char replace) {
+  std::replace(value.begin(), value.end(), find, replace);
+}
+
+void String::replace(const String& find, const String& replace) {
+  if (find.value.empty()) {
+    return;
+  }
+  size_t position = 0;
+  while ((position = value.find(find.value, position)) != std::string::npos) {
+    value.replace(position, find.value.size(), replace.value);
+    position += replace.value.size();
+  }
+}
+
+void String::remove(unsigned int index) {
+  if (index < value.size()) {
+    value.erase(index);
+  }
+}
+
+void String::remove(unsigned int index, unsigned int count) {
+  if (index < value.size()) {
+    value.erase(index, count);
+  }
+}
+
+void String::toLowerCase() {
+  for (char& c : value) {
+    c = tolower(static_cast<unsigned char>(c));
+  }
+}
+
+void String::toUpperCase() {
+  for (char& c : value) {
+    c = toupper(static_cast<unsigned char>(c));
+  }
+}
+
+void String::trim() {
+  size_t begin = value.find_first_not_of(" \t\r\n\f\v");
+  if (begin == std::string::npos) {
+    value.clear();
+    return;
+  }
+  size_t end = value.find_last_not_of(" \t\r\n\f\v");
+  value = value.substr(begin, end - begin + 1);
+}
+
+long String::toInt() const {
+  return atol(value.c_str());
+}
+
+float String::toFloat() const {
+  return static_cast<float>(atof(value.c_str()));
+}
+
+double String::toDouble() const {
+  return atof(value.c_str());
+}
+
+bool operator==(const String& lhs, const String& rhs) {
+  return lhs.equals(rhs);
+}
+
+bool operator==(const String& lhs, const char* rhs) {
+  return lhs.equals(rhs);
+}
+
+bool operator==(const char* lhs, const String& rhs) {
+  return rhs.equals(lhs);
+}
+
+bool operator!=(const String& lhs, const String& rhs) {
+  return !lhs.equals(rhs);
+}
+
+bool operator!=(const String& lhs, const char* rhs) {
+  return !lhs.equals(rhs);
+}
+
+bool operator!=(const char* lhs, const String& rhs) {
+  return !rhs.equals(lhs);
+}
+
+bool operator<(const String& lhs, const String& rhs) {
+  return lhs.compareTo(rhs) < 0;
+}
+
+template <typename T>
+static String concatenate(const String& lhs, const T& rhs) {
+  String result(lhs);
+  result.concat(rhs);
+  return result;
+}
+
+String operator+(const String& lhs, const String& rhs) {
+  return concatenate(lhs, rhs);
+}
+
+String operator+(const String& lhs, const char* rhs) {
+  return concatenate(lhs, rhs);
+}
+
+String operator+(const char* lhs, const String& rhs) {
+  return concatenate(String(lhs), rhs);
+}
+
+String operator+(const String& lhs, char rhs) {
+  return concatenate(lhs, rhs);
+}
+
+String operator+(const String& lhs, int rhs) {
+  return concatenate(lhs, rhs);
+}
+
+String operator+(const String& lhs, unsigned int rhs) {
+  return concatenate(lhs, rhs);
+}
+
+String operator+(const String& lhs, long rhs) {
+  return concatenate(lhs, rhs);
+}
+
+String operator+(const String& lhs, unsigned long rhs) {
+  return concatenate(lhs, rhs);
+}
+
+String operator+(const String& lhs, long long rhs) {
+  return concatenate(lhs, rhs);
+}
+
+String operator+(const String& lhs, unsigned long long rhs) {
+  return concatenate(lhs, rhs);
+}
+
+String operator+(const String& lhs, float rhs) {
+  return concatenate(lhs, rhs);
+}
+
+String operator+(const String& lhs, double rhs) {
+  return concatenate(lhs, rhs);
+}
+
+String operator+(const String& lhs, const __FlashStringHelper* rhs) {
+  return concatenate(lhs, rhs);
+}
@@ -0,0 +1,119 @@
+#ifndef WSTRING_H
+#define WSTRING_H
+
+#include <cstddef>
+#include <string>
+
+class __FlashStringHelper;
+#define F(string_literal) (reinterpret_cast<const __FlashStringHelper*>(string_literal))
+
+// Host version of the Arduino String class. Behaves like the ESP32 core one
+// (numeric constructors are explicit, floats print with two decimals).
+class String {
+public:
+  String(const char* cstr = "");
+  String(const char* cstr, size_t length);
+  String(const __FlashStringHelper* str);
+  String(const std::string& str);
+  explicit String(char c);
+  explicit String(unsigned char value, unsigned char base = 10);
+  explicit String(int value, unsigned char base = 10);
+  explicit String(unsigned int value, unsigned char base = 10);
+  explicit String(long value, unsigned char base = 10);
+  explicit String(unsigned long value, unsigned char base = 10);
+  explicit String(long long value, unsigned char base = 10);
+  explicit String(unsigned long long value, unsigned char base = 10);
+  explicit String(float value, unsigned int decimalPlaces = 2);
+  explicit String(double value, unsigned int decimalPlaces = 2);
+
+  String& operator=(const char* cstr);
+  String& operator=(const __FlashStringHelper* str);
+
+  bool reserve(unsigned int size);
+  unsigned int length() const { return value.size(); }
+  bool isEmpty() const { return value.empty(); }
+  const char* c_str() const { return value.c_str(); }
+  const std::string& str() const { return value; }
+
+  bool concat(const String& str);
+  bool concat(const char* cstr);
+  bool concat(const char* cstr, unsigned int length);
+  bool concat(char c);
+  bool concat(int num);
+  bool concat(unsigned int num);
+  bool concat(long num);
+  bool concat(unsigned long num);
+  bool concat(long long num);
+  bool concat(unsigned long long num);
+  bool concat(float num);
+  bool concat(double num);
+  bool concat(const __FlashStringHelper* str);
+
+  template <typename T>
+  String& operator+=(const T& rhs) {
+    concat(rhs);
+    return *this;
+  }
+
+  int compareTo(const String& s) const;
+  bool equals(const String& s) const { return value == s.value; }
+  bool equals(const char* cstr) const;
+  bool equalsIgnoreCase(const String& s) const;
+  bool startsWith(const String& prefix) const;
+  bool startsWith(const String& prefix, unsigned int offset) const;
+  bool endsWith(const String& suffix) const;
+
+  char charAt(unsigned int index) const;
+  void setCharAt(unsigned int index, char c);
+  char operator[](unsigned int index) const { return charAt(index); }
+  char& operator[](unsigned int index);
+
+  int indexOf(char ch, unsigned int fromIndex = 0) const;
+  int indexOf(const String& str, unsigned int fromIndex = 0) const;
+  int lastIndexOf(char ch) const;
+  int lastIndexOf(const String& str) const;
+  String substring(unsigned int beginIndex) const;
+  String substring(unsigned int beginIndex, unsigned int endIndex) const;
+
+  void replace(char find, char replace);
+  void replace(const String& find, const String& replace);
+  void remove(unsigned int index);
+  void remove(unsigned int index, unsigned int count);
+  void toLowerCase();
+  void toUpperCase();
+  void trim();
+
+  long toInt() const;
+  float toFloat() const;
+  double toDouble() const;
+
+private:
+  std::string value;
+};
+
+bool operator==(const String& lhs, const String& rhs);
+bool operator==(const String& lhs, const char* rhs);
+bool operator==(const char* lhs, const String& rhs);
+bool operator!=(const String& lhs, const String& rhs);
+bool operator!=(const String& lhs, const char* rhs);
+bool operator!=(const char* lhs, const String& rhs);
+bool operator<(const String& lhs, const String& rhs);
+
+String operator+(const String& lhs, const String& rhs);
+String operator+(const String& lhs, const char* rhs);
+String operator+(const char* lhs, const String& rhs);
+String operator+(const String& lhs, char rhs);
+String operator+(const String& lhs, int rhs);
+String operator+(const String& lhs, unsigned int rhs);
+String operator+(const String& lhs, long rhs);
+String operator+(const String& lhs, unsigned long rhs);
+String operator+(const String& lhs, long long rhs);
+String operator+(const String& lhs, unsigned long long rhs);
+String operator+(const String& lhs, float rhs);
+String operator+(const String& lhs, double rhs);
+String operator+(const String& lhs, const __FlashStringHelper* rhs);
+
+// Kept for code written against the Arduino API.
+typedef String StringSumHelper;
+
+#endif
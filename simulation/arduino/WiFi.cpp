@@ -0,0 +1,157 @@
+#include "WiFi.h"
+#include "Board.h"
+
+using sim::Board;
+using sim::Network;
+
+// Radio bring-up when the station interface is started
+const int64_t WIFI_START_US = 60 * sim::US_PER_MS;
+const uint32_t WAIT_FOR_CONNECT_POLL_MS = 100;
+const int8_t AP_RSSI = -61;
+
+WiFiClass WiFi;
+
+wl_status_t WiFiClass::begin() {
+  Network& network = Board::get().network();
+  if (network.savedSsid().empty()) {
+    return WL_CONNECT_FAILED;
+  }
+  std::string ssid = network.savedSsid();
+  std::string password = network.savedPassword();
+  return begin(ssid.c_str(), password.c_str());
+}
+
+wl_status_t WiFiClass::begin(const char* ssid, const char* passphrase, int32_t channel, const uint8_t* bssid, bool connect) {
+  if (ssid == nullptr || *ssid == '\0') {
+    return WL_CONNECT_FAILED;
+  }
+
+  if (!(currentMode & WIFI_STA)) {
+    mode(WIFI_STA);
+  }
+
+  Network& network = Board::get().network();
+  network.saveCredentials(ssid, passphrase != nullptr ? passphrase : "");
+  if (connect) {
+    network.connect(ssid, passphrase != nullptr ? passphrase : "", channel, bssid);
+  }
+  return status();
+}
+
+bool WiFiClass::config(IPAddress localIp, IPAddress gateway, IPAddress subnet, IPAddress dns1, IPAddress dns2) {
+  Network::IpConfig config;
+  config.ip = localIp;
+  config.gateway = gateway;
+  config.subnet = subnet;
+  config.dns = dns1 != IPAddress() ? static_cast<uint32_t>(dns1) : static_cast<uint32_t>(gateway);
+  Board::get().network().setStaticConfig(config);
+  return true;
+}
+
+bool WiFiClass::reconnect() {
+  return begin() != WL_CONNECT_FAILED;
+}
+
+bool WiFiClass::disconnect(bool wifiOff, bool eraseAp) {
+  Network& network = Board::get().network();
+  network.disconnect(wifiOff);
+  if (eraseAp) {
+    network.saveCredentials("", "");
+  }
+  if (wifiOff) {
+    currentMode = WIFI_OFF;
+  }
+  return true;
+}
+
+uint8_t WiFiClass::waitForConnectResult(unsigned long timeoutMs) {
+  unsigned long start = millis();
+  while (status() == WL_DISCONNECTED && millis() - start < timeoutMs) {
+    delay(WAIT_FOR_CONNECT_POLL_MS);
+  }
+  return status();
+}
+
+wl_status_t WiFiClass::status() {
+  if (Board::get().simulation().uptimeUs() == 0) {
+    currentMode = WIFI_OFF;  // nothing survives a reset
+  }
+
+  switch (Board::get().network().link()) {
+    case Network::Link::Connecting: return WL_DISCONNECTED;
+    case Network::Link::Connected: return WL_CONNECTED;
+    case Network::Link::Failed: return WL_CONNECT_FAILED;
+    case Network::Link::NoSsid: return WL_NO_SSID_AVAIL;
+    default: return currentMode == WIFI_OFF ? WL_NO_SHIELD : WL_IDLE_STATUS;
+  }
+}
+
+bool WiFiClass::mode(wifi_mode_t mode) {
+  Network& network = Board::get().network();
+  wifi_mode_t previous = currentMode;
+  currentMode = mode;
+
+  if (previous == WIFI_OFF && mode != WIFI_OFF) {
+    Board::get().simulation().elapse(WIFI_START_US, sim::Phase::WiFi);
+  }
+  if (mode == WIFI_OFF) {
+    network.disconnect(true);
+  } else if (!(mode & WIFI_AP)) {
+    network.stopAccessPoint();
+  }
+  return true;
+}
+
+IPAddress WiFiClass::localIP() {
+  return IPAddress(Board::get().network().ipConfig().ip);
+}
+
+IPAddress WiFiClass::gatewayIP() {
+  return IPAddress(Board::get().network().ipConfig().gateway);
+}
+
+IPAddress WiFiClass::subnetMask() {
+  return IPAddress(Board::get().network().ipConfig().subnet);
+}
+
+IPAddress WiFiClass::dnsIP(uint8_t index) {
+  return index == 0 ? IPAddress(Board::get().network().ipConfig().dns) : IPAddress();
+}
+
+String WiFiClass::SSID() {
+  return String(Board::get().network().ssid().c_str());
+}
+
+String WiFiClass::psk() {
+  return String(Board::get().network().savedPassword().c_str());
+}
+
+uint8_t* WiFiClass::BSSID() {
+  if (!Board::get().network().isConnected()) {
+    return nullptr;
+  }
+  memcpy(bssid, sim::AP_BSSID, sizeof(bssid));
+  return bssid;
+}
+
+String WiFiClass::BSSIDstr() {
+  uint8_t* current = BSSID();
+  if (current == nullptr) {
+    return String();
+  }
+  char text[18];
+  snprintf(text, sizeof(text), "%02X:%02X:%02X:%02X:%02X:%02X", current[0], current[1], current[2], current[3], current[4], current[5]);
+  return String(text);
+}
+
+int32_t WiFiClass::channel() {
+  return Board::get().network().channel();
+}
+
+int8_t WiFiClass::RSSI() {
+  return Board::get().network().isConnected() ? AP_RSSI : 0;
+}
+
+String WiFiClass::macAddress() {
+  return String("34:85:18:0A:1B:2C");
+}
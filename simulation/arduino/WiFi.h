@@ -0,0 +1,72 @@
+#ifndef WIFI_H
+#define WIFI_H
+
+#include <Arduino.h>
+
+typedef enum {
+  WL_NO_SHIELD = 255,
+  WL_IDLE_STATUS = 0,
+  WL_NO_SSID_AVAIL = 1,
+  WL_SCAN_COMPLETED = 2,
+  WL_CONNECTED = 3,
+  WL_CONNECT_FAILED = 4,
+  WL_CONNECTION_LOST = 5,
+  WL_DISCONNECTED = 6,
+} wl_status_t;
+
+typedef enum {
+  WIFI_OFF = 0,
+  WIFI_STA = 1,
+  WIFI_AP = 2,
+  WIFI_AP_STA = 3,
+} wifi_mode_t;
+
+// Station side of the ESP32 WiFi class, backed by devices/Network.h.
+class WiFiClass {
+public:
+  wl_status_t begin();
+  wl_status_t begin(const char* ssid, const char* passphrase = nullptr, int32_t channel = 0, const uint8_t* bssid = nullptr, bool connect = true);
+  bool config(IPAddress localIp, IPAddress gateway, IPAddress subnet, IPAddress dns1 = IPAddress(), IPAddress dns2 = IPAddress());
+  bool reconnect();
+  bool disconnect(bool wifiOff = false, bool eraseAp = false);
+  uint8_t waitForConnectResult(unsigned long timeoutMs = 60000);
+
+  wl_status_t status();
+  bool isConnected() {
+    return status() == WL_CONNECTED;
+  }
+
+  bool mode(wifi_mode_t mode);
+  wifi_mode_t getMode() const {
+    return currentMode;
+  }
+  bool persistent(bool persistent) {
+    return true;
+  }
+  bool setAutoReconnect(bool autoReconnect) {
+    return true;
+  }
+  bool setSleep(bool enabled) {
+    return true;
+  }
+
+  IPAddress localIP();
+  IPAddress gatewayIP();
+  IPAddress subnetMask();
+  IPAddress dnsIP(uint8_t index = 0);
+  String SSID();
+  String psk();
+  uint8_t* BSSID();
+  String BSSIDstr();
+  int32_t channel();
+  int8_t RSSI();
+  String macAddress();
+
+private:
+  wifi_mode_t currentMode = WIFI_OFF;
+  uint8_t bssid[6] = {};
+};
+
+extern WiFiClass WiFi;
+
+#endif
@@ -0,0 +1,195 @@
+#include "WiFiClientSecure.h"
+#include <algorithm>
+#include "Board.h"
+
+using sim::Board;
+using sim::Network;
+using sim::Phase;
+using sim::Simulation;
+using sim::TelegramServer;
+
+// One pass of a caller polling available() while nothing has arrived yet
+const int64_t RECEIVE_POLL_US = 100;
+
+static int64_t milliseconds(double ms) {
+  return static_cast<int64_t>(ms * sim::US_PER_MS);
+}
+
+int WiFiClientSecure::connect(IPAddress ip, uint16_t port) {
+  return 0;  // the firmware only ever connects by host name
+}
+
+int WiFiClientSecure::connect(const char* host, uint16_t port) {
+  Board& board = Board::get();
+  Simulation& simulation = board.simulation();
+  Network& network = board.network();
+  TelegramServer& server = board.telegram();
+  const sim::SimulationConfig& config = simulation.config();
+  Simulation::PhaseScope scope(Phase::Telegram);
+
+  stop();
+  if (host == nullptr || strcmp(host, sim::TELEGRAM_API_HOST) != 0 || !network.resolve(host)) {
+    return 0;
+  }
+
+  int64_t start = simulation.uptimeUs();
+  {
+    // SYN/SYN-ACK, then the two TLS flights; the rest of the handshake is crypto on the CPU
+    Network::RadioActivity radio(network);
+    simulation.elapse(milliseconds(3 * config.rttMs), Phase::Telegram);
+  }
+  simulation.elapse(std::max<int64_t>(0, milliseconds(config.tlsFullHandshakeMs - 2 * config.rttMs)), Phase::Telegram);
+
+  if (!network.isConnected()) {
+    return 0;
+  }
+
+  server.stats().connections++;
+  server.stats().fullHandshakes++;
+  server.stats().handshakeUs += simulation.uptimeUs() - start;
+
+  open = true;
+  linkGeneration = network.linkGeneration();
+  lastActivityUs = simulation.trueUs();
+  brokenAtUs = -1;
+  return 1;
+}
+
+size_t WiFiClientSecure::write(uint8_t c) {
+  return write(&c, 1);
+}
+
+size_t WiFiClientSecure::write(const uint8_t* buffer, size_t size) {
+  if (!connected() || size == 0) {
+    return 0;
+  }
+
+  Board& board = Board::get();
+  Simulation& simulation = board.simulation();
+  {
+    Simulation::PhaseScope scope(Phase::Telegram);
+    Network::RadioActivity radio(board.network());
+    simulation.elapse(static_cast<int64_t>(size * simulation.config().airtimeUsPerByte), Phase::Telegram);
+  }
+
+  outgoing.append(reinterpret_cast<const char*>(buffer), size);
+  lastActivityUs = simulation.trueUs();
+  deliverRequests();
+  return size;
+}
+
+// Hands every complete request in the send buffer to the server
+void WiFiClientSecure::deliverRequests() {
+  Board& board = Board::get();
+  Simulation& simulation = board.simulation();
+  const sim::SimulationConfig& config = simulation.config();
+
+  for (;;) {
+    // The bot terminates JSON bodies with println(), leaving a CRLF ahead of the next request
+    size_t start = outgoing.find_first_not_of("\r\n");
+    outgoing.erase(0, start == std::string::npos ? outgoing.size() : start);
+
+    size_t length = TelegramServer::requestLength(outgoing);
+    if (length == 0) {
+      return;
+    }
+
+    std::string request = outgoing.substr(0, length);
+    outgoing.erase(0, length);
+
+    std::string response;
+    if (!board.telegram().handle(request, response)) {
+      brokenAtUs = simulation.trueUs() + milliseconds(config.rttMs);
+      continue;
+    }
+
+    if (readPosition == incoming.size()) {
+      incoming.clear();
+      readPosition = 0;
+    }
+    incoming += response;
+    int64_t airtimeUs = static_cast<int64_t>(response.size() * config.airtimeUsPerByte);
+    incomingReadyAtUs = simulation.trueUs() + milliseconds(config.rttMs + config.telegramServerMs) + airtimeUs;
+  }
+}
+
+bool WiFiClientSecure::dataReady() {
+  return readPosition < incoming.size() && Board::get().simulation().trueUs() >= incomingReadyAtUs;
+}
+
+int WiFiClientSecure::available() {
+  if (dataReady()) {
+    return static_cast<int>(incoming.size() - readPosition);
+  }
+
+  if (connected() && readPosition < incoming.size()) {
+    Board& board = Board::get();
+    Simulation::PhaseScope scope(Phase::Telegram);
+    Network::RadioActivity radio(board.network());
+    board.simulation().elapse(RECEIVE_POLL_US, Phase::Telegram);
+    if (dataReady()) {
+      return static_cast<int>(incoming.size() - readPosition);
+    }
+  } else {
+    Board::get().simulation().poll(RECEIVE_POLL_US);
+  }
+  return 0;
+}
+
+int WiFiClientSecure::read() {
+  if (!dataReady()) {
+    return -1;
+  }
+  lastActivityUs = Board::get().simulation().trueUs();
+  return static_cast<uint8_t>(incoming[readPosition++]);
+}
+
+int WiFiClientSecure::read(uint8_t* buffer, size_t size) {
+  if (!dataReady()) {
+    return -1;
+  }
+  size_t count = std::min(size, incoming.size() - readPosition);
+  memcpy(buffer, incoming.data() + readPosition, count);
+  readPosition += count;
+  lastActivityUs = Board::get().simulation().trueUs();
+  return static_cast<int>(count);
+}
+
+int WiFiClientSecure::peek() {
+  return dataReady() ? static_cast<uint8_t>(incoming[readPosition]) : -1;
+}
+
+void WiFiClientSecure::stop() {
+  if (open && connected()) {
+    // close_notify and FIN
+    Board& board = Board::get();
+    Simulation::PhaseScope scope(Phase::Telegram);
+    Network::RadioActivity radio(board.network());
+    board.simulation().elapse(static_cast<int64_t>(64 * board.simulation().config().airtimeUsPerByte), Phase::Telegram);
+  }
+
+  open = false;
+  outgoing.clear();
+  incoming.clear();
+  readPosition = 0;
+  brokenAtUs = -1;
+}
+
+uint8_t WiFiClientSecure::connected() {
+  if (!open) {
+    return 0;
+  }
+
+  Board& board = Board::get();
+  int64_t now = board.simulation().trueUs();
+  bool alive = board.network().isConnected()
+               && board.network().linkGeneration() == linkGeneration
+               && (brokenAtUs < 0 || now < brokenAtUs)
+               && now - lastActivityUs < sim::TELEGRAM_KEEP_ALIVE_US;
+
+  // Like the real client, data that already arrived stays readable after the peer closed
+  if (!alive && !dataReady()) {
+    open = false;
+  }
+  return open ? 1 : 0;
+}
@@ -0,0 +1,57 @@
+#ifndef WIFI_CLIENT_SECURE_H
+#define WIFI_CLIENT_SECURE_H
+
+#include <string>
+#include "WiFi.h"
+#include "Client.h"
+
+// TLS client talking to the simulated Bot API (devices/TelegramServer.h). Costs
+// DNS, the TCP and TLS handshakes, airtime and server latency on the virtual
+// clock; answers become readable once they would have arrived.
+class WiFiClientSecure : public Client {
+public:
+  void setCACert(const char* rootCA) {
+    caCert = rootCA;
+  }
+  void setInsecure() {
+    caCert = nullptr;
+  }
+  void setHandshakeTimeout(unsigned long handshakeTimeoutSec) {
+    handshakeTimeoutMs = handshakeTimeoutSec * 1000;
+  }
+
+  int connect(IPAddress ip, uint16_t port) override;
+  int connect(const char* host, uint16_t port) override;
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t* buffer, size_t size) override;
+  int available() override;
+  int read() override;
+  int read(uint8_t* buffer, size_t size) override;
+  int peek() override;
+  void flush() override {}
+  void stop() override;
+  uint8_t connected() override;
+  operator bool() override {
+    return connected();
+  }
+
+  using Print::write;
+
+private:
+  const char* caCert = nullptr;
+  unsigned long handshakeTimeoutMs = 120000;
+
+  bool open = false;
+  uint64_t linkGeneration = 0;
+  int64_t lastActivityUs = 0;
+  int64_t brokenAtUs = -1;
+  std::string outgoing;
+  std::string incoming;
+  size_t readPosition = 0;
+  int64_t incomingReadyAtUs = 0;
+
+  void deliverRequests();
+  bool dataReady();
+};
+
+#endif
@@ -0,0 +1,96 @@
+#include "WiFiManager.h"
+#include <string>
+#include "Board.h"
+
+using sim::Board;
+using sim::Network;
+using sim::Phase;
+using sim::Simulation;
+
+// WiFiManager's default wait for a saved network when no connect timeout is set
+const unsigned long DEFAULT_CONNECT_TIMEOUT_MS = 60000;
+
+WiFiManagerParameter::WiFiManagerParameter(const char* id, const char* label, const char* defaultValue, int length)
+  : id(id), label(label), length(length) {
+  setValue(defaultValue, length);
+}
+
+void WiFiManagerParameter::setValue(const char* newValue, int maxLength) {
+  value = newValue != nullptr ? newValue : "";
+  if (maxLength > 0 && static_cast<int>(value.length()) > maxLength) {
+    value = value.substring(0, maxLength);
+  }
+}
+
+bool WiFiManager::addParameter(WiFiManagerParameter* parameter) {
+  parameters.push_back(parameter);
+  return true;
+}
+
+bool WiFiManager::connectSaved() {
+  if (WiFi.status() == WL_CONNECTED) {
+    return true;
+  }
+  if (WiFi.begin() == WL_CONNECT_FAILED) {
+    return false;
+  }
+  unsigned long timeoutMs = connectTimeoutS > 0 ? connectTimeoutS * 1000 : DEFAULT_CONNECT_TIMEOUT_MS;
+  return WiFi.waitForConnectResult(timeoutMs) == WL_CONNECTED;
+}
+
+bool WiFiManager::autoConnect(const char* apName, const char* apPassword) {
+  WiFi.mode(WIFI_STA);
+  if (connectSaved()) {
+    return true;
+  }
+  return startConfigPortal(apName, apPassword);
+}
+
+bool WiFiManager::startConfigPortal(const char* apName, const char* apPassword) {
+  Board& board = Board::get();
+  Simulation& simulation = board.simulation();
+  const sim::SimulationConfig& config = simulation.config();
+  Network& network = board.network();
+
+  Simulation::PhaseScope scope(Phase::Portal);
+  WiFi.mode(WIFI_AP_STA);
+  network.startAccessPoint();
+
+  // The user only turns up for the first-boot portal; a portal opened by a
+  // failed autoConnect() just times out
+  int64_t userArrivesUs = static_cast<int64_t>(config.portalSeconds * sim::US_PER_SECOND);
+  int64_t timeoutUs = portalTimeoutS > 0 ? static_cast<int64_t>(portalTimeoutS) * sim::US_PER_SECOND : INT64_MAX;
+  bool userSubmits = parameters.size() > 0 && userArrivesUs < timeoutUs;
+
+  simulation.elapse(userSubmits ? userArrivesUs : timeoutUs, Phase::Portal);
+  network.stopAccessPoint();
+
+  if (!userSubmits) {
+    WiFi.mode(WIFI_STA);
+    return false;
+  }
+
+  for (WiFiManagerParameter* parameter : parameters) {
+    std::string id = parameter->getID();
+    std::string value;
+    if (id == "botToken") {
+      value = config.botToken;
+    } else if (id == "groupId") {
+      value = config.groupId;
+    } else if (id == "feedingSchedule") {
+      value = config.schedule;
+    } else if (id == "feedingPortionWeight") {
+      value = std::to_string(config.portionGrams);
+    } else if (id == "feedingBowlWeight") {
+      value = std::to_string(config.bowlGrams);
+    } else {
+      value = parameter->getValue();
+    }
+    parameter->setValue(value.c_str(), parameter->getValueLength());
+  }
+
+  WiFi.mode(WIFI_STA);
+  WiFi.begin(sim::AP_SSID, sim::AP_PASSWORD);
+  bool connected = WiFi.waitForConnectResult(DEFAULT_CONNECT_TIMEOUT_MS) == WL_CONNECTED;
+  return connected || breakAfterConfig;
+}
@@ -0,0 +1,63 @@
+#ifndef WIFI_MANAGER_H
+#define WIFI_MANAGER_H
+
+#include <vector>
+#include "WiFi.h"
+
+class WiFiManagerParameter {
+public:
+  WiFiManagerParameter(const char* id, const char* label, const char* defaultValue, int length);
+
+  const char* getID() const {
+    return id;
+  }
+  const char* getLabel() const {
+    return label;
+  }
+  const char* getValue() const {
+    return value.c_str();
+  }
+  int getValueLength() const {
+    return length;
+  }
+  void setValue(const char* newValue, int maxLength);
+
+private:
+  const char* id;
+  const char* label;
+  String value;
+  int length;
+};
+
+// The parts of tzapu's WiFiManager the firmware uses. The configuration portal
+// is a simulated user who joins the access point after --portal-seconds and
+// submits the home network plus the --bot-token/--group-id/... values.
+class WiFiManager {
+public:
+  void setConfigPortalTimeout(unsigned long seconds) {
+    portalTimeoutS = seconds;
+  }
+  void setConnectTimeout(unsigned long seconds) {
+    connectTimeoutS = seconds;
+  }
+  void setMenu(std::vector<const char*>& menu) {}
+  void setShowInfoErase(bool enabled) {}
+  void setShowInfoUpdate(bool enabled) {}
+  void setBreakAfterConfig(bool enabled) {
+    breakAfterConfig = enabled;
+  }
+  bool addParameter(WiFiManagerParameter* parameter);
+
+  bool autoConnect(const char* apName = nullptr, const char* apPassword = nullptr);
+  bool startConfigPortal(const char* apName = nullptr, const char* apPassword = nullptr);
+
+private:
+  unsigned long portalTimeoutS = 0;
+  unsigned long connectTimeoutS = 0;
+  bool breakAfterConfig = false;
+  std::vector<WiFiManagerParameter*> parameters;
+
+  bool connectSaved();
+};
+
+#endif
@@ -0,0 +1,52 @@
+#include "esp_partition.h"
+#include <cstring>
+#include "Board.h"
+
+using sim::Board;
+using sim::DataPartition;
+
+// Where feeder/partitions.csv puts the journal
+const uint32_t JOURNAL_ADDRESS = 0x310000;
+
+static const esp_partition_t* journalPartition() {
+  static esp_partition_t partition = {};
+  if (partition.size == 0) {
+    partition.type = ESP_PARTITION_TYPE_DATA;
+    partition.subtype = static_cast<esp_partition_subtype_t>(0x40);
+    partition.address = JOURNAL_ADDRESS;
+    partition.size = static_cast<uint32_t>(Board::get().journal().size());
+    partition.erase_size = DataPartition::SECTOR_SIZE;
+    strcpy(partition.label, "journal");
+  }
+  return &partition;
+}
+
+const esp_partition_t* esp_partition_find_first(esp_partition_type_t type, esp_partition_subtype_t subtype, const char* label) {
+  const esp_partition_t* partition = journalPartition();
+  if (type != partition->type || (subtype != ESP_PARTITION_SUBTYPE_ANY && subtype != partition->subtype)
+      || (label != nullptr && strcmp(label, partition->label) != 0)) {
+    return nullptr;
+  }
+  return partition;
+}
+
+esp_err_t esp_partition_read(const esp_partition_t* partition, size_t srcOffset, void* dst, size_t size) {
+  if (partition == nullptr || dst == nullptr) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  return Board::get().journal().read(srcOffset, dst, size) ? ESP_OK : ESP_ERR_INVALID_SIZE;
+}
+
+esp_err_t esp_partition_write(const esp_partition_t* partition, size_t dstOffset, const void* src, size_t size) {
+  if (partition == nullptr || src == nullptr) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  return Board::get().journal().write(dstOffset, src, size) ? ESP_OK : ESP_ERR_INVALID_SIZE;
+}
+
+esp_err_t esp_partition_erase_range(const esp_partition_t* partition, size_t offset, size_t size) {
+  if (partition == nullptr) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  return Board::get().journal().erase(offset, size) ? ESP_OK : ESP_ERR_INVALID_SIZE;
+}
@@ -0,0 +1,21 @@
+#ifndef ESP_SLEEP_H
+#define ESP_SLEEP_H
+
+#include <cstdint>
+#include "esp_err.h"
+
+typedef enum {
+  ESP_SLEEP_WAKEUP_UNDEFINED,
+  ESP_SLEEP_WAKEUP_ALL,
+  ESP_SLEEP_WAKEUP_EXT0,
+  ESP_SLEEP_WAKEUP_EXT1,
+  ESP_SLEEP_WAKEUP_TIMER,
+} esp_sleep_wakeup_cause_t;
+
+esp_err_t esp_sleep_enable_timer_wakeup(uint64_t timeInUs);
+esp_sleep_wakeup_cause_t esp_sleep_get_wakeup_cause();
+
+// Unwinds back to the simulation loop, which sleeps and boots the firmware again.
+[[noreturn]] void esp_deep_sleep_start();
+
+#endif
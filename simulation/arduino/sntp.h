@@ -0,0 +1,16 @@
+#ifndef SNTP_H
+#define SNTP_H
+
+#include <sys/time.h>
+
+typedef enum {
+  SNTP_SYNC_MODE_IMMED,
+  SNTP_SYNC_MODE_SMOOTH,
+} sntp_sync_mode_t;
+
+typedef void (*sntp_sync_time_cb_t)(struct timeval* tv);
+
+void sntp_set_time_sync_notification_cb(sntp_sync_time_cb_t callback);
+void sntp_set_sync_mode(sntp_sync_mode_t mode);
+
+#endif
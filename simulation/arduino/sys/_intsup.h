@@ -0,0 +1 @@
+// Newlib header used by the ESP32 toolchain; nothing is needed from it on the host.
@@ -0,0 +1,83 @@
+#include "EnergyMeter.h"
+
+namespace sim {
+
+const char* phaseName(Phase phase) {
+  switch (phase) {
+    case Phase::Boot: return "Boot";
+    case Phase::Wait: return "Wait";
+    case Phase::Serial: return "Serial";
+    case Phase::Rtc: return "Rtc";
+    case Phase::Nvs: return "Nvs";
+    case Phase::WiFi: return "WiFi";
+    case Phase::Ntp: return "Ntp";
+    case Phase::Telegram: return "Telegram";
+    case Phase::Weight: return "Weight";
+    case Phase::Motor: return "Motor";
+    case Phase::Voltage: return "Voltage";
+    case Phase::Portal: return "Portal";
+    case Phase::Sleep: return "Sleep";
+  }
+  return "?";
+}
+
+int64_t WakeRecord::awakeUs() const {
+  int64_t us = 0;
+  for (size_t i = 0; i < PHASE_COUNT; ++i) {
+    if (i != phaseIndex(Phase::Sleep)) {
+      us += phases[i].us;
+    }
+  }
+  return us;
+}
+
+double WakeRecord::awakeMah() const {
+  double mAh = 0;
+  for (size_t i = 0; i < PHASE_COUNT; ++i) {
+    if (i != phaseIndex(Phase::Sleep)) {
+      mAh += phases[i].mAh;
+    }
+  }
+  return mAh;
+}
+
+bool WakeRecord::feeding() const {
+  return phases[phaseIndex(Phase::Weight)].us > 0 || phases[phaseIndex(Phase::Motor)].us > 0;
+}
+
+void EnergyMeter::charge(Phase phase, int64_t us, double mA) {
+  if (us <= 0) {
+    return;
+  }
+
+  double mAh = mA * static_cast<double>(us) / 3600e6;
+  PhaseTotals& phaseTotal = totals[phaseIndex(phase)];
+  phaseTotal.us += us;
+  phaseTotal.mAh += mAh;
+  consumedMah += mAh;
+
+  if (!wakeRecords.empty()) {
+    PhaseTotals& wakeTotal = wakeRecords.back().phases[phaseIndex(phase)];
+    wakeTotal.us += us;
+    wakeTotal.mAh += mAh;
+  }
+}
+
+void EnergyMeter::beginWake(int64_t trueUs, bool coldBoot, bool brownout) {
+  WakeRecord record;
+  record.index = static_cast<int>(wakeRecords.size()) + 1;
+  record.startTrueUs = trueUs;
+  record.coldBoot = coldBoot;
+  record.brownout = brownout;
+  wakeRecords.push_back(record);
+}
+
+int64_t EnergyMeter::totalUs() const {
+  int64_t us = 0;
+  for (const PhaseTotals& phaseTotal : totals) {
+    us += phaseTotal.us;
+  }
+  return us;
+}
+
+}
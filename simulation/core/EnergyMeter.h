@@ -0,0 +1,56 @@
+#ifndef SIM_ENERGY_METER_H
+#define SIM_ENERGY_METER_H
+
+#include <cstdint>
+#include <vector>
+#include "Phase.h"
+
+namespace sim {
+
+struct PhaseTotals {
+  int64_t us = 0;
+  double mAh = 0;
+};
+
+// One boot of the firmware, plus the deep sleep that follows it.
+struct WakeRecord {
+  int index = 0;
+  int64_t startTrueUs = 0;
+  bool coldBoot = false;
+  bool brownout = false;  // booted from a brownout reset of the previous wake
+  PhaseTotals phases[PHASE_COUNT];
+
+  int64_t awakeUs() const;
+  double awakeMah() const;
+  // A wake that touched the load cell or the motor
+  bool feeding() const;
+};
+
+// Integrates current over time, charging every interval to one phase.
+class EnergyMeter {
+public:
+  void charge(Phase phase, int64_t us, double mA);
+
+  void beginWake(int64_t trueUs, bool coldBoot, bool brownout);
+
+  const PhaseTotals& total(Phase phase) const {
+    return totals[phaseIndex(phase)];
+  }
+  double totalMah() const {
+    return consumedMah;
+  }
+  int64_t totalUs() const;
+
+  const std::vector<WakeRecord>& wakes() const {
+    return wakeRecords;
+  }
+
+private:
+  PhaseTotals totals[PHASE_COUNT];
+  double consumedMah = 0;
+  std::vector<WakeRecord> wakeRecords;
+};
+
+}
+
+#endif
@@ -0,0 +1,37 @@
+#ifndef SIM_PHASE_H
+#define SIM_PHASE_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace sim {
+
+// What the board is busy with while simulated time passes. Every microsecond
+// and every microamp-hour is charged to exactly one phase.
+enum class Phase : uint8_t {
+  Boot,      // ROM bootloader and core start-up after every reset
+  Wait,      // firmware sitting in delay()
+  Serial,    // blocked on UART0 while logging
+  Rtc,       // DS1302 three-wire traffic
+  Nvs,       // Preferences and raw data partition access
+  WiFi,      // scan, association and DHCP
+  Ntp,       // SNTP request until the time callback fires
+  Telegram,  // DNS, TLS handshakes and HTTPS round trips
+  Weight,    // HX711 conversions and polling
+  Motor,     // auger motor driven
+  Voltage,   // ADC conversions
+  Portal,    // WiFiManager configuration portal
+  Sleep,     // deep sleep
+};
+
+const size_t PHASE_COUNT = static_cast<size_t>(Phase::Sleep) + 1;
+
+const char* phaseName(Phase phase);
+
+inline size_t phaseIndex(Phase phase) {
+  return static_cast<size_t>(phase);
+}
+
+}
+
+#endif
@@ -0,0 +1,136 @@
+#include "Report.h"
+#include "Board.h"
+
+namespace sim {
+
+static double seconds(int64_t us) {
+  return static_cast<double>(us) / US_PER_SECOND;
+}
+
+static void printWakeAverages(FILE* out, const char* label, const std::vector<WakeRecord>& wakes, bool feeding) {
+  int count = 0;
+  int64_t awakeUs = 0;
+  double awakeMah = 0;
+
+  for (const WakeRecord& wake : wakes) {
+    if (wake.coldBoot || wake.brownout || wake.feeding() != feeding) {
+      continue;
+    }
+    count++;
+    awakeUs += wake.awakeUs();
+    awakeMah += wake.awakeMah();
+  }
+
+  if (count == 0) {
+    fprintf(out, "  %-16s %6s\n", label, "-");
+    return;
+  }
+  fprintf(out, "  %-16s %6d wakes  %9.3f s awake  %8.4f mAh each\n", label, count, seconds(awakeUs) / count, awakeMah / count);
+}
+
+void Report::print(Board& board, FILE* out) {
+  Simulation& simulation = board.simulation();
+  EnergyMeter& meter = simulation.meter();
+  const std::vector<WakeRecord>& wakes = meter.wakes();
+  const SimulationConfig& config = simulation.config();
+
+  double days = seconds(meter.totalUs()) / 86400.0;
+  int coldBoots = 0;
+  int feedingWakes = 0;
+  for (const WakeRecord& wake : wakes) {
+    coldBoots += wake.coldBoot ? 1 : 0;
+    feedingWakes += wake.feeding() ? 1 : 0;
+  }
+
+  fprintf(out, "\n=== Simulation report ===\n");
+  fprintf(out, "Simulated %.2f days, %zu wakes (%d feeding, %d cold boots", days, wakes.size(), feedingWakes, coldBoots);
+  if (simulation.brownoutCount() > 0) {
+    fprintf(out, ", %d brownout resets", simulation.brownoutCount());
+  }
+  fprintf(out, ")\n");
+
+  fprintf(out, "\nPhase          time [s]    share      mAh    share\n");
+  int64_t totalUs = meter.totalUs();
+  double totalMah = meter.totalMah();
+  for (size_t i = 0; i < PHASE_COUNT; ++i) {
+    const PhaseTotals& phase = meter.total(static_cast<Phase>(i));
+    if (phase.us == 0) {
+      continue;
+    }
+    fprintf(out, "%-10s %12.3f  %6.2f%%  %7.2f  %6.2f%%\n", phaseName(static_cast<Phase>(i)), seconds(phase.us),
+            totalUs > 0 ? 100.0 * phase.us / totalUs : 0.0, phase.mAh, totalMah > 0 ? 100.0 * phase.mAh / totalMah : 0.0);
+  }
+
+  fprintf(out, "\nAverage wake (cold boots and resets excluded)\n");
+  printWakeAverages(out, "idle", wakes, false);
+  printWakeAverages(out, "feeding", wakes, true);
+
+  double mahPerDay = days > 0 ? totalMah / days : 0;
+  double averageMa = totalUs > 0 ? totalMah / (seconds(totalUs) / 3600.0) : 0;
+  double usableMah = config.batteryMah * config.batteryInitialPercent / 100.0;
+  fprintf(out, "\nEnergy: %.2f mAh total, %.2f mAh/day, %.3f mA average\n", totalMah, mahPerDay, averageMa);
+  fprintf(out, "Battery: %.1f%% left (%.3f V open circuit), projected runtime %.0f days on %.0f mAh\n",
+          100.0 * board.battery().stateOfCharge(), board.battery().openCircuitVoltage(),
+          mahPerDay > 0 ? usableMah / mahPerDay : 0.0, config.batteryMah);
+
+  const Network::Stats& wifi = board.network().stats();
+  fprintf(out, "\nWi-Fi: %d connects (%d failed, %d scans, %d DHCP), %.3f s average connect, %d DNS lookups, %d time syncs\n",
+          wifi.connects, wifi.failures, wifi.scans, wifi.dhcpExchanges, wifi.connects > 0 ? seconds(wifi.connectUs) / wifi.connects : 0.0,
+          wifi.dnsLookups, wifi.timeSyncs);
+
+  const TelegramServer::Stats& telegram = board.telegram().stats();
+  fprintf(out, "Telegram: %zu messages, %d requests (%d rejected, %d dropped), %d connections, %d full + %d resumed TLS handshakes (%.3f s average), %zu B sent, %zu B received\n",
+          board.telegram().messages().size(), telegram.requests, telegram.rejected, telegram.dropped, telegram.connections,
+          telegram.fullHandshakes, telegram.resumedHandshakes,
+          telegram.connections > 0 ? seconds(telegram.handshakeUs) / telegram.connections : 0.0,
+          telegram.bytesReceived, telegram.bytesSent);
+
+  const Nvs::Stats& nvs = board.nvs().stats();
+  fprintf(out, "NVS: %d opens, %d reads, %d writes (%d skipped), %zu bytes written\n", nvs.opens, nvs.reads, nvs.writes,
+          nvs.skippedWrites, nvs.bytesWritten);
+
+  const DataPartition::Stats& journal = board.journal().stats();
+  fprintf(out, "Journal partition: %d reads, %d writes, %zu bytes written, %d sector erases (at most %d per sector)\n", journal.reads,
+          journal.writes, journal.bytesWritten, journal.erases, journal.maxSectorErases);
+
+  const FoodModel::Stats& food = board.food().stats();
+  fprintf(out, "Food: %.0f g dispensed, %.0f g eaten, %d forward / %d reverse pulses, %d jams (%d cleared), %d pulses on an empty hopper, %d refills\n",
+          food.dispensedGrams, food.eatenGrams, food.forwardPulses, food.reversePulses, food.jams, food.jamsCleared,
+          food.emptyHopperPulses, food.refills);
+
+  const Drv8833& motor = board.motorDriver();
+  fprintf(out, "Motor: %.1f s running, %d starts, %.0f mA peak\n", seconds(motor.runningUs()), motor.starts(), motor.peakMa());
+
+  fprintf(out, "RTC memory used by the firmware: %zu bytes\n", simulation.rtcMemoryBytes());
+}
+
+bool Report::writeCsv(Board& board, const char* path) {
+  FILE* out = fopen(path, "w");
+  if (out == nullptr) {
+    return false;
+  }
+
+  fprintf(out, "wake,start_utc,cold_boot,feeding,awake_s,awake_mAh");
+  for (size_t i = 0; i < PHASE_COUNT; ++i) {
+    fprintf(out, ",%s_s,%s_mAh", phaseName(static_cast<Phase>(i)), phaseName(static_cast<Phase>(i)));
+  }
+  fprintf(out, "\n");
+
+  for (const WakeRecord& wake : board.simulation().meter().wakes()) {
+    time_t start = static_cast<time_t>(wake.startTrueUs / US_PER_SECOND);
+    char timestamp[32];
+    strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S", gmtime(&start));
+
+    fprintf(out, "%d,%s,%d,%d,%.6f,%.6f", wake.index, timestamp, wake.coldBoot ? 1 : 0, wake.feeding() ? 1 : 0,
+            seconds(wake.awakeUs()), wake.awakeMah());
+    for (size_t i = 0; i < PHASE_COUNT; ++i) {
+      fprintf(out, ",%.6f,%.6f", seconds(wake.phases[i].us), wake.phases[i].mAh);
+    }
+    fprintf(out, "\n");
+  }
+
+  fclose(out);
+  return true;
+}
+
+}
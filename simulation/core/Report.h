@@ -0,0 +1,21 @@
+#ifndef SIM_REPORT_H
+#define SIM_REPORT_H
+
+#include <cstdio>
+
+namespace sim {
+
+class Board;
+
+// End-of-run summary: where the awake time and the charge went, per phase and
+// per wake, and what that means for battery life.
+class Report {
+public:
+  static void print(Board& board, FILE* out);
+  // One row per wake; returns false if the file cannot be written
+  static bool writeCsv(Board& board, const char* path);
+};
+
+}
+
+#endif
@@ -0,0 +1,336 @@
+#include "Simulation.h"
+#include <cstring>
+#include <ctime>
+#include <stdexcept>
+#include <string>
+
+// Bounds of the RTC_DATA_ATTR and RTC_NOINIT_ATTR sections, provided by the linker.
+extern "C" char __start_rtc_data[] __attribute__((weak));
+extern "C" char __stop_rtc_data[] __attribute__((weak));
+extern "C" char __start_rtc_noinit[] __attribute__((weak));
+extern "C" char __stop_rtc_noinit[] __attribute__((weak));
+
+namespace sim {
+
+// millis() calls without time moving before the clock is nudged forward
+const unsigned long STALLED_CLOCK_READS = 10000;
+// What RTC_NOINIT_ATTR memory holds after a power loss
+const uint8_t RTC_NOINIT_FILL = 0xA5;
+
+Simulation* Simulation::instance = nullptr;
+
+Simulation::Simulation(const SimulationConfig& config)
+  : simulationConfig(config), random(config.seed) {
+  instance = this;
+
+  struct tm start = {};
+  const char* parsed = strptime(config.start.c_str(), "%Y-%m-%d %H:%M:%S", &start);
+  if (parsed == nullptr || *parsed != '\0') {
+    throw std::invalid_argument("bad start time: " + config.start);
+  }
+  trueTimeUs = static_cast<int64_t>(timegm(&start)) * US_PER_SECOND;
+
+  if (__start_rtc_data != nullptr && __stop_rtc_data != nullptr) {
+    rtcMemorySnapshot.assign(__start_rtc_data, __stop_rtc_data);
+  }
+}
+
+Simulation::~Simulation() {
+  if (instance == this) {
+    instance = nullptr;
+  }
+}
+
+void Simulation::elapse(int64_t us, Phase fallback) {
+  if (us <= 0 || dispatching || !awake) {
+    return;
+  }
+
+  stalledClockReads = 0;
+  int64_t target = trueTimeUs + us;
+
+  while (trueTimeUs < target) {
+    int64_t stepEnd = target;
+    if (!events.empty() && events.top().atUs < stepEnd) {
+      stepEnd = std::max(events.top().atUs, trueTimeUs);
+    }
+
+    advance(stepEnd - trueTimeUs, currentPhase(fallback), false);
+    dispatchDue(trueTimeUs);
+  }
+
+  if (uptime > static_cast<int64_t>(simulationConfig.maxAwakeSeconds * US_PER_SECOND)) {
+    throw std::runtime_error("firmware stayed awake for more than " + std::to_string(static_cast<long>(simulationConfig.maxAwakeSeconds)) + " s");
+  }
+}
+
+void Simulation::clockRead() {
+  if (++stalledClockReads > STALLED_CLOCK_READS) {
+    poll(1);
+  }
+}
+
+void Simulation::schedule(int64_t atTrueUs, std::function<void()> action, bool perWake) {
+  events.push(Event{ atTrueUs, eventSequence++, perWake ? wakeGeneration : 0, std::move(action) });
+}
+
+void Simulation::addComponent(Component* component) {
+  components.push_back(component);
+}
+
+void Simulation::attachPin(uint8_t pin, Component* component) {
+  pins[pin].owner = component;
+}
+
+void Simulation::pinMode(uint8_t pin, uint8_t mode) {
+  PinState& state = pins[pin];
+  state.mode = mode;
+  if (state.owner != nullptr) {
+    touch(state.owner);
+    state.owner->pinModeChanged(pin, mode);
+  }
+}
+
+void Simulation::digitalWrite(uint8_t pin, uint8_t level) {
+  PinState& state = pins[pin];
+  state.level = level ? 1 : 0;
+  if (state.owner != nullptr) {
+    touch(state.owner);
+    state.owner->pinWritten(pin, state.level);
+  }
+}
+
+void Simulation::pwmWrite(uint8_t pin, double duty) {
+  PinState& state = pins[pin];
+  state.level = duty > 0 ? 1 : 0;
+  if (state.owner != nullptr) {
+    touch(state.owner);
+    state.owner->pwmWritten(pin, duty);
+  }
+}
+
+int Simulation::digitalRead(uint8_t pin) {
+  PinState& state = pins[pin];
+  if (state.owner != nullptr) {
+    touch(state.owner);
+    return state.owner->pinRead(pin);
+  }
+  return state.level;
+}
+
+uint8_t Simulation::pinLevel(uint8_t pin) const {
+  return pins[pin].level;
+}
+
+uint8_t Simulation::pinModeOf(uint8_t pin) const {
+  return pins[pin].mode;
+}
+
+void Simulation::attachInterrupt(uint8_t pin, void (*handler)(), int mode) {
+  pins[pin].isr = handler;
+  pins[pin].isrMode = mode;
+}
+
+void Simulation::detachInterrupt(uint8_t pin) {
+  pins[pin].isr = nullptr;
+}
+
+void Simulation::signalEdge(uint8_t pin, uint8_t level) {
+  const int RISING_EDGE = 0x01;
+  const int FALLING_EDGE = 0x02;
+
+  PinState& state = pins[pin];
+  int edge = level ? RISING_EDGE : FALLING_EDGE;
+  if (!awake || state.isr == nullptr || (state.isrMode & edge) == 0) {
+    return;
+  }
+
+  // The handler may run inside an event; keep its pin traffic from advancing time
+  bool wasDispatching = dispatching;
+  dispatching = true;
+  state.isr();
+  dispatching = wasDispatching;
+}
+
+void Simulation::touch(Component* component) {
+  lastTouchedPhase = component->phase();
+}
+
+double Simulation::currentMa() const {
+  double mA = awake ? simulationConfig.cpuMa : simulationConfig.deepSleepMa;
+  for (const Component* component : components) {
+    mA += component->currentMa();
+  }
+  return mA;
+}
+
+void Simulation::powerOn() {
+  coldBoot = true;
+  espClock = 0;
+  if (!rtcMemorySnapshot.empty()) {
+    memcpy(__start_rtc_data, rtcMemorySnapshot.data(), rtcMemorySnapshot.size());
+  }
+  if (__start_rtc_noinit != nullptr && __stop_rtc_noinit != nullptr) {
+    memset(__start_rtc_noinit, RTC_NOINIT_FILL, __stop_rtc_noinit - __start_rtc_noinit);
+  }
+}
+
+void Simulation::brownout() {
+  brownouts++;
+  throw Brownout();
+}
+
+void Simulation::reset() {
+  powerDownPeripherals();
+  awake = false;
+  brownoutBoot = true;
+  // The reset may have hit inside an event or an interrupt handler; that wake's events die with it
+  dispatching = false;
+  wakeGeneration++;
+  if (!rtcMemorySnapshot.empty()) {
+    memcpy(__start_rtc_data, rtcMemorySnapshot.data(), rtcMemorySnapshot.size());
+  }
+}
+
+void Simulation::boot() {
+  awake = true;
+  uptime = 0;
+  wakes++;
+  wakeupRequestUs = 0;
+  stalledClockReads = 0;
+  lastTouchedPhase = Phase::Wait;
+  phaseStack.clear();
+  energyMeter.beginWake(trueTimeUs, coldBoot, brownoutBoot);
+
+  for (Component* component : components) {
+    component->onBoot(coldBoot);
+  }
+  coldBoot = false;
+  brownoutBoot = false;
+
+  elapse(static_cast<int64_t>(simulationConfig.bootMs * US_PER_MS), Phase::Boot);
+}
+
+void Simulation::powerDownPeripherals() {
+  for (Component* component : components) {
+    component->onDeepSleep();
+  }
+  for (PinState& state : pins) {
+    state.mode = 0x01;
+    state.level = 0;
+    state.isr = nullptr;
+  }
+}
+
+bool Simulation::deepSleep(int64_t limitTrueUs) {
+  powerDownPeripherals();
+  awake = false;
+  phaseStack.clear();
+  wakeGeneration++;
+
+  int64_t requestedUs = static_cast<int64_t>(wakeupRequestUs);
+  int64_t actualUs = requestedUs;
+  if (requestedUs > 0) {
+    sleepErrorPpm = simulationConfig.sleepClockErrorPpm + normal(simulationConfig.sleepClockJitterPpm);
+    actualUs = static_cast<int64_t>(requestedUs * (1.0 + sleepErrorPpm / 1e6));
+  }
+
+  int64_t startUs = trueTimeUs;
+  int64_t target = requestedUs > 0 ? startUs + actualUs : limitTrueUs;
+  int64_t end = std::min(target, limitTrueUs);
+
+  while (trueTimeUs < end) {
+    int64_t stepEnd = end;
+    if (!events.empty() && events.top().atUs < stepEnd) {
+      stepEnd = std::max(events.top().atUs, trueTimeUs);
+    }
+    advance(stepEnd - trueTimeUs, Phase::Sleep, true);
+    dispatchDue(trueTimeUs);
+  }
+
+  // The ESP32 believes it slept exactly as long as it asked for
+  if (actualUs > 0) {
+    espClock += static_cast<int64_t>(static_cast<double>(requestedUs) * (end - startUs) / actualUs);
+  }
+
+  return requestedUs > 0 && target <= limitTrueUs;
+}
+
+double Simulation::uniform() {
+  return std::uniform_real_distribution<double>(0.0, 1.0)(random);
+}
+
+double Simulation::normal(double sigma) {
+  if (sigma <= 0) {
+    return 0;
+  }
+  return std::normal_distribution<double>(0.0, sigma)(random);
+}
+
+size_t Simulation::rtcMemoryBytes() const {
+  size_t bytes = 0;
+  if (__start_rtc_data != nullptr && __stop_rtc_data != nullptr) {
+    bytes += static_cast<size_t>(__stop_rtc_data - __start_rtc_data);
+  }
+  if (__start_rtc_noinit != nullptr && __stop_rtc_noinit != nullptr) {
+    bytes += static_cast<size_t>(__stop_rtc_noinit - __start_rtc_noinit);
+  }
+  return bytes;
+}
+
+Phase Simulation::currentPhase(Phase fallback) const {
+  if (!phaseStack.empty()) {
+    return phaseStack.back();
+  }
+
+  Phase busy;
+  for (const Component* component : components) {
+    if (component->busyPhase(busy)) {
+      return busy;
+    }
+  }
+
+  return fallback;
+}
+
+void Simulation::advance(int64_t us, Phase phase, bool sleeping) {
+  if (us <= 0) {
+    return;
+  }
+
+  energyMeter.charge(phase, us, currentMa());
+  trueTimeUs += us;
+  if (!sleeping) {
+    uptime += us;
+    espClock += us;
+  }
+}
+
+void Simulation::dispatchDue(int64_t upToUs) {
+  while (!events.empty() && events.top().atUs <= upToUs) {
+    Event event = events.top();
+    events.pop();
+
+    if (event.generation != 0 && event.generation != wakeGeneration) {
+      continue;
+    }
+
+    dispatching = true;
+    event.action();
+    dispatching = false;
+  }
+}
+
+Simulation::PhaseScope::PhaseScope(Phase phase) {
+  if (instance != nullptr) {
+    instance->phaseStack.push_back(phase);
+  }
+}
+
+Simulation::PhaseScope::~PhaseScope() {
+  if (instance != nullptr && !instance->phaseStack.empty()) {
+    instance->phaseStack.pop_back();
+  }
+}
+
+}
@@ -0,0 +1,230 @@
+#ifndef SIM_SIMULATION_H
+#define SIM_SIMULATION_H
+
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <random>
+#include <vector>
+#include "Phase.h"
+#include "SimulationConfig.h"
+#include "EnergyMeter.h"
+
+namespace sim {
+
+const int64_t US_PER_MS = 1000;
+const int64_t US_PER_SECOND = 1000000;
+const int64_t US_PER_DAY = 86400 * US_PER_SECOND;
+
+// Thrown by esp_deep_sleep_start() to unwind the firmware back to the main loop.
+struct DeepSleep {};
+
+// Thrown when the supply dips below the brownout threshold; the chip resets on the spot.
+struct Brownout {};
+
+// Anything on the board that draws current, owns pins or needs to know about
+// resets. Components are registered once and live for the whole run.
+class Component {
+public:
+  virtual ~Component() = default;
+
+  // Battery-side current on top of the CPU.
+  virtual double currentMa() const {
+    return 0;
+  }
+
+  // Phase the component claims while it keeps the firmware waiting (a motor
+  // running, a conversion in flight). Returns false when idle.
+  virtual bool busyPhase(Phase& phase) const {
+    return false;
+  }
+
+  // Phase charged for pin traffic and short busy-waits right after touching the component.
+  virtual Phase phase() const {
+    return Phase::Wait;
+  }
+
+  virtual void pinModeChanged(uint8_t pin, uint8_t mode) {}
+  virtual void pinWritten(uint8_t pin, uint8_t level) {}
+  // Duty cycle 0..1 of a pin driven by the LEDC peripheral
+  virtual void pwmWritten(uint8_t pin, double duty) {}
+  virtual int pinRead(uint8_t pin) {
+    return 0;
+  }
+
+  virtual void onBoot(bool coldBoot) {}
+  virtual void onDeepSleep() {}
+};
+
+// The virtual world: true UTC time, the ESP32's own idea of time, the event
+// queue, pins and the energy meter. Exactly one instance exists per run.
+class Simulation {
+public:
+  explicit Simulation(const SimulationConfig& config);
+  ~Simulation();
+
+  static Simulation* current() {
+    return instance;
+  }
+
+  const SimulationConfig& config() const {
+    return simulationConfig;
+  }
+
+  EnergyMeter& meter() {
+    return energyMeter;
+  }
+
+  // Time. True time is what the world (and the DS1302) lives in; uptime restarts
+  // at every reset; the ESP clock is the system time the firmware sees via time().
+  int64_t trueUs() const {
+    return trueTimeUs;
+  }
+  int64_t uptimeUs() const {
+    return uptime;
+  }
+  int64_t espClockUs() const {
+    return espClock;
+  }
+  void setEspClockUs(int64_t value) {
+    espClock = value;
+  }
+  bool isAwake() const {
+    return awake;
+  }
+
+  // Advances time while awake. The phase is used unless a PhaseScope or a busy
+  // component says otherwise.
+  void elapse(int64_t us, Phase fallback);
+  void wait(int64_t us) {
+    elapse(us, Phase::Wait);
+  }
+  // Short busy-wait charged to the component touched last.
+  void poll(int64_t us) {
+    elapse(us, lastTouchedPhase);
+  }
+  // Called by millis()/micros(); guards against loops spinning on a clock that never moves.
+  void clockRead();
+
+  // Events fire at a true time. Per-wake events are dropped by the next deep sleep.
+  void schedule(int64_t atTrueUs, std::function<void()> action, bool perWake = false);
+
+  void addComponent(Component* component);
+  void attachPin(uint8_t pin, Component* component);
+
+  void pinMode(uint8_t pin, uint8_t mode);
+  void digitalWrite(uint8_t pin, uint8_t level);
+  void pwmWrite(uint8_t pin, double duty);
+  int digitalRead(uint8_t pin);
+  uint8_t pinLevel(uint8_t pin) const;
+  uint8_t pinModeOf(uint8_t pin) const;
+  void touch(Component* component);
+
+  // GPIO interrupts. Components call signalEdge() when a line they drive changes;
+  // a handler attached for that edge runs right away, like an ISR.
+  void attachInterrupt(uint8_t pin, void (*handler)(), int mode);
+  void detachInterrupt(uint8_t pin);
+  void signalEdge(uint8_t pin, uint8_t level);
+
+  // Total battery-side current right now.
+  double currentMa() const;
+
+  // Lifecycle, driven by main.cpp.
+  void powerOn();
+  void boot();
+  // Unwinds the firmware like a brownout reset. Call reset() before the next boot().
+  [[noreturn]] void brownout();
+  // Peripherals lose power and RTC_DATA_ATTR is loaded again; RTC_NOINIT_ATTR is kept.
+  void reset();
+  int brownoutCount() const {
+    return brownouts;
+  }
+  void requestTimerWakeup(uint64_t us) {
+    wakeupRequestUs = us;
+  }
+  uint64_t timerWakeupUs() const {
+    return wakeupRequestUs;
+  }
+  // Sleeps until the timer fires or `limitTrueUs` is reached. Returns false if the
+  // run ended during the sleep.
+  bool deepSleep(int64_t limitTrueUs);
+  int wakeCount() const {
+    return wakes;
+  }
+  bool isColdBoot() const {
+    return coldBoot;
+  }
+
+  // Random numbers
+  double uniform();
+  double normal(double sigma);
+
+  size_t rtcMemoryBytes() const;
+
+  class PhaseScope {
+  public:
+    explicit PhaseScope(Phase phase);
+    ~PhaseScope();
+    PhaseScope(const PhaseScope&) = delete;
+    PhaseScope& operator=(const PhaseScope&) = delete;
+  };
+
+private:
+  struct Event {
+    int64_t atUs;
+    uint64_t sequence;
+    uint64_t generation;  // 0 = survives deep sleep
+    std::function<void()> action;
+
+    bool operator>(const Event& other) const {
+      return atUs != other.atUs ? atUs > other.atUs : sequence > other.sequence;
+    }
+  };
+
+  struct PinState {
+    uint8_t mode = 0x01;  // INPUT
+    uint8_t level = 0;
+    Component* owner = nullptr;
+    void (*isr)() = nullptr;
+    int isrMode = 0;
+  };
+
+  static Simulation* instance;
+
+  SimulationConfig simulationConfig;
+  EnergyMeter energyMeter;
+  std::mt19937_64 random;
+
+  int64_t trueTimeUs = 0;
+  int64_t uptime = 0;
+  int64_t espClock = 0;
+  bool awake = false;
+  bool coldBoot = true;
+  bool brownoutBoot = false;
+  int wakes = 0;
+  int brownouts = 0;
+  uint64_t wakeupRequestUs = 0;
+  double sleepErrorPpm = 0;
+
+  std::priority_queue<Event, std::vector<Event>, std::greater<Event>> events;
+  uint64_t eventSequence = 0;
+  uint64_t wakeGeneration = 1;
+  bool dispatching = false;
+
+  std::vector<Component*> components;
+  PinState pins[64];
+  Phase lastTouchedPhase = Phase::Wait;
+  std::vector<Phase> phaseStack;
+  unsigned long stalledClockReads = 0;
+
+  std::vector<uint8_t> rtcMemorySnapshot;
+
+  Phase currentPhase(Phase fallback) const;
+  void powerDownPeripherals();
+  void advance(int64_t us, Phase phase, bool sleeping);
+  void dispatchDue(int64_t upToUs);
+};
+
+}
+
+#endif
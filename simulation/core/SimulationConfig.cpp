@@ -0,0 +1,179 @@
+#include "SimulationConfig.h"
+#include <cstdlib>
+
+namespace sim {
+
+namespace {
+
+struct DoubleOption {
+  const char* name;
+  double SimulationConfig::*field;
+  const char* help;
+};
+
+struct IntOption {
+  const char* name;
+  int SimulationConfig::*field;
+  const char* help;
+};
+
+struct BoolOption {
+  const char* name;
+  bool SimulationConfig::*field;
+  const char* help;
+};
+
+struct StringOption {
+  const char* name;
+  std::string SimulationConfig::*field;
+  const char* help;
+};
+
+const DoubleOption DOUBLE_OPTIONS[] = {
+  { "days", &SimulationConfig::days, "simulated time" },
+  { "max-awake-seconds", &SimulationConfig::maxAwakeSeconds, "abort when one wake lasts longer" },
+  { "portal-seconds", &SimulationConfig::portalSeconds, "time the user spends in the config portal" },
+  { "cpu-ma", &SimulationConfig::cpuMa, "CPU awake, radio off" },
+  { "radio-active-ma", &SimulationConfig::radioActiveMa, "radio scanning/transmitting, on top of the CPU" },
+  { "radio-idle-ma", &SimulationConfig::radioIdleMa, "radio associated but idle, on top of the CPU" },
+  { "deep-sleep-ma", &SimulationConfig::deepSleepMa, "whole board in deep sleep" },
+  { "motor-ma", &SimulationConfig::motorMa, "auger motor running" },
+  { "motor-stall-ma", &SimulationConfig::motorStallMa, "auger motor stalled by a jam, or starting from standstill" },
+  { "motor-time-constant-ms", &SimulationConfig::motorTimeConstantMs, "motor spin-up and braking time constant" },
+  { "brownout-probability", &SimulationConfig::brownoutProbability, "chance that a motor start browns out and resets the board" },
+  { "motor-driver-ma", &SimulationConfig::motorDriverMa, "DRV8833 awake (STBY high)" },
+  { "hx711-ma", &SimulationConfig::hx711Ma, "HX711 and load cell powered" },
+  { "boot-ms", &SimulationConfig::bootMs, "reset to setup()" },
+  { "battery-mah", &SimulationConfig::batteryMah, "pack capacity" },
+  { "battery-initial-percent", &SimulationConfig::batteryInitialPercent, "state of charge at the start" },
+  { "battery-resistance-ohm", &SimulationConfig::batteryResistanceOhm, "pack internal resistance" },
+  { "divider-ratio", &SimulationConfig::dividerRatio, "voltage sensor divider" },
+  { "adc-gain", &SimulationConfig::adcGain, "ADC gain error" },
+  { "adc-offset-mv", &SimulationConfig::adcOffsetMv, "ADC offset error" },
+  { "adc-noise-lsb", &SimulationConfig::adcNoiseLsb, "ADC noise (sigma)" },
+  { "ds1302-drift-ppm", &SimulationConfig::ds1302DriftPpm, "DS1302 crystal error" },
+  { "sleep-clock-error-ppm", &SimulationConfig::sleepClockErrorPpm, "ESP32 slow clock error during deep sleep" },
+  { "sleep-clock-jitter-ppm", &SimulationConfig::sleepClockJitterPpm, "random part of the slow clock error" },
+  { "wifi-scan-ms", &SimulationConfig::wifiScanMs, "all-channel scan" },
+  { "wifi-associate-ms", &SimulationConfig::wifiAssociateMs, "authentication and association" },
+  { "dhcp-ms", &SimulationConfig::dhcpMs, "DHCP exchange" },
+  { "wifi-failure-rate", &SimulationConfig::wifiFailureRate, "probability that a connect attempt fails" },
+  { "dns-ms", &SimulationConfig::dnsMs, "DNS lookup" },
+  { "rtt-ms", &SimulationConfig::rttMs, "round trip to the internet" },
+  { "tls-full-handshake-ms", &SimulationConfig::tlsFullHandshakeMs, "TLS handshake with certificate verification" },
+  { "tls-resumed-handshake-ms", &SimulationConfig::tlsResumedHandshakeMs, "abbreviated TLS handshake" },
+  { "telegram-server-ms", &SimulationConfig::telegramServerMs, "Bot API processing time" },
+  { "telegram-failure-rate", &SimulationConfig::telegramFailureRate, "probability that a request gets no answer" },
+  { "ntp-ms", &SimulationConfig::ntpMs, "SNTP round trip" },
+  { "airtime-us-per-byte", &SimulationConfig::airtimeUsPerByte, "radio time per payload byte" },
+  { "hopper-grams", &SimulationConfig::hopperGrams, "food in a full hopper" },
+  { "refill-days", &SimulationConfig::refillDays, "owner refills the hopper this often (0 = never)" },
+  { "auger-grams-per-second", &SimulationConfig::augerGramsPerSecond, "forward auger throughput" },
+  { "auger-coast-ms", &SimulationConfig::augerCoastMs, "food moved by a coasting auger, in ms at full speed" },
+  { "dose-variation", &SimulationConfig::doseVariation, "relative spread of food per pulse" },
+  { "jam-probability", &SimulationConfig::jamProbability, "chance that a forward pulse jams the auger" },
+  { "pet-eat-minutes", &SimulationConfig::petEatMinutes, "delay before the pet empties the bowl" },
+  { "leftover-fraction", &SimulationConfig::leftoverFraction, "part of the bowl the pet leaves" },
+  { "hx711-noise-grams", &SimulationConfig::hx711NoiseGrams, "load cell noise (sigma)" },
+  { "motor-vibration-grams", &SimulationConfig::motorVibrationGrams, "extra noise while the motor runs" },
+  { "hx711-settle-ms", &SimulationConfig::hx711SettleMs, "first conversion after power-up" },
+  { "hx711-period-ms", &SimulationConfig::hx711PeriodMs, "conversion period" },
+};
+
+const IntOption INT_OPTIONS[] = {
+  { "portion-grams", &SimulationConfig::portionGrams, "portion entered in the portal" },
+  { "bowl-grams", &SimulationConfig::bowlGrams, "bowl weight entered in the portal (and on the scale)" },
+  { "weighing-resets", &SimulationConfig::weighingResets, "resets the board at the first HX711 reading of this many feedings" },
+};
+
+const BoolOption BOOL_OPTIONS[] = {
+  { "verbose", &SimulationConfig::verbose, "echo the firmware's Serial output and decode its log after every wake" },
+  { "show-messages", &SimulationConfig::showMessages, "print every delivered Telegram message" },
+  { "ds1302-lost-power", &SimulationConfig::ds1302LostPower, "start with an invalid DS1302 time" },
+};
+
+const StringOption STRING_OPTIONS[] = {
+  { "start", &SimulationConfig::start, "UTC start, YYYY-MM-DD HH:MM:SS" },
+  { "csv", &SimulationConfig::csv, "write one line per wake to this file" },
+  { "bot-token", &SimulationConfig::botToken, "bot token entered in the portal" },
+  { "group-id", &SimulationConfig::groupId, "group id entered in the portal" },
+  { "schedule", &SimulationConfig::schedule, "feeding schedule entered in the portal" },
+};
+
+bool parseDouble(const std::string& value, double& result) {
+  char* end = nullptr;
+  result = strtod(value.c_str(), &end);
+  return !value.empty() && *end == '\0';
+}
+
+}
+
+bool SimulationConfig::apply(const std::string& name, const std::string& value) {
+  if (name == "seed") {
+    double seedValue;
+    if (!parseDouble(value, seedValue) || seedValue < 0) {
+      return false;
+    }
+    seed = static_cast<unsigned int>(seedValue);
+    return true;
+  }
+
+  for (const DoubleOption& option : DOUBLE_OPTIONS) {
+    if (name == option.name) {
+      return parseDouble(value, this->*option.field);
+    }
+  }
+
+  for (const IntOption& option : INT_OPTIONS) {
+    if (name == option.name) {
+      double parsed;
+      if (!parseDouble(value, parsed)) {
+        return false;
+      }
+      this->*option.field = static_cast<int>(parsed);
+      return true;
+    }
+  }
+
+  for (const BoolOption& option : BOOL_OPTIONS) {
+    if (name == option.name) {
+      if (value.empty() || value == "1" || value == "true") {
+        this->*option.field = true;
+      } else if (value == "0" || value == "false") {
+        this->*option.field = false;
+      } else {
+        return false;
+      }
+      return true;
+    }
+  }
+
+  for (const StringOption& option : STRING_OPTIONS) {
+    if (name == option.name) {
+      this->*option.field = value;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void SimulationConfig::printOptions(FILE* out) {
+  SimulationConfig defaults;
+
+  fprintf(out, "  --%-26s %-22u %s\n", "seed", defaults.seed, "random seed");
+  for (const BoolOption& option : BOOL_OPTIONS) {
+    fprintf(out, "  --%-26s %-22s %s\n", option.name, defaults.*option.field ? "true" : "false", option.help);
+  }
+  for (const StringOption& option : STRING_OPTIONS) {
+    fprintf(out, "  --%-26s %-22s %s\n", option.name, (defaults.*option.field).c_str(), option.help);
+  }
+  for (const IntOption& option : INT_OPTIONS) {
+    fprintf(out, "  --%-26s %-22d %s\n", option.name, defaults.*option.field, option.help);
+  }
+  for (const DoubleOption& option : DOUBLE_OPTIONS) {
+    fprintf(out, "  --%-26s %-22g %s\n", option.name, defaults.*option.field, option.help);
+  }
+}
+
+}
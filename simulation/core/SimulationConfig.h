@@ -0,0 +1,96 @@
+#ifndef SIM_SIMULATION_CONFIG_H
+#define SIM_SIMULATION_CONFIG_H
+
+#include <cstdio>
+#include <string>
+
+namespace sim {
+
+// Every knob of the simulated world. Currents are battery-side, i.e. they
+// already include the boost converter losses of the real board.
+struct SimulationConfig {
+  // Run
+  double days = 14;
+  std::string start = "2024-11-04 06:00:00";  // UTC
+  unsigned int seed = 1;
+  bool verbose = false;      // echo the firmware's Serial output and log
+  bool showMessages = false; // print every Telegram message delivered
+  std::string csv;           // per-wake CSV output path
+  double maxAwakeSeconds = 1800;
+
+  // What the user enters in the configuration portal on first boot
+  std::string botToken = "123456789:SIMULATED-BOT-TOKEN";
+  std::string groupId = "-1001234567890";
+  std::string schedule = "08:00,14:00,20:00";
+  int portionGrams = 40;
+  int bowlGrams = 150;
+  double portalSeconds = 60;
+
+  // Power model (mA)
+  double cpuMa = 28;
+  double radioActiveMa = 95;
+  double radioIdleMa = 30;
+  double deepSleepMa = 0.25;
+  double motorMa = 320;
+  double motorStallMa = 650;
+  double motorTimeConstantMs = 40;  // spin-up; the inrush decays with it
+  double brownoutProbability = 0;  // per motor start, for a worn cell that sags below the brownout threshold
+  double motorDriverMa = 1.7;
+  double hx711Ma = 5;
+  double bootMs = 300;
+
+  // Battery and voltage sensor
+  double batteryMah = 6000;
+  double batteryInitialPercent = 100;
+  double batteryResistanceOhm = 0.08;
+  double dividerRatio = 5;
+  double adcGain = 0.985;
+  double adcOffsetMv = 30;
+  double adcNoiseLsb = 4;
+
+  // Clocks
+  double ds1302DriftPpm = 20;
+  bool ds1302LostPower = false;
+  double sleepClockErrorPpm = 5000;
+  double sleepClockJitterPpm = 500;
+
+  // Network (ms)
+  double wifiScanMs = 1800;
+  double wifiAssociateMs = 350;
+  double dhcpMs = 900;
+  double wifiFailureRate = 0;
+  double dnsMs = 60;
+  double rttMs = 70;
+  double tlsFullHandshakeMs = 1800;
+  double tlsResumedHandshakeMs = 250;
+  double telegramServerMs = 150;
+  double telegramFailureRate = 0;
+  double ntpMs = 150;
+  double airtimeUsPerByte = 8;
+
+  // Food path
+  double hopperGrams = 1000;
+  double refillDays = 7;
+  double augerGramsPerSecond = 9;
+  double augerCoastMs = 60;  // full-speed run the auger is worth after a coast stop
+  double doseVariation = 0.35;
+  double jamProbability = 0.002;
+  double petEatMinutes = 20;
+  double leftoverFraction = 0;
+
+  // Load cell
+  double hx711NoiseGrams = 0.25;
+  double motorVibrationGrams = 4;
+  double hx711SettleMs = 400;
+  double hx711PeriodMs = 100;
+  int weighingResets = 0;  // resets at the first conversion read after power-up, as a watchdog would fire while weighing
+
+  // Applies one "--name=value" option. Returns false for unknown names or bad values.
+  bool apply(const std::string& name, const std::string& value);
+
+  static void printOptions(FILE* out);
+};
+
+}
+
+#endif
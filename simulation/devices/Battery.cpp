@@ -0,0 +1,81 @@
+#include "Battery.h"
+#include <algorithm>
+#include <cmath>
+
+namespace sim {
+
+struct OcvPoint {
+  double soc;
+  double volts;
+};
+
+// Open-circuit voltage of a typical 18650 cell at rest
+const OcvPoint OCV_TABLE[] = {
+  { 0.00, 3.00 },
+  { 0.05, 3.30 },
+  { 0.10, 3.50 },
+  { 0.20, 3.60 },
+  { 0.30, 3.68 },
+  { 0.40, 3.74 },
+  { 0.50, 3.79 },
+  { 0.60, 3.85 },
+  { 0.70, 3.92 },
+  { 0.80, 4.00 },
+  { 0.90, 4.08 },
+  { 1.00, 4.18 },
+};
+
+const double ADC_REFERENCE_MV = 3300;
+const double ADC_MAX = 4095;
+const double CALIBRATED_NOISE_MV = 2;
+
+Battery::Battery(Simulation& simulation, uint8_t sensePin)
+  : simulation(simulation), pin(sensePin) {
+  simulation.addComponent(this);
+  simulation.attachPin(sensePin, this);
+}
+
+double Battery::stateOfCharge() const {
+  const SimulationConfig& config = simulation.config();
+  double soc = config.batteryInitialPercent / 100.0 - simulation.meter().totalMah() / config.batteryMah;
+  return std::max(0.0, std::min(1.0, soc));
+}
+
+double Battery::openCircuitVoltage() const {
+  double soc = stateOfCharge();
+  const size_t points = sizeof(OCV_TABLE) / sizeof(OCV_TABLE[0]);
+
+  for (size_t i = 1; i < points; ++i) {
+    if (soc <= OCV_TABLE[i].soc) {
+      const OcvPoint& low = OCV_TABLE[i - 1];
+      const OcvPoint& high = OCV_TABLE[i];
+      return low.volts + (soc - low.soc) / (high.soc - low.soc) * (high.volts - low.volts);
+    }
+  }
+  return OCV_TABLE[points - 1].volts;
+}
+
+double Battery::terminalVoltage() const {
+  return openCircuitVoltage() - simulation.currentMa() / 1000.0 * simulation.config().batteryResistanceOhm;
+}
+
+uint16_t Battery::adcRaw() {
+  const SimulationConfig& config = simulation.config();
+  conversionCount++;
+
+  double millivolts = pinMilliVolts() * config.adcGain + config.adcOffsetMv;
+  double code = std::round(millivolts / ADC_REFERENCE_MV * ADC_MAX + simulation.normal(config.adcNoiseLsb));
+  return static_cast<uint16_t>(std::max(0.0, std::min(ADC_MAX, code)));
+}
+
+uint32_t Battery::adcMilliVolts() {
+  conversionCount++;
+  double millivolts = std::round(pinMilliVolts() + simulation.normal(CALIBRATED_NOISE_MV));
+  return static_cast<uint32_t>(std::max(0.0, millivolts));
+}
+
+double Battery::pinMilliVolts() const {
+  return terminalVoltage() * 1000.0 / simulation.config().dividerRatio;
+}
+
+}
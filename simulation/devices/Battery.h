@@ -0,0 +1,46 @@
+#ifndef SIM_BATTERY_H
+#define SIM_BATTERY_H
+
+#include "Simulation.h"
+
+namespace sim {
+
+// Li-ion pack behind a 1:5 divider on the voltage sensor pin. The state of
+// charge follows the charge drawn so far; the terminal voltage sags with the
+// load through the internal resistance.
+class Battery : public Component {
+public:
+  Battery(Simulation& simulation, uint8_t sensePin);
+
+  Phase phase() const override {
+    return Phase::Voltage;
+  }
+
+  uint8_t sensePin() const {
+    return pin;
+  }
+
+  double stateOfCharge() const;
+  double openCircuitVoltage() const;
+  double terminalVoltage() const;
+
+  // One ADC conversion of the sense pin: raw 12-bit code, or the millivolts
+  // after the eFuse calibration is applied.
+  uint16_t adcRaw();
+  uint32_t adcMilliVolts();
+
+  int conversions() const {
+    return conversionCount;
+  }
+
+private:
+  Simulation& simulation;
+  uint8_t pin;
+  int conversionCount = 0;
+
+  double pinMilliVolts() const;
+};
+
+}
+
+#endif
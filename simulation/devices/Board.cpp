@@ -0,0 +1,55 @@
+#include "Board.h"
+#include <stdexcept>
+#include <HardwareSerial.h>
+#include "UsedPins.h"
+
+namespace sim {
+
+// The journal partition in feeder/partitions.csv
+const size_t JOURNAL_PARTITION_SIZE = 0x10000;
+
+Board* Board::instance = nullptr;
+
+Board::Board(Simulation& simulation)
+  : sim(simulation),
+    foodModel(simulation),
+    motor(simulation, foodModel, MOTOR_IN1_PIN, MOTOR_IN2_PIN, MOTOR_STBY_PIN),
+    hx711(simulation, foodModel, LOADCELL_DOUT_PIN, LOADCELL_SCK_PIN, simulation.config().bowlGrams),
+    ds1302(simulation, RTC_MODULE_DAT_PIN, RTC_MODULE_CLK_PIN, RTC_MODULE_RST_PIN),
+    pack(simulation, VOLTAGE_SENSOR_PIN),
+    flash(simulation),
+    journalPartition(simulation, JOURNAL_PARTITION_SIZE),
+    wifi(simulation),
+    telegramServer(simulation) {
+  simulation.addComponent(this);
+  instance = this;
+}
+
+Board::~Board() {
+  if (instance == this) {
+    instance = nullptr;
+  }
+}
+
+Board& Board::get() {
+  if (instance == nullptr) {
+    throw std::logic_error("the board is used before the simulation started");
+  }
+  return *instance;
+}
+
+void Board::start() {
+  foodModel.start();
+
+  if (sim.config().ds1302LostPower) {
+    ds1302.loseTime();
+  } else {
+    ds1302.setTime(static_cast<time_t>(sim.trueUs() / US_PER_SECOND));
+  }
+}
+
+void Board::onBoot(bool coldBoot) {
+  Serial.end();
+}
+
+}
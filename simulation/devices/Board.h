@@ -0,0 +1,79 @@
+#ifndef SIM_BOARD_H
+#define SIM_BOARD_H
+
+#include "Simulation.h"
+#include "FoodModel.h"
+#include "Drv8833.h"
+#include "Hx711Chip.h"
+#include "Ds1302.h"
+#include "Battery.h"
+#include "Nvs.h"
+#include "DataPartition.h"
+#include "Network.h"
+#include "TelegramServer.h"
+
+namespace sim {
+
+// The feeder PCB and its surroundings, wired to the pins in UsedPins.h. The
+// Arduino fakes reach the devices through Board::get().
+class Board : public Component {
+public:
+  explicit Board(Simulation& simulation);
+  ~Board();
+
+  static Board& get();
+
+  // Puts the world into its initial state at the start time
+  void start();
+
+  void onBoot(bool coldBoot) override;
+
+  Simulation& simulation() {
+    return sim;
+  }
+  FoodModel& food() {
+    return foodModel;
+  }
+  Drv8833& motorDriver() {
+    return motor;
+  }
+  Hx711Chip& loadCell() {
+    return hx711;
+  }
+  Ds1302& rtc() {
+    return ds1302;
+  }
+  Battery& battery() {
+    return pack;
+  }
+  Nvs& nvs() {
+    return flash;
+  }
+  DataPartition& journal() {
+    return journalPartition;
+  }
+  Network& network() {
+    return wifi;
+  }
+  TelegramServer& telegram() {
+    return telegramServer;
+  }
+
+private:
+  static Board* instance;
+
+  Simulation& sim;
+  FoodModel foodModel;
+  Drv8833 motor;
+  Hx711Chip hx711;
+  Ds1302 ds1302;
+  Battery pack;
+  Nvs flash;
+  DataPartition journalPartition;
+  Network wifi;
+  TelegramServer telegramServer;
+};
+
+}
+
+#endif
@@ -0,0 +1,58 @@
+#include "DataPartition.h"
+#include <algorithm>
+#include <cstring>
+
+namespace sim {
+
+// SPI flash timings of the ESP32-C3 module (typical datasheet values)
+const int64_t FLASH_READ_US = 20;
+const int64_t FLASH_PAGE_PROGRAM_US = 400;
+const size_t FLASH_PAGE_SIZE = 256;
+const int64_t FLASH_SECTOR_ERASE_US = 45000;
+
+DataPartition::DataPartition(Simulation& simulation, size_t size)
+  : simulation(simulation), bytes(size, 0xFF), sectorErases(size / SECTOR_SIZE, 0) {}
+
+bool DataPartition::read(size_t offset, void* buffer, size_t length) {
+  if (offset > bytes.size() || length > bytes.size() - offset) {
+    return false;
+  }
+  statistics.reads++;
+  simulation.elapse(FLASH_READ_US, Phase::Nvs);
+  memcpy(buffer, bytes.data() + offset, length);
+  return true;
+}
+
+bool DataPartition::write(size_t offset, const void* data, size_t length) {
+  if (offset > bytes.size() || length > bytes.size() - offset) {
+    return false;
+  }
+
+  size_t pages = (offset + length + FLASH_PAGE_SIZE - 1) / FLASH_PAGE_SIZE - offset / FLASH_PAGE_SIZE;
+  statistics.writes++;
+  statistics.bytesWritten += length;
+  simulation.elapse(static_cast<int64_t>(pages) * FLASH_PAGE_PROGRAM_US, Phase::Nvs);
+
+  const uint8_t* source = static_cast<const uint8_t*>(data);
+  for (size_t i = 0; i < length; i++) {
+    bytes[offset + i] &= source[i];
+  }
+  return true;
+}
+
+bool DataPartition::erase(size_t offset, size_t length) {
+  if (offset % SECTOR_SIZE != 0 || length % SECTOR_SIZE != 0 || offset > bytes.size() || length > bytes.size() - offset) {
+    return false;
+  }
+
+  for (size_t sector = offset / SECTOR_SIZE; sector < (offset + length) / SECTOR_SIZE; sector++) {
+    statistics.erases++;
+    sectorErases[sector]++;
+    statistics.maxSectorErases = std::max(statistics.maxSectorErases, sectorErases[sector]);
+    simulation.elapse(FLASH_SECTOR_ERASE_US, Phase::Nvs);
+  }
+  std::fill(bytes.begin() + offset, bytes.begin() + offset + length, 0xFF);
+  return true;
+}
+
+}
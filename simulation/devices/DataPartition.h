@@ -0,0 +1,49 @@
+#ifndef SIM_DATA_PARTITION_H
+#define SIM_DATA_PARTITION_H
+
+#include <cstdint>
+#include <vector>
+#include "Simulation.h"
+
+namespace sim {
+
+// A raw data partition on the SPI flash, addressed through esp_partition_*.
+// Behaves like NOR flash: erase sets whole sectors to 0xFF and writes can only
+// clear bits. Survives deep sleep and power loss; accesses cost flash time.
+class DataPartition {
+public:
+  static const size_t SECTOR_SIZE = 4096;
+
+  DataPartition(Simulation& simulation, size_t size);
+
+  size_t size() const {
+    return bytes.size();
+  }
+
+  bool read(size_t offset, void* buffer, size_t length);
+  bool write(size_t offset, const void* data, size_t length);
+  // Offset and length must be sector aligned
+  bool erase(size_t offset, size_t length);
+
+  struct Stats {
+    int reads = 0;
+    int writes = 0;
+    size_t bytesWritten = 0;
+    int erases = 0;
+    int maxSectorErases = 0;
+  };
+
+  const Stats& stats() const {
+    return statistics;
+  }
+
+private:
+  Simulation& simulation;
+  std::vector<uint8_t> bytes;
+  std::vector<int> sectorErases;
+  Stats statistics;
+};
+
+}
+
+#endif
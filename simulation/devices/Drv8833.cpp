@@ -0,0 +1,158 @@
+#include "Drv8833.h"
+#include <algorithm>
+#include <cmath>
+
+namespace sim {
+
+// OUTPUT in the Arduino core
+const uint8_t PIN_MODE_OUTPUT = 0x03;
+// A free-wheeling auger loses speed to friction only, much slower than when driven or braked
+const double COAST_TIME_CONSTANT_FACTOR = 4;
+// Below this speed a new drive counts as a start from standstill
+const double STANDSTILL_SPEED = 0.1;
+
+Drv8833::Drv8833(Simulation& simulation, FoodModel& food, uint8_t in1Pin, uint8_t in2Pin, uint8_t standbyPin)
+  : simulation(simulation), food(food), in1Pin(in1Pin), in2Pin(in2Pin), standbyPin(standbyPin) {
+  simulation.addComponent(this);
+  simulation.attachPin(in1Pin, this);
+  simulation.attachPin(in2Pin, this);
+  simulation.attachPin(standbyPin, this);
+}
+
+double Drv8833::currentMa() const {
+  if (!standby) {
+    return 0;
+  }
+
+  double mA = simulation.config().motorDriverMa;
+  if (food.isRunning()) {
+    double duty = in1 > in2 ? in1 - in2 : in2 - in1;
+    mA += duty * (food.isJammed() ? simulation.config().motorStallMa : simulation.config().motorMa);
+  }
+  return mA;
+}
+
+bool Drv8833::busyPhase(Phase& phase) const {
+  if (standby && food.isRunning()) {
+    phase = Phase::Motor;
+    return true;
+  }
+  return false;
+}
+
+void Drv8833::pinModeChanged(uint8_t pin, uint8_t mode) {
+  if (mode != PIN_MODE_OUTPUT) {
+    setDuty(pin, 0);
+  } else {
+    setDuty(pin, simulation.pinLevel(pin));
+  }
+}
+
+void Drv8833::pinWritten(uint8_t pin, uint8_t level) {
+  if (simulation.pinModeOf(pin) == PIN_MODE_OUTPUT) {
+    setDuty(pin, level);
+  }
+}
+
+void Drv8833::pwmWritten(uint8_t pin, double duty) {
+  if (simulation.pinModeOf(pin) == PIN_MODE_OUTPUT) {
+    setDuty(pin, duty);
+  }
+}
+
+int Drv8833::pinRead(uint8_t pin) {
+  return simulation.pinLevel(pin);
+}
+
+void Drv8833::onDeepSleep() {
+  in1 = 0;
+  in2 = 0;
+  standby = false;
+  update();
+}
+
+void Drv8833::setDuty(uint8_t pin, double duty) {
+  if (pin == in1Pin) {
+    in1 = duty;
+  } else if (pin == in2Pin) {
+    in2 = duty;
+  } else if (pin == standbyPin) {
+    standby = duty > 0.5;
+  }
+  update();
+}
+
+void Drv8833::update() {
+  Drive drive = Drive::Coast;
+  double duty = 0;
+
+  if (standby) {
+    if (in1 > 0 && in2 > 0 && in1 == in2) {
+      drive = Drive::Brake;
+    } else if (in1 > in2) {
+      drive = Drive::Forward;
+      duty = in1 - in2;
+    } else if (in2 > in1) {
+      drive = Drive::Reverse;
+      duty = in2 - in1;
+    }
+  }
+
+  settleSpeed();
+  int64_t now = simulation.trueUs();
+  if (now > changedAtUs) {
+    peakCurrentMa = std::max(peakCurrentMa, pendingInrushMa);
+    startCount += pendingStart ? 1 : 0;
+    heldDuty = drivenDuty;
+    heldBraking = braking;
+  }
+
+  double signedDuty = drive == Drive::Reverse ? -duty : duty;
+  bool running = drive == Drive::Forward || drive == Drive::Reverse;
+  pendingInrushMa = 0;
+  pendingStart = false;
+  if ((running || drive == Drive::Brake) && (signedDuty != heldDuty || (drive == Drive::Brake) != heldBraking)) {
+    // Back-EMF of the spinning motor against the new drive; a jammed auger does not spin
+    const SimulationConfig& config = simulation.config();
+    double motorSpeed = food.isJammed() ? 0 : speed;
+    pendingInrushMa = std::fabs(signedDuty * config.motorStallMa - motorSpeed * (config.motorStallMa - config.motorMa));
+    pendingStart = running && heldDuty == 0 && std::fabs(motorSpeed) < STANDSTILL_SPEED;
+  }
+  drivenDuty = signedDuty;
+  braking = drive == Drive::Brake;
+  changedAtUs = now;
+
+  double brownoutProbability = simulation.config().brownoutProbability;
+  if (pendingStart && brownoutProbability > 0 && simulation.uniform() < brownoutProbability) {
+    simulation.brownout();
+  }
+
+  bool wasRunning = food.isRunning();
+  if (drive != food.drive() || (drive != Drive::Coast && drive != Drive::Brake)) {
+    food.setDrive(drive, duty);
+  }
+
+  if (!wasRunning && food.isRunning()) {
+    runningSinceUs = simulation.trueUs();
+  } else if (wasRunning && !food.isRunning()) {
+    totalRunningUs += simulation.trueUs() - runningSinceUs;
+  }
+}
+
+void Drv8833::settleSpeed() {
+  int64_t now = simulation.trueUs();
+  double ms = static_cast<double>(now - speedAtUs) / US_PER_MS;
+  speedAtUs = now;
+  if (ms <= 0) {
+    return;
+  }
+
+  double timeConstantMs = simulation.config().motorTimeConstantMs;
+  double target = food.isJammed() ? 0 : drivenDuty;
+  if (drivenDuty == 0 && !braking) {
+    timeConstantMs *= COAST_TIME_CONSTANT_FACTOR;
+  }
+  speed = timeConstantMs > 0 ? target + (speed - target) * std::exp(-ms / timeConstantMs) : target;
+}
+
+}
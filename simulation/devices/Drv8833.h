@@ -0,0 +1,77 @@
+#ifndef SIM_DRV8833_H
+#define SIM_DRV8833_H
+
+#include "Simulation.h"
+#include "FoodModel.h"
+
+namespace sim {
+
+// DRV8833 H-bridge driving the auger motor. IN1 high / IN2 low turns the auger
+// forward, the opposite reverses it, both low coasts and both high brakes.
+// Inputs are kept as duty cycles so PWM drive can be modelled as well.
+//
+// The motor speed follows the drive with a first-order lag, so a hard start
+// from standstill draws close to the stall current and a PWM ramp much less.
+// The inrush only shows in the peak; energy is charged at the running current.
+class Drv8833 : public Component {
+public:
+  Drv8833(Simulation& simulation, FoodModel& food, uint8_t in1Pin, uint8_t in2Pin, uint8_t standbyPin);
+
+  double currentMa() const override;
+  bool busyPhase(Phase& phase) const override;
+  Phase phase() const override {
+    return Phase::Motor;
+  }
+
+  void pinModeChanged(uint8_t pin, uint8_t mode) override;
+  void pinWritten(uint8_t pin, uint8_t level) override;
+  void pwmWritten(uint8_t pin, double duty) override;
+  int pinRead(uint8_t pin) override;
+  void onDeepSleep() override;
+
+  // Duty of a PWM-driven input, 0..1
+  void setDuty(uint8_t pin, double duty);
+
+  int64_t runningUs() const {
+    return totalRunningUs;
+  }
+  // Highest motor current seen, including the inrush on every drive change
+  double peakMa() const {
+    return peakCurrentMa;
+  }
+  // Times the motor was driven from (nearly) standstill
+  int starts() const {
+    return startCount;
+  }
+
+private:
+  Simulation& simulation;
+  FoodModel& food;
+  uint8_t in1Pin;
+  uint8_t in2Pin;
+  uint8_t standbyPin;
+  double in1 = 0;
+  double in2 = 0;
+  bool standby = false;
+  int64_t runningSinceUs = 0;
+  int64_t totalRunningUs = 0;
+  double speed = 0;  // signed, 1 is full forward speed
+  int64_t speedAtUs = 0;
+  double drivenDuty = 0;  // signed duty of the current drive, 0 when coasting or braking
+  bool braking = false;
+  int64_t changedAtUs = 0;
+  // The last drive that held for any time; a state in between two writes at the same instant draws nothing
+  double heldDuty = 0;
+  bool heldBraking = false;
+  double pendingInrushMa = 0;
+  bool pendingStart = false;
+  double peakCurrentMa = 0;
+  int startCount = 0;
+
+  void update();
+  void settleSpeed();
+};
+
+}
+
+#endif
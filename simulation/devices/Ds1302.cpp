@@ -0,0 +1,253 @@
+#include "Ds1302.h"
+#include <cmath>
+#include <cstring>
+
+namespace sim {
+
+const uint8_t PIN_MODE_OUTPUT = 0x03;
+const uint8_t BURST_ADDRESS = 31;
+const uint8_t TRICKLE_CHARGER_ADDRESS = 8;
+
+static uint8_t toBcd(int value) {
+  return static_cast<uint8_t>(((value / 10) << 4) | (value % 10));
+}
+
+static int fromBcd(uint8_t value) {
+  return (value >> 4) * 10 + (value & 0x0F);
+}
+
+Ds1302::Ds1302(Simulation& simulation, uint8_t ioPin, uint8_t sclkPin, uint8_t cePin)
+  : simulation(simulation), ioPin(ioPin), sclkPin(sclkPin), cePin(cePin) {
+  simulation.addComponent(this);
+  simulation.attachPin(ioPin, this);
+  simulation.attachPin(sclkPin, this);
+  simulation.attachPin(cePin, this);
+}
+
+void Ds1302::loseTime() {
+  const uint8_t powerOn[CLOCK_REGISTERS] = { 0x80, 0, 0, 0, 0, 0, 0, 0x80 };
+  anchor(powerOn);
+}
+
+void Ds1302::setTime(time_t utc) {
+  struct tm parts;
+  gmtime_r(&utc, &parts);
+
+  uint8_t registers[CLOCK_REGISTERS] = {
+    toBcd(parts.tm_sec),
+    toBcd(parts.tm_min),
+    toBcd(parts.tm_hour),
+    toBcd(parts.tm_mday),
+    toBcd(parts.tm_mon + 1),
+    toBcd(parts.tm_wday == 0 ? 7 : parts.tm_wday),
+    toBcd(parts.tm_year + 1900 - 2000),
+    0,
+  };
+  anchor(registers);
+}
+
+double Ds1302::secondsNow() const {
+  if (isHalted() || !dateValid) {
+    return -1;
+  }
+  double elapsed = static_cast<double>(simulation.trueUs() - anchorTrueUs) / US_PER_SECOND;
+  return anchorEpoch + elapsed * (1.0 + simulation.config().ds1302DriftPpm / 1e6);
+}
+
+void Ds1302::pinWritten(uint8_t pin, uint8_t level) {
+  if (pin == cePin) {
+    if (level && !session) {
+      session = true;
+      bits = 0;
+      command = 0;
+      data = 0;
+      outputSize = 0;
+      sessionCount++;
+    } else if (!level) {
+      session = false;
+    }
+    return;
+  }
+
+  if (pin != sclkPin) {
+    return;
+  }
+
+  bool rising = level && !sclk;
+  bool falling = !level && sclk;
+  sclk = level;
+
+  if (!session) {
+    return;
+  }
+
+  bool read = (command & 0x01) != 0;
+
+  if (rising) {
+    uint8_t io = simulation.pinLevel(ioPin);
+    if (bits < 8) {
+      command |= io << bits;
+      bits++;
+      if (bits == 8) {
+        commandReceived();
+      }
+    } else if (!read) {
+      int dataBit = bits - 8;
+      data |= io << (dataBit % 8);
+      bits++;
+      if ((dataBit % 8) == 7) {
+        byteReceived(dataBit / 8, data);
+        data = 0;
+      }
+    } else {
+      bits++;
+    }
+  } else if (falling && read && bits >= 8) {
+    int outputIndex = bits - 8;
+    int byteIndex = outputIndex / 8;
+    outputBit = byteIndex < outputSize ? (output[byteIndex] >> (outputIndex % 8)) & 0x01 : 0;
+  }
+}
+
+int Ds1302::pinRead(uint8_t pin) {
+  if (pin == ioPin && session && (command & 0x01) && bits >= 8 && simulation.pinModeOf(ioPin) != PIN_MODE_OUTPUT) {
+    return outputBit;
+  }
+
+  // Internal pull-downs keep undriven lines low
+  return simulation.pinModeOf(pin) == PIN_MODE_OUTPUT ? simulation.pinLevel(pin) : 0;
+}
+
+void Ds1302::currentClock(uint8_t* registers) const {
+  memcpy(registers, clock, CLOCK_REGISTERS);
+
+  double seconds = secondsNow();
+  if (seconds < 0) {
+    return;
+  }
+
+  time_t now = static_cast<time_t>(std::floor(seconds));
+  struct tm parts;
+  gmtime_r(&now, &parts);
+
+  registers[0] = toBcd(parts.tm_sec);
+  registers[1] = toBcd(parts.tm_min);
+  registers[2] = toBcd(parts.tm_hour);
+  registers[3] = toBcd(parts.tm_mday);
+  registers[4] = toBcd(parts.tm_mon + 1);
+  registers[5] = toBcd(parts.tm_wday == 0 ? 7 : parts.tm_wday);
+  registers[6] = toBcd(parts.tm_year + 1900 - 2000);
+}
+
+void Ds1302::anchor(const uint8_t* registers) {
+  memcpy(clock, registers, CLOCK_REGISTERS);
+  anchorTrueUs = simulation.trueUs();
+
+  int second = fromBcd(registers[0] & 0x7F);
+  int minute = fromBcd(registers[1]);
+  int hour = fromBcd(registers[2] & 0x3F);
+  int day = fromBcd(registers[3]);
+  int month = fromBcd(registers[4]);
+  int year = fromBcd(registers[6]) + 2000;
+
+  dateValid = second < 60 && minute < 60 && hour < 24 && day >= 1 && day <= 31 && month >= 1 && month <= 12;
+  if (dateValid) {
+    struct tm parts = {};
+    parts.tm_year = year - 1900;
+    parts.tm_mon = month - 1;
+    parts.tm_mday = day;
+    parts.tm_hour = hour;
+    parts.tm_min = minute;
+    parts.tm_sec = second;
+    anchorEpoch = timegm(&parts);
+  }
+}
+
+void Ds1302::commandReceived() {
+  if (!(command & 0x80)) {
+    session = false;  // bit 7 must be set, the chip ignores the rest of the session
+    return;
+  }
+
+  if (!(command & 0x01)) {
+    return;
+  }
+
+  uint8_t address = (command >> 1) & 0x1F;
+  bool isRam = (command & 0x40) != 0;
+
+  if (isRam) {
+    if (address == BURST_ADDRESS) {
+      memcpy(output, ram, RAM_SIZE);
+      outputSize = RAM_SIZE;
+    } else {
+      output[0] = ram[address];
+      outputSize = 1;
+    }
+    return;
+  }
+
+  uint8_t registers[CLOCK_REGISTERS];
+  currentClock(registers);
+
+  if (address == BURST_ADDRESS) {
+    memcpy(output, registers, CLOCK_REGISTERS);
+    outputSize = CLOCK_REGISTERS;
+  } else if (address < CLOCK_REGISTERS) {
+    output[0] = registers[address];
+    outputSize = 1;
+  } else if (address == TRICKLE_CHARGER_ADDRESS) {
+    output[0] = trickleCharger;
+    outputSize = 1;
+  } else {
+    outputSize = 0;
+  }
+}
+
+void Ds1302::byteReceived(int index, uint8_t value) {
+  uint8_t address = (command >> 1) & 0x1F;
+  bool isRam = (command & 0x40) != 0;
+
+  // With WP set only the control register itself accepts writes
+  if (isWriteProtected() && (isRam || address != 7)) {
+    return;
+  }
+
+  if (isRam) {
+    if (address == BURST_ADDRESS) {
+      if (index < RAM_SIZE) {
+        ram[index] = value;
+      }
+    } else if (index == 0) {
+      ram[address] = value;
+    }
+    return;
+  }
+
+  if (address == BURST_ADDRESS) {
+    if (index < CLOCK_REGISTERS) {
+      burstWrite[index] = value;
+      if (index == CLOCK_REGISTERS - 1) {
+        anchor(burstWrite);
+      }
+    }
+    return;
+  }
+
+  if (index != 0) {
+    return;
+  }
+
+  if (address == CLOCK_REGISTERS - 1) {
+    clock[address] = value;  // control register, the time keeps running
+  } else if (address < CLOCK_REGISTERS) {
+    uint8_t registers[CLOCK_REGISTERS];
+    currentClock(registers);
+    registers[address] = value;
+    anchor(registers);
+  } else if (address == TRICKLE_CHARGER_ADDRESS) {
+    trickleCharger = value;
+  }
+}
+
+}
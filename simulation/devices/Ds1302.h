@@ -0,0 +1,76 @@
+#ifndef SIM_DS1302_H
+#define SIM_DS1302_H
+
+#include <ctime>
+#include "Simulation.h"
+
+namespace sim {
+
+// DS1302 timekeeper on its own coin cell. A session starts when CE goes high;
+// the command byte and written data are sampled LSB first on SCLK rising
+// edges, read data is presented on the falling edges that follow the command.
+// The crystal runs off by a configurable number of ppm.
+class Ds1302 : public Component {
+public:
+  Ds1302(Simulation& simulation, uint8_t ioPin, uint8_t sclkPin, uint8_t cePin);
+
+  Phase phase() const override {
+    return Phase::Rtc;
+  }
+
+  void pinWritten(uint8_t pin, uint8_t level) override;
+  int pinRead(uint8_t pin) override;
+
+  void loseTime();
+  void setTime(time_t utc);
+  // What the chip would read right now, or -1 when halted or invalid
+  double secondsNow() const;
+
+  int sessions() const {
+    return sessionCount;
+  }
+
+private:
+  static const int CLOCK_REGISTERS = 8;
+  static const int RAM_SIZE = 31;
+
+  Simulation& simulation;
+  uint8_t ioPin;
+  uint8_t sclkPin;
+  uint8_t cePin;
+
+  // Clock registers as of the anchor, plus the time they were anchored at
+  uint8_t clock[CLOCK_REGISTERS] = {};
+  bool dateValid = false;
+  time_t anchorEpoch = 0;
+  int64_t anchorTrueUs = 0;
+  uint8_t ram[RAM_SIZE] = {};
+  uint8_t trickleCharger = 0x5C;
+
+  // Session state
+  bool session = false;
+  uint8_t sclk = 0;
+  int bits = 0;
+  uint8_t command = 0;
+  uint8_t data = 0;
+  uint8_t output[RAM_SIZE] = {};
+  int outputSize = 0;
+  uint8_t outputBit = 0;
+  uint8_t burstWrite[CLOCK_REGISTERS] = {};
+  int sessionCount = 0;
+
+  bool isHalted() const {
+    return (clock[0] & 0x80) != 0;
+  }
+  bool isWriteProtected() const {
+    return (clock[7] & 0x80) != 0;
+  }
+  void currentClock(uint8_t* registers) const;
+  void anchor(const uint8_t* registers);
+  void commandReceived();
+  void byteReceived(int index, uint8_t value);
+};
+
+}
+
+#endif
@@ -0,0 +1,114 @@
+#include "FoodModel.h"
+#include <algorithm>
+
+namespace sim {
+
+// Chance that one reverse pulse frees a jammed auger
+const double JAM_CLEAR_PROBABILITY = 0.7;
+
+FoodModel::FoodModel(Simulation& simulation)
+  : simulation(simulation) {}
+
+void FoodModel::start() {
+  hopper = simulation.config().hopperGrams;
+  settledAtUs = simulation.trueUs();
+  scheduleRefill();
+}
+
+void FoodModel::setDrive(Drive drive, double newDuty) {
+  settle();
+
+  if (drive == Drive::Forward && currentDrive != Drive::Forward) {
+    statistics.forwardPulses++;
+    doseFactor = std::max(0.0, 1.0 + simulation.normal(simulation.config().doseVariation));
+    if (!jammed && simulation.uniform() < simulation.config().jamProbability) {
+      jammed = true;
+      statistics.jams++;
+    }
+    if (hopper <= 0) {
+      statistics.emptyHopperPulses++;
+    }
+  }
+
+  if (drive == Drive::Reverse && currentDrive != Drive::Reverse) {
+    statistics.reversePulses++;
+    if (jammed && simulation.uniform() < JAM_CLEAR_PROBABILITY) {
+      jammed = false;
+      statistics.jamsCleared++;
+    }
+  }
+
+  // A coasting auger keeps turning for a moment; braking stops it at once
+  if (currentDrive == Drive::Forward && drive == Drive::Coast && !jammed) {
+    double grams = simulation.config().augerGramsPerSecond * duty * doseFactor * simulation.config().augerCoastMs / 1000;
+    grams = std::min(grams, hopper);
+    hopper -= grams;
+    bowl += grams;
+    statistics.dispensedGrams += grams;
+  }
+
+  bool wasRunning = isRunning();
+  currentDrive = drive;
+  duty = newDuty;
+
+  if (wasRunning && !isRunning()) {
+    scheduleEating();
+  }
+}
+
+double FoodModel::bowlGrams() {
+  settle();
+  return bowl;
+}
+
+double FoodModel::hopperGrams() {
+  settle();
+  return hopper;
+}
+
+void FoodModel::settle() {
+  int64_t now = simulation.trueUs();
+  double seconds = static_cast<double>(now - settledAtUs) / US_PER_SECOND;
+  settledAtUs = now;
+
+  if (currentDrive != Drive::Forward || jammed || seconds <= 0) {
+    return;
+  }
+
+  double grams = simulation.config().augerGramsPerSecond * duty * doseFactor * seconds;
+  grams = std::min(grams, hopper);
+  hopper -= grams;
+  bowl += grams;
+  statistics.dispensedGrams += grams;
+}
+
+void FoodModel::scheduleRefill() {
+  double days = simulation.config().refillDays;
+  if (days <= 0) {
+    return;
+  }
+
+  simulation.schedule(simulation.trueUs() + static_cast<int64_t>(days * US_PER_DAY), [this]() {
+    settle();
+    hopper = simulation.config().hopperGrams;
+    statistics.refills++;
+    scheduleRefill();
+  });
+}
+
+void FoodModel::scheduleEating() {
+  uint64_t token = ++eatingToken;
+  int64_t at = simulation.trueUs() + static_cast<int64_t>(simulation.config().petEatMinutes * 60 * US_PER_SECOND);
+
+  simulation.schedule(at, [this, token]() {
+    if (token != eatingToken) {
+      return;  // the motor ran again since, the pet waits for the whole portion
+    }
+    settle();
+    double eaten = bowl * (1.0 - simulation.config().leftoverFraction);
+    bowl -= eaten;
+    statistics.eatenGrams += eaten;
+  });
+}
+
+}
@@ -0,0 +1,75 @@
+#ifndef SIM_FOOD_MODEL_H
+#define SIM_FOOD_MODEL_H
+
+#include <cstdint>
+#include "Simulation.h"
+
+namespace sim {
+
+enum class Drive : uint8_t {
+  Coast,
+  Forward,
+  Reverse,
+  Brake,
+};
+
+// Hopper, auger and bowl. Food moves while the auger turns forward; a pet
+// empties the bowl some time after each feeding and the owner refills the
+// hopper every few days.
+class FoodModel {
+public:
+  explicit FoodModel(Simulation& simulation);
+
+  void start();
+
+  // Called by the motor driver on every change of direction or duty.
+  void setDrive(Drive drive, double duty);
+  Drive drive() const {
+    return currentDrive;
+  }
+  bool isRunning() const {
+    return currentDrive == Drive::Forward || currentDrive == Drive::Reverse;
+  }
+  bool isJammed() const {
+    return jammed;
+  }
+
+  // Food currently in the bowl
+  double bowlGrams();
+  double hopperGrams();
+
+  struct Stats {
+    double dispensedGrams = 0;
+    double eatenGrams = 0;
+    int forwardPulses = 0;
+    int reversePulses = 0;
+    int jams = 0;
+    int jamsCleared = 0;
+    int emptyHopperPulses = 0;
+    int refills = 0;
+  };
+
+  const Stats& stats() const {
+    return statistics;
+  }
+
+private:
+  Simulation& simulation;
+  Drive currentDrive = Drive::Coast;
+  double duty = 0;
+  double doseFactor = 1;
+  bool jammed = false;
+  double hopper = 0;
+  double bowl = 0;
+  int64_t settledAtUs = 0;
+  uint64_t eatingToken = 0;
+  Stats statistics;
+
+  void settle();
+  void scheduleRefill();
+  void scheduleEating();
+};
+
+}
+
+#endif
@@ -0,0 +1,189 @@
+#include "Hx711Chip.h"
+#include <cmath>
+
+namespace sim {
+
+// Calibration of the real feeder (see WeightSensor in feeder.ino)
+const double LOADCELL_COUNTS_PER_GRAM = 1106;
+const double LOADCELL_ZERO_COUNTS = -62230;
+const int64_t POWER_DOWN_HIGH_US = 60;
+const int DATA_BITS = 24;
+const uint8_t PIN_MODE_OUTPUT = 0x03;
+
+Hx711Chip::Hx711Chip(Simulation& simulation, FoodModel& food, uint8_t doutPin, uint8_t sckPin, double bowlGrams)
+  : simulation(simulation), food(food), doutPin(doutPin), sckPin(sckPin), bowlGrams(bowlGrams) {
+  simulation.addComponent(this);
+  simulation.attachPin(doutPin, this);
+  simulation.attachPin(sckPin, this);
+}
+
+double Hx711Chip::currentMa() const {
+  return powered ? simulation.config().hx711Ma : 0;
+}
+
+bool Hx711Chip::busyPhase(Phase& phase) const {
+  if (powered && hostWaiting) {
+    phase = Phase::Weight;
+    return true;
+  }
+  return false;
+}
+
+void Hx711Chip::pinModeChanged(uint8_t pin, uint8_t mode) {
+  if (pin != sckPin) {
+    return;
+  }
+
+  updatePower();
+  if (mode != PIN_MODE_OUTPUT) {
+    powerDown();
+  } else if (!powered && simulation.pinLevel(sckPin) == 0) {
+    powerUp();
+  }
+}
+
+void Hx711Chip::pinWritten(uint8_t pin, uint8_t level) {
+  if (pin != sckPin || simulation.pinModeOf(sckPin) != PIN_MODE_OUTPUT) {
+    return;
+  }
+
+  updatePower();
+
+  if (level == 0) {
+    sckHighSinceUs = -1;
+    if (!powered) {
+      powerUp();
+    }
+    return;
+  }
+
+  if (sckHighSinceUs >= 0) {
+    return;  // already high
+  }
+  sckHighSinceUs = simulation.trueUs();
+  simulation.schedule(sckHighSinceUs + POWER_DOWN_HIGH_US + 1, [this]() { updatePower(); }, true);
+
+  if (!powered) {
+    return;
+  }
+
+  // Rising edge: shift the next bit out, or finish the read with the gain pulse
+  if (bitsClocked == 0) {
+    if (!dataReady()) {
+      return;  // extra gain pulses
+    }
+    latchedConversion = latestConversion();
+    latchedValue = convert();
+  }
+
+  bitsClocked++;
+  if (bitsClocked > DATA_BITS) {
+    consumedConversion = latchedConversion;
+    bitsClocked = 0;
+    readings++;
+
+    // Reported as a brownout; the firmware resumes the same way after a watchdog reset
+    if (readingsSincePowerUp++ == 0 && resetsInjected < simulation.config().weighingResets) {
+      resetsInjected++;
+      simulation.brownout();
+    }
+  }
+}
+
+int Hx711Chip::pinRead(uint8_t pin) {
+  if (pin != doutPin) {
+    return simulation.pinLevel(pin);
+  }
+
+  updatePower();
+  if (!powered) {
+    hostWaiting = false;
+    return 1;
+  }
+
+  if (bitsClocked > 0) {
+    return (latchedValue >> (DATA_BITS - bitsClocked)) & 1;
+  }
+
+  bool ready = dataReady();
+  hostWaiting = !ready;
+  return ready ? 0 : 1;
+}
+
+void Hx711Chip::onDeepSleep() {
+  powerDown();
+  sckHighSinceUs = -1;
+}
+
+bool Hx711Chip::isPowered() {
+  updatePower();
+  return powered;
+}
+
+void Hx711Chip::updatePower() {
+  if (powered && sckHighSinceUs >= 0 && simulation.trueUs() - sckHighSinceUs > POWER_DOWN_HIGH_US) {
+    powerDown();
+  }
+}
+
+void Hx711Chip::powerUp() {
+  powered = true;
+  poweredAtUs = simulation.trueUs();
+  consumedConversion = -1;
+  bitsClocked = 0;
+  readingsSincePowerUp = 0;
+  powerCycle++;
+  scheduleConversion(0);
+}
+
+void Hx711Chip::powerDown() {
+  powered = false;
+  powerCycle++;
+  hostWaiting = false;
+  bitsClocked = 0;
+}
+
+void Hx711Chip::scheduleConversion(int64_t index) {
+  const SimulationConfig& config = simulation.config();
+  int64_t atUs = poweredAtUs + static_cast<int64_t>((config.hx711SettleMs + index * config.hx711PeriodMs) * US_PER_MS);
+  uint64_t cycle = powerCycle;
+
+  simulation.schedule(atUs, [this, index, cycle]() {
+    updatePower();
+    if (!powered || cycle != powerCycle) {
+      return;
+    }
+    // DOUT only falls if the previous conversion was read; otherwise it is still low
+    if (consumedConversion == index - 1 && bitsClocked == 0) {
+      simulation.signalEdge(doutPin, 0);
+    }
+    scheduleConversion(index + 1);
+  }, true);
+}
+
+int64_t Hx711Chip::latestConversion() const {
+  const SimulationConfig& config = simulation.config();
+  int64_t sincePowerUp = simulation.trueUs() - poweredAtUs - static_cast<int64_t>(config.hx711SettleMs * US_PER_MS);
+  if (sincePowerUp < 0) {
+    return -1;
+  }
+  return sincePowerUp / static_cast<int64_t>(config.hx711PeriodMs * US_PER_MS);
+}
+
+bool Hx711Chip::dataReady() const {
+  return latestConversion() > consumedConversion;
+}
+
+int32_t Hx711Chip::convert() {
+  const SimulationConfig& config = simulation.config();
+  double grams = bowlGrams + food.bowlGrams() + simulation.normal(config.hx711NoiseGrams);
+  if (food.isRunning()) {
+    grams += simulation.normal(config.motorVibrationGrams);
+  }
+
+  double counts = std::round(LOADCELL_ZERO_COUNTS + LOADCELL_COUNTS_PER_GRAM * grams);
+  counts = std::max(-8388608.0, std::min(8388607.0, counts));
+  return static_cast<int32_t>(counts) & 0xFFFFFF;
+}
+
+}
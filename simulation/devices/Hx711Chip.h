@@ -0,0 +1,66 @@
+#ifndef SIM_HX711_CHIP_H
+#define SIM_HX711_CHIP_H
+
+#include "Simulation.h"
+#include "FoodModel.h"
+
+namespace sim {
+
+// HX711 load cell amplifier under the bowl. Powered while PD_SCK is driven low;
+// holding PD_SCK high for more than 60 us powers it down. After power-up the
+// first conversion takes the settling time, then one completes every period.
+// DOUT goes low when data is ready and the 24 bits are shifted out MSB first
+// on the rising edges of PD_SCK. The falling edge of DOUT is signalled, so the
+// firmware can read conversions from an interrupt.
+class Hx711Chip : public Component {
+public:
+  Hx711Chip(Simulation& simulation, FoodModel& food, uint8_t doutPin, uint8_t sckPin, double bowlGrams);
+
+  double currentMa() const override;
+  bool busyPhase(Phase& phase) const override;
+  Phase phase() const override {
+    return Phase::Weight;
+  }
+
+  void pinModeChanged(uint8_t pin, uint8_t mode) override;
+  void pinWritten(uint8_t pin, uint8_t level) override;
+  int pinRead(uint8_t pin) override;
+  void onDeepSleep() override;
+
+  bool isPowered();
+  int conversionsRead() const {
+    return readings;
+  }
+
+private:
+  Simulation& simulation;
+  FoodModel& food;
+  uint8_t doutPin;
+  uint8_t sckPin;
+  double bowlGrams;
+
+  bool powered = false;
+  int64_t poweredAtUs = 0;
+  int64_t sckHighSinceUs = -1;
+  int64_t consumedConversion = -1;
+  int64_t latchedConversion = -1;
+  int bitsClocked = 0;
+  int32_t latchedValue = 0;
+  bool hostWaiting = false;
+  int readings = 0;
+  int readingsSincePowerUp = 0;
+  int resetsInjected = 0;
+  uint64_t powerCycle = 0;
+
+  void updatePower();
+  void powerUp();
+  void powerDown();
+  void scheduleConversion(int64_t index);
+  int64_t latestConversion() const;
+  bool dataReady() const;
+  int32_t convert();
+};
+
+}
+
+#endif
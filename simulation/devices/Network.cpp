@@ -0,0 +1,184 @@
+#include "Network.h"
+#include <cstring>
+
+namespace sim {
+
+Network::Network(Simulation& simulation)
+  : simulation(simulation) {
+  simulation.addComponent(this);
+}
+
+double Network::currentMa() const {
+  const SimulationConfig& config = simulation.config();
+
+  switch (state) {
+    case Link::Connecting:
+    case Link::AccessPoint:
+      return config.radioActiveMa;
+    case Link::Connected:
+      return activity > 0 ? config.radioActiveMa : config.radioIdleMa;
+    default:
+      return 0;
+  }
+}
+
+bool Network::busyPhase(Phase& phase) const {
+  if (state == Link::Connecting) {
+    phase = Phase::WiFi;
+    return true;
+  }
+  if (timePending) {
+    phase = Phase::Ntp;
+    return true;
+  }
+  return false;
+}
+
+void Network::onBoot(bool coldBoot) {
+  state = Link::Off;
+  useStaticConfig = false;
+  activity = 0;
+}
+
+void Network::onDeepSleep() {
+  linkDown();
+  state = Link::Off;
+}
+
+void Network::connect(const std::string& ssid, const std::string& password, int32_t hintChannel, const uint8_t* hintBssid) {
+  const SimulationConfig& config = simulation.config();
+
+  linkDown();
+  state = Link::Connecting;
+  statistics.connects++;
+
+  bool hinted = hintChannel == AP_CHANNEL && hintBssid != nullptr && memcmp(hintBssid, AP_BSSID, sizeof(AP_BSSID)) == 0;
+  double ms = 0;
+  if (!hinted) {
+    statistics.scans++;
+    ms += config.wifiScanMs;
+  }
+
+  Link outcome = Link::Connected;
+  if (ssid != AP_SSID) {
+    outcome = Link::NoSsid;
+  } else {
+    ms += config.wifiAssociateMs;
+    if (password != AP_PASSWORD || simulation.uniform() < config.wifiFailureRate) {
+      outcome = Link::Failed;
+    } else if (!useStaticConfig) {
+      statistics.dhcpExchanges++;
+      ms += config.dhcpMs;
+    }
+  }
+
+  int64_t startedUs = simulation.trueUs();
+  int64_t durationUs = static_cast<int64_t>(ms * US_PER_MS);
+  uint64_t thisAttempt = ++attempt;
+
+  simulation.schedule(startedUs + durationUs, [this, outcome, ssid, durationUs, thisAttempt]() {
+    if (thisAttempt != attempt || state != Link::Connecting) {
+      return;
+    }
+
+    state = outcome;
+    statistics.connectUs += durationUs;
+    statistics.lastConnectUs = durationUs;
+
+    if (outcome != Link::Connected) {
+      statistics.failures++;
+      return;
+    }
+
+    connectedSsid = ssid;
+    if (useStaticConfig) {
+      ip = staticConfig;
+    } else {
+      ip.ip = DHCP_LEASE;
+      ip.gateway = AP_GATEWAY;
+      ip.subnet = AP_SUBNET;
+      ip.dns = AP_GATEWAY;
+    }
+  }, true);
+}
+
+void Network::disconnect(bool radioOff) {
+  linkDown();
+  state = Link::Off;
+}
+
+void Network::setStaticConfig(const IpConfig& config) {
+  staticConfig = config;
+  useStaticConfig = config.ip != 0;
+}
+
+void Network::saveCredentials(const std::string& ssid, const std::string& password) {
+  storedSsid = ssid;
+  storedPassword = password;
+}
+
+void Network::startAccessPoint() {
+  linkDown();
+  state = Link::AccessPoint;
+}
+
+void Network::stopAccessPoint() {
+  if (state == Link::AccessPoint) {
+    state = Link::Off;
+  }
+}
+
+bool Network::resolve(const std::string& host) {
+  if (!isConnected()) {
+    return false;
+  }
+  if (resolvedHosts.count(host) > 0) {
+    return true;
+  }
+
+  statistics.dnsLookups++;
+  RadioActivity radio(*this);
+  simulation.elapse(static_cast<int64_t>(simulation.config().dnsMs * US_PER_MS), Phase::WiFi);
+  resolvedHosts.insert(host);
+  return isConnected();
+}
+
+void Network::requestTime(std::function<void()> onSynced) {
+  if (!isConnected()) {
+    return;  // lwIP keeps retrying in the background, which never succeeds offline
+  }
+
+  timePending = true;
+  int64_t at = simulation.trueUs() + static_cast<int64_t>((simulation.config().dnsMs + simulation.config().ntpMs) * US_PER_MS);
+  uint64_t requestGeneration = generation;
+
+  simulation.schedule(at, [this, onSynced, requestGeneration]() {
+    if (requestGeneration != generation) {
+      return;
+    }
+    timePending = false;
+    statistics.timeSyncs++;
+    simulation.setEspClockUs(simulation.trueUs());
+    onSynced();
+  }, true);
+}
+
+void Network::linkDown() {
+  generation++;
+  attempt++;
+  resolvedHosts.clear();
+  timePending = false;
+  ip = IpConfig();
+  connectedSsid.clear();
+}
+
+Network::RadioActivity::RadioActivity(Network& network)
+  : network(network) {
+  network.activity++;
+}
+
+Network::RadioActivity::~RadioActivity() {
+  network.activity--;
+}
+
+}
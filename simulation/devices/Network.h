@@ -0,0 +1,147 @@
+#ifndef SIM_NETWORK_H
+#define SIM_NETWORK_H
+
+#include <cstdint>
+#include <functional>
+#include <set>
+#include <string>
+#include "Simulation.h"
+
+namespace sim {
+
+// The home access point the feeder is configured for
+const char* const AP_SSID = "HomeNetwork";
+const char* const AP_PASSWORD = "correct-horse";
+const int32_t AP_CHANNEL = 6;
+const uint8_t AP_BSSID[6] = { 0x24, 0x4B, 0xFE, 0x12, 0x34, 0x56 };
+const uint32_t AP_GATEWAY = 0x0101A8C0;  // 192.168.1.1, network byte order
+const uint32_t AP_SUBNET = 0x00FFFFFF;   // 255.255.255.0
+const uint32_t DHCP_LEASE = 0x3901A8C0;  // 192.168.1.57
+
+// The ESP32 Wi-Fi radio and the network beyond it: association, DHCP, DNS and
+// SNTP. Everything the radio knows except the saved credentials is lost in
+// deep sleep.
+class Network : public Component {
+public:
+  enum class Link : uint8_t {
+    Off,
+    Connecting,
+    Connected,
+    Failed,
+    NoSsid,
+    AccessPoint,
+  };
+
+  struct IpConfig {
+    uint32_t ip = 0;
+    uint32_t gateway = 0;
+    uint32_t subnet = 0;
+    uint32_t dns = 0;
+  };
+
+  explicit Network(Simulation& simulation);
+
+  double currentMa() const override;
+  bool busyPhase(Phase& phase) const override;
+  Phase phase() const override {
+    return Phase::WiFi;
+  }
+  void onBoot(bool coldBoot) override;
+  void onDeepSleep() override;
+
+  // Station mode. Without a matching channel and BSSID hint the radio scans all
+  // channels first; with a static configuration DHCP is skipped.
+  void connect(const std::string& ssid, const std::string& password, int32_t channel, const uint8_t* bssid);
+  void disconnect(bool radioOff);
+  void setStaticConfig(const IpConfig& config);
+  Link link() const {
+    return state;
+  }
+  bool isConnected() const {
+    return state == Link::Connected;
+  }
+  const IpConfig& ipConfig() const {
+    return ip;
+  }
+  int32_t channel() const {
+    return isConnected() ? AP_CHANNEL : 0;
+  }
+  const std::string& ssid() const {
+    return connectedSsid;
+  }
+
+  // Station configuration the Wi-Fi driver keeps in its own flash area
+  const std::string& savedSsid() const {
+    return storedSsid;
+  }
+  const std::string& savedPassword() const {
+    return storedPassword;
+  }
+  void saveCredentials(const std::string& ssid, const std::string& password);
+
+  void startAccessPoint();
+  void stopAccessPoint();
+
+  // Bumped whenever the link goes down, which kills every open TCP connection
+  uint64_t linkGeneration() const {
+    return generation;
+  }
+
+  // Costs a DNS round trip unless the host was resolved since the link came up
+  bool resolve(const std::string& host);
+
+  // SNTP request; the callback runs when the answer arrives
+  void requestTime(std::function<void()> onSynced);
+  bool isTimePending() const {
+    return timePending;
+  }
+
+  // Keeps the radio in its high-power state while data is on the air
+  class RadioActivity {
+  public:
+    explicit RadioActivity(Network& network);
+    ~RadioActivity();
+    RadioActivity(const RadioActivity&) = delete;
+    RadioActivity& operator=(const RadioActivity&) = delete;
+
+  private:
+    Network& network;
+  };
+
+  struct Stats {
+    int connects = 0;
+    int failures = 0;
+    int scans = 0;
+    int dhcpExchanges = 0;
+    int64_t connectUs = 0;
+    int64_t lastConnectUs = 0;
+    int dnsLookups = 0;
+    int timeSyncs = 0;
+  };
+
+  const Stats& stats() const {
+    return statistics;
+  }
+
+private:
+  Simulation& simulation;
+  Link state = Link::Off;
+  IpConfig ip;
+  IpConfig staticConfig;
+  bool useStaticConfig = false;
+  std::string connectedSsid;
+  std::string storedSsid;
+  std::string storedPassword;
+  uint64_t generation = 1;
+  uint64_t attempt = 0;
+  std::set<std::string> resolvedHosts;
+  bool timePending = false;
+  int activity = 0;
+  Stats statistics;
+
+  void linkDown();
+};
+
+}
+
+#endif
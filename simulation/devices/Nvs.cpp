@@ -0,0 +1,77 @@
+#include "Nvs.h"
+
+namespace sim {
+
+// Flash access costs of the NVS library on the ESP32-C3
+const int64_t NVS_OPEN_US = 150;
+const int64_t NVS_CLOSE_US = 50;
+const int64_t NVS_READ_US = 250;
+const int64_t NVS_WRITE_US = 3000;
+const int64_t NVS_WRITE_PER_ENTRY_US = 500;
+const size_t NVS_ENTRY_BYTES = 32;
+
+Nvs::Nvs(Simulation& simulation)
+  : simulation(simulation) {}
+
+void Nvs::open(const std::string& space) {
+  statistics.opens++;
+  simulation.elapse(NVS_OPEN_US, Phase::Nvs);
+}
+
+void Nvs::close() {
+  simulation.elapse(NVS_CLOSE_US, Phase::Nvs);
+}
+
+const Nvs::Entry* Nvs::get(const std::string& space, const std::string& key) {
+  statistics.reads++;
+  simulation.elapse(NVS_READ_US, Phase::Nvs);
+
+  auto spaceIt = spaces.find(space);
+  if (spaceIt == spaces.end()) {
+    return nullptr;
+  }
+  auto entryIt = spaceIt->second.find(key);
+  return entryIt == spaceIt->second.end() ? nullptr : &entryIt->second;
+}
+
+size_t Nvs::put(const std::string& space, const std::string& key, Type type, const void* value, size_t size) {
+  const uint8_t* bytes = static_cast<const uint8_t*>(value);
+  Entry entry{ type, std::vector<uint8_t>(bytes, bytes + size) };
+
+  auto& entries = spaces[space];
+  auto existing = entries.find(key);
+  if (existing != entries.end() && existing->second.type == type && existing->second.value == entry.value) {
+    statistics.skippedWrites++;
+    simulation.elapse(NVS_READ_US, Phase::Nvs);
+    return size;
+  }
+
+  size_t spanned = 1 + (type == Type::String || type == Type::Blob ? (size + NVS_ENTRY_BYTES - 1) / NVS_ENTRY_BYTES : 0);
+  statistics.writes++;
+  statistics.bytesWritten += spanned * NVS_ENTRY_BYTES;
+  simulation.elapse(NVS_WRITE_US + static_cast<int64_t>(spanned - 1) * NVS_WRITE_PER_ENTRY_US, Phase::Nvs);
+
+  entries[key] = std::move(entry);
+  return size;
+}
+
+bool Nvs::remove(const std::string& space, const std::string& key) {
+  statistics.writes++;
+  simulation.elapse(NVS_WRITE_US, Phase::Nvs);
+  auto spaceIt = spaces.find(space);
+  return spaceIt != spaces.end() && spaceIt->second.erase(key) > 0;
+}
+
+bool Nvs::clear(const std::string& space) {
+  statistics.writes++;
+  simulation.elapse(NVS_WRITE_US, Phase::Nvs);
+  spaces.erase(space);
+  return true;
+}
+
+bool Nvs::contains(const std::string& space, const std::string& key) const {
+  auto spaceIt = spaces.find(space);
+  return spaceIt != spaces.end() && spaceIt->second.count(key) > 0;
+}
+
+}
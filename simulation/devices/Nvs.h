@@ -0,0 +1,67 @@
+#ifndef SIM_NVS_H
+#define SIM_NVS_H
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+#include "Simulation.h"
+
+namespace sim {
+
+// The "nvs" flash partition behind Preferences. Survives deep sleep and power
+// loss. Every access costs flash time; setting a key to the value it already
+// holds is detected and skipped like ESP-IDF does.
+class Nvs {
+public:
+  enum class Type : uint8_t {
+    U8,
+    I8,
+    U16,
+    I16,
+    U32,
+    I32,
+    U64,
+    I64,
+    String,
+    Blob,
+  };
+
+  struct Entry {
+    Type type;
+    std::vector<uint8_t> value;
+  };
+
+  explicit Nvs(Simulation& simulation);
+
+  void open(const std::string& space);
+  void close();
+
+  // Returns nullptr when the key is missing
+  const Entry* get(const std::string& space, const std::string& key);
+  size_t put(const std::string& space, const std::string& key, Type type, const void* value, size_t size);
+  bool remove(const std::string& space, const std::string& key);
+  bool clear(const std::string& space);
+  bool contains(const std::string& space, const std::string& key) const;
+
+  struct Stats {
+    int opens = 0;
+    int reads = 0;
+    int writes = 0;
+    int skippedWrites = 0;
+    size_t bytesWritten = 0;
+  };
+
+  const Stats& stats() const {
+    return statistics;
+  }
+
+private:
+  Simulation& simulation;
+  std::map<std::string, std::map<std::string, Entry>> spaces;
+  Stats statistics;
+};
+
+}
+
+#endif
@@ -0,0 +1,228 @@
+#include "TelegramServer.h"
+#include <ArduinoJson.h>
+#include <cctype>
+#include <ctime>
+#include <map>
+
+namespace sim {
+
+const int64_t BOT_ID = 7000000001;
+const char* const BOT_NAME = "Pet Feeder";
+const char* const BOT_USERNAME = "pet_feeder_bot";
+const char* const GROUP_TITLE = "Pet feeder";
+const size_t MAX_MESSAGE_LENGTH = 4096;
+
+static std::string lowercase(std::string value) {
+  for (char& c : value) {
+    c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+  }
+  return value;
+}
+
+static size_t contentLength(const std::string& headers) {
+  size_t lineStart = headers.find("\r\n");
+  while (lineStart != std::string::npos && lineStart + 2 < headers.size()) {
+    size_t lineEnd = headers.find("\r\n", lineStart + 2);
+    std::string line = headers.substr(lineStart + 2, lineEnd == std::string::npos ? std::string::npos : lineEnd - lineStart - 2);
+    size_t colon = line.find(':');
+    if (colon != std::string::npos && lowercase(line.substr(0, colon)) == "content-length") {
+      return static_cast<size_t>(strtoul(line.c_str() + colon + 1, nullptr, 10));
+    }
+    lineStart = lineEnd;
+  }
+  return 0;
+}
+
+// JSON string with everything outside printable ASCII escaped, as the Bot API does
+static std::string jsonString(const std::string& utf8) {
+  std::string out = "\"";
+  char escape[13];
+
+  for (size_t i = 0; i < utf8.size();) {
+    unsigned char c = static_cast<unsigned char>(utf8[i]);
+    uint32_t codepoint = c;
+    size_t length = 1;
+
+    if (c >= 0xF0 && i + 3 < utf8.size()) {
+      codepoint = ((c & 0x07) << 18) | ((utf8[i + 1] & 0x3F) << 12) | ((utf8[i + 2] & 0x3F) << 6) | (utf8[i + 3] & 0x3F);
+      length = 4;
+    } else if (c >= 0xE0 && i + 2 < utf8.size()) {
+      codepoint = ((c & 0x0F) << 12) | ((utf8[i + 1] & 0x3F) << 6) | (utf8[i + 2] & 0x3F);
+      length = 3;
+    } else if (c >= 0xC0 && i + 1 < utf8.size()) {
+      codepoint = ((c & 0x1F) << 6) | (utf8[i + 1] & 0x3F);
+      length = 2;
+    }
+    i += length;
+
+    if (codepoint == '"' || codepoint == '\\' || codepoint == '/') {
+      out += '\\';
+      out += static_cast<char>(codepoint);
+    } else if (codepoint == '\n') {
+      out += "\\n";
+    } else if (codepoint >= 0x20 && codepoint < 0x7F) {
+      out += static_cast<char>(codepoint);
+    } else if (codepoint >= 0x10000) {
+      codepoint -= 0x10000;
+      snprintf(escape, sizeof(escape), "\\u%04x\\u%04x", 0xD800 + (codepoint >> 10), 0xDC00 + (codepoint & 0x3FF));
+      out += escape;
+    } else {
+      snprintf(escape, sizeof(escape), "\\u%04x", codepoint);
+      out += escape;
+    }
+  }
+
+  return out + "\"";
+}
+
+static std::string errorBody(int status, const std::string& description) {
+  return "{\"ok\":false,\"error_code\":" + std::to_string(status) + ",\"description\":" + jsonString(description) + "}";
+}
+
+TelegramServer::TelegramServer(Simulation& simulation)
+  : simulation(simulation) {}
+
+size_t TelegramServer::requestLength(const std::string& buffer) {
+  size_t headerEnd = buffer.find("\r\n\r\n");
+  if (headerEnd == std::string::npos) {
+    return 0;
+  }
+
+  size_t total = headerEnd + 4 + contentLength(buffer.substr(0, headerEnd + 2));
+  return buffer.size() >= total ? total : 0;
+}
+
+bool TelegramServer::handle(const std::string& request, std::string& response) {
+  statistics.requests++;
+  statistics.bytesReceived += request.size();
+
+  if (simulation.uniform() < simulation.config().telegramFailureRate) {
+    statistics.dropped++;
+    return false;
+  }
+
+  size_t lineEnd = request.find("\r\n");
+  std::string requestLine = request.substr(0, lineEnd);
+  size_t methodEnd = requestLine.find(' ');
+  size_t targetEnd = requestLine.find(' ', methodEnd + 1);
+  std::string httpMethod = requestLine.substr(0, methodEnd);
+  std::string target = requestLine.substr(methodEnd + 1, targetEnd - methodEnd - 1);
+
+  std::string query;
+  size_t queryStart = target.find('?');
+  if (queryStart != std::string::npos) {
+    query = target.substr(queryStart + 1);
+    target = target.substr(0, queryStart);
+  }
+
+  int status = 404;
+  std::string body = errorBody(404, "Not Found");
+
+  size_t tokenEnd = target.find('/', 1);
+  if (target.compare(0, 4, "/bot") == 0 && tokenEnd != std::string::npos) {
+    std::string token = target.substr(4, tokenEnd - 4);
+    std::string apiMethod = target.substr(tokenEnd + 1);
+
+    std::map<std::string, std::string> parameters;
+    if (httpMethod == "POST") {
+      JsonDocument payload;
+      size_t bodyStart = request.find("\r\n\r\n") + 4;
+      if (!deserializeJson(payload, request.c_str() + bodyStart, request.size() - bodyStart)) {
+        for (JsonPair pair : payload.as<JsonObject>()) {
+          JsonVariant value = pair.value();
+          if (value.is<const char*>()) {
+            parameters[pair.key().c_str()] = value.as<const char*>();
+          } else if (value.is<long long>()) {
+            parameters[pair.key().c_str()] = std::to_string(value.as<long long>());
+          }
+        }
+      }
+    } else {
+      size_t start = 0;
+      while (start < query.size()) {
+        size_t end = query.find('&', start);
+        std::string item = query.substr(start, end == std::string::npos ? std::string::npos : end - start);
+        size_t equals = item.find('=');
+        if (equals != std::string::npos) {
+          parameters[item.substr(0, equals)] = item.substr(equals + 1);
+        }
+        start = end == std::string::npos ? query.size() : end + 1;
+      }
+    }
+
+    if (token != simulation.config().botToken) {
+      status = 401;
+      body = errorBody(401, "Unauthorized");
+    } else if (apiMethod == "sendMessage") {
+      body = sendMessage(parameters["chat_id"], parameters["text"], status);
+    } else if (apiMethod == "getMe") {
+      status = 200;
+      body = "{\"ok\":true,\"result\":{\"id\":" + std::to_string(BOT_ID) + ",\"is_bot\":true,\"first_name\":" + jsonString(BOT_NAME)
+             + ",\"username\":" + jsonString(BOT_USERNAME) + ",\"can_join_groups\":true,\"can_read_all_group_messages\":false,\"supports_inline_queries\":false}}";
+    } else if (apiMethod == "getUpdates") {
+      status = 200;
+      body = "{\"ok\":true,\"result\":[]}";
+    }
+  }
+
+  if (status != 200) {
+    statistics.rejected++;
+  }
+
+  response = httpResponse(status, body);
+  statistics.bytesSent += response.size();
+  return true;
+}
+
+std::string TelegramServer::sendMessage(const std::string& chatId, const std::string& text, int& status) {
+  if (chatId != simulation.config().groupId) {
+    status = 400;
+    return errorBody(400, "Bad Request: chat not found");
+  }
+  if (text.empty()) {
+    status = 400;
+    return errorBody(400, "Bad Request: message text is empty");
+  }
+  size_t characters = 0;
+  for (char c : text) {
+    characters += (static_cast<unsigned char>(c) & 0xC0) != 0x80;
+  }
+  if (characters > MAX_MESSAGE_LENGTH) {
+    status = 400;
+    return errorBody(400, "Bad Request: message is too long");
+  }
+
+  status = 200;
+  delivered.push_back(Message{ simulation.trueUs(), text });
+
+  std::string chat = "{\"id\":" + chatId + ",\"title\":" + jsonString(GROUP_TITLE) + ",\"type\":\"supergroup\"}";
+  return "{\"ok\":true,\"result\":{\"message_id\":" + std::to_string(nextMessageId++)
+         + ",\"from\":{\"id\":" + std::to_string(BOT_ID) + ",\"is_bot\":true,\"first_name\":" + jsonString(BOT_NAME)
+         + ",\"username\":" + jsonString(BOT_USERNAME) + "},\"chat\":" + chat
+         + ",\"date\":" + std::to_string(simulation.trueUs() / US_PER_SECOND)
+         + ",\"text\":" + jsonString(text) + "}}";
+}
+
+std::string TelegramServer::httpResponse(int status, const std::string& body) const {
+  const char* reason = status == 200 ? "OK" : status == 400 ? "Bad Request" : status == 401 ? "Unauthorized" : "Not Found";
+
+  time_t now = static_cast<time_t>(simulation.trueUs() / US_PER_SECOND);
+  struct tm parts;
+  gmtime_r(&now, &parts);
+  char date[40];
+  strftime(date, sizeof(date), "%a, %d %b %Y %H:%M:%S GMT", &parts);
+
+  return "HTTP/1.1 " + std::to_string(status) + " " + reason + "\r\n"
+         + "Server: nginx/1.18.0\r\n"
+         + "Date: " + date + "\r\n"
+         + "Content-Type: application/json\r\n"
+         + "Content-Length: " + std::to_string(body.size()) + "\r\n"
+         + "Connection: keep-alive\r\n"
+         + "Strict-Transport-Security: max-age=31536000; includeSubDomains; preload\r\n"
+         + "Access-Control-Allow-Origin: *\r\n"
+         + "Access-Control-Expose-Headers: Content-Length,Content-Type,Date,Server,Connection\r\n"
+         + "\r\n"
+         + body;
+}
+
+}
@@ -0,0 +1,66 @@
+#ifndef SIM_TELEGRAM_SERVER_H
+#define SIM_TELEGRAM_SERVER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Simulation.h"
+
+namespace sim {
+
+const char* const TELEGRAM_API_HOST = "api.telegram.org";
+
+// Idle keep-alive connections are closed by the server after this long (assumed)
+const int64_t TELEGRAM_KEEP_ALIVE_US = 120 * US_PER_SECOND;
+
+// Bot API endpoint. Understands sendMessage (JSON POST or GET query), getMe and
+// getUpdates, checks the token and the chat, and answers the way
+// api.telegram.org does, including \uXXXX escaping of non-ASCII text.
+class TelegramServer {
+public:
+  explicit TelegramServer(Simulation& simulation);
+
+  // Length of the first complete HTTP request at the start of the buffer, or 0
+  static size_t requestLength(const std::string& buffer);
+
+  // Returns false when the request is lost and never answered
+  bool handle(const std::string& request, std::string& response);
+
+  struct Message {
+    int64_t trueUs;
+    std::string text;
+  };
+
+  const std::vector<Message>& messages() const {
+    return delivered;
+  }
+
+  struct Stats {
+    int connections = 0;
+    int fullHandshakes = 0;
+    int resumedHandshakes = 0;
+    int64_t handshakeUs = 0;
+    int requests = 0;
+    int rejected = 0;
+    int dropped = 0;
+    size_t bytesSent = 0;
+    size_t bytesReceived = 0;
+  };
+
+  Stats& stats() {
+    return statistics;
+  }
+
+private:
+  Simulation& simulation;
+  std::vector<Message> delivered;
+  int nextMessageId = 1;
+  Stats statistics;
+
+  std::string sendMessage(const std::string& chatId, const std::string& text, int& status);
+  std::string httpResponse(int status, const std::string& body) const;
+};
+
+}
+
+#endif
@@ -0,0 +1,138 @@
+// Runs the unmodified feeder firmware against the simulated board for a number
+// of virtual days and prints where the time and the battery went.
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <stdexcept>
+#include <string>
+#include "Board.h"
+#include "EnergyModel.h"
+#include "Log.h"
+#include "Report.h"
+
+void setup();
+void loop();
+
+// Where the firmware's log ring is decoded, like a host reading it off the device
+class StdoutPrint : public Print {
+public:
+  size_t write(uint8_t c) override {
+    return fputc(c, stdout) == EOF ? 0 : 1;
+  }
+  size_t write(const uint8_t* buffer, size_t size) override {
+    return fwrite(buffer, 1, size, stdout);
+  }
+};
+
+static void printUsage(const char* program) {
+  printf("Usage: %s [--option=value ...]\n\nOptions (default, meaning):\n", program);
+  sim::SimulationConfig::printOptions(stdout);
+}
+
+static bool parseArguments(int argc, char** argv, sim::SimulationConfig& config) {
+  for (int i = 1; i < argc; ++i) {
+    std::string argument = argv[i];
+    if (argument == "--help" || argument == "-h") {
+      printUsage(argv[0]);
+      exit(0);
+    }
+    if (argument.compare(0, 2, "--") != 0) {
+      fprintf(stderr, "Unexpected argument: %s\n", argv[i]);
+      return false;
+    }
+
+    size_t equals = argument.find('=');
+    std::string name = argument.substr(2, equals == std::string::npos ? std::string::npos : equals - 2);
+    std::string value = equals == std::string::npos ? "" : argument.substr(equals + 1);
+    if (!config.apply(name, value)) {
+      fprintf(stderr, "Bad option: %s\n", argv[i]);
+      return false;
+    }
+  }
+  return true;
+}
+
+static void printMessages(sim::Board& board) {
+  printf("\n=== Telegram messages ===\n");
+  for (const sim::TelegramServer::Message& message : board.telegram().messages()) {
+    time_t at = static_cast<time_t>(message.trueUs / sim::US_PER_SECOND);
+    char timestamp[32];
+    strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S", gmtime(&at));
+    printf("[%s] %s\n", timestamp, message.text.c_str());
+  }
+}
+
+// What the firmware believes about its battery, against what the meter measured
+static void printEnergyModel(sim::Board& board) {
+  printf("\n=== Firmware energy model ===\n%s\n", EnergyModel::summary().c_str());
+  printf("Metered: %.1f mAh used, %.1f%% left\n", board.simulation().meter().totalMah(), 100.0 * board.battery().stateOfCharge());
+}
+
+int main(int argc, char** argv) {
+  sim::SimulationConfig config;
+  if (!parseArguments(argc, argv, config)) {
+    printUsage(argv[0]);
+    return 2;
+  }
+
+  // The firmware keeps its clock in UTC
+  setenv("TZ", "UTC0", 1);
+  tzset();
+
+  try {
+    sim::Simulation simulation(config);
+    sim::Board board(simulation);
+    int64_t endUs = simulation.trueUs() + static_cast<int64_t>(config.days * sim::US_PER_DAY);
+
+    board.start();
+    simulation.powerOn();
+
+    bool running = true;
+    while (running) {
+      simulation.boot();
+      bool brownout = false;
+      try {
+        setup();
+        for (;;) {
+          loop();
+        }
+      } catch (const sim::DeepSleep&) {
+      } catch (const sim::Brownout&) {
+        brownout = true;
+      }
+      if (config.verbose) {
+        StdoutPrint out;
+        Log::dump(out);
+      }
+
+      if (brownout) {
+        if (config.verbose) {
+          printf("Brownout reset\n");
+        }
+        simulation.reset();
+        running = simulation.trueUs() < endUs && board.battery().stateOfCharge() > 0;
+      } else {
+        running = simulation.deepSleep(endUs) && board.battery().stateOfCharge() > 0;
+      }
+    }
+
+    if (board.battery().stateOfCharge() <= 0) {
+      printf("\nBattery depleted.\n");
+    }
+    sim::Report::print(board, stdout);
+    printEnergyModel(board);
+    if (config.showMessages) {
+      printMessages(board);
+    }
+    if (!config.csv.empty() && !sim::Report::writeCsv(board, config.csv.c_str())) {
+      fprintf(stderr, "Cannot write %s\n", config.csv.c_str());
+      return 1;
+    }
+  } catch (const std::exception& e) {
+    fprintf(stderr, "Simulation aborted: %s\n", e.what());
+    return 1;
+  }
+  return 0;
+}